@@ -0,0 +1,474 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Artwork.h"
+#include "ArtworkPrivate.h"
+
+#include <gst/pbutils/pbutils.h>
+#include <gst/video/video.h>
+
+GST_DEBUG_CATEGORY_STATIC (artwork_debug);
+#define GST_CAT_DEFAULT artwork_debug
+
+#define DEFAULT_MAX_BYTES (32 * 1024 * 1024)
+/* Reading the tags again and decoding a single image */
+#define ARTWORK_DISCOVER_TIMEOUT (10 * GST_SECOND)
+#define ARTWORK_CONVERT_TIMEOUT (5 * GST_SECOND)
+
+G_DEFINE_BOXED_TYPE (PlayerArtwork, player_artwork, player_artwork_copy, player_artwork_free);
+
+/*
+ * Encoded images are keyed by their hash, so the same cover embedded in
+ * every track of an album is held once. Downscaled variants are keyed by
+ * hash and bounds and share the same LRU list and budget.
+ */
+typedef struct {
+    gchar *key;
+    GstSample *sample;
+    gsize size;
+    GList *link;
+} ArtworkCacheEntry;
+
+typedef struct {
+    GMutex lock;
+    guint64 max_bytes;
+    guint64 cached_bytes;
+    GHashTable *entries;   /* key -> ArtworkCacheEntry */
+    GQueue lru;            /* ArtworkCacheEntry, least recently used first */
+
+    guint64 hits;
+    guint64 misses;
+    guint64 n_evictions;
+} ArtworkCache;
+
+static void cache_entry_free(ArtworkCacheEntry *entry) {
+    gst_sample_unref(entry->sample);
+    g_free(entry->key);
+    g_free(entry);
+}
+
+static ArtworkCache *artwork_cache_get(void) {
+    static gsize initialized = 0;
+    static ArtworkCache cache;
+
+    if (g_once_init_enter (&initialized)) {
+        GST_DEBUG_CATEGORY_INIT (artwork_debug, "player-artwork", 0, "Player artwork");
+        g_mutex_init(&cache.lock);
+        cache.max_bytes = DEFAULT_MAX_BYTES;
+        cache.entries = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                              (GDestroyNotify) cache_entry_free);
+        g_queue_init(&cache.lru);
+        g_once_init_leave (&initialized, 1);
+    }
+
+    return &cache;
+}
+
+static gsize sample_size(GstSample *sample) {
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+
+    return buffer ? gst_buffer_get_size(buffer) : 0;
+}
+
+/* Must be called with lock */
+static void enforce_budget(ArtworkCache *cache) {
+    while (cache->cached_bytes > cache->max_bytes && cache->lru.head) {
+        ArtworkCacheEntry *entry = g_queue_pop_head(&cache->lru);
+
+        GST_LOG ("Evicting %s (%" G_GSIZE_FORMAT " bytes)", entry->key, entry->size);
+        cache->cached_bytes -= entry->size;
+        cache->n_evictions++;
+        g_hash_table_remove(cache->entries, entry->key);
+    }
+}
+
+/* Returns a reference to the cached sample for @key, counting a hit or a
+ * miss if @count is set */
+static GstSample *cache_lookup(const gchar *key, gboolean count) {
+    ArtworkCache *cache = artwork_cache_get();
+    ArtworkCacheEntry *entry;
+    GstSample *sample = NULL;
+
+    g_mutex_lock(&cache->lock);
+    entry = g_hash_table_lookup(cache->entries, key);
+    if (entry) {
+        g_queue_unlink(&cache->lru, entry->link);
+        g_queue_push_tail_link(&cache->lru, entry->link);
+        sample = gst_sample_ref(entry->sample);
+    }
+    if (count) {
+        if (entry)
+            cache->hits++;
+        else
+            cache->misses++;
+    }
+    g_mutex_unlock(&cache->lock);
+
+    return sample;
+}
+
+static void cache_insert(const gchar *key, GstSample *sample) {
+    ArtworkCache *cache = artwork_cache_get();
+    ArtworkCacheEntry *entry;
+    gsize size = sample_size(sample);
+
+    g_mutex_lock(&cache->lock);
+    entry = g_hash_table_lookup(cache->entries, key);
+    if (entry) {
+        g_queue_unlink(&cache->lru, entry->link);
+        g_queue_push_tail_link(&cache->lru, entry->link);
+    } else if (size <= cache->max_bytes) {
+        entry = g_new (ArtworkCacheEntry, 1);
+        entry->key = g_strdup(key);
+        entry->sample = gst_sample_ref(sample);
+        entry->size = size;
+        g_queue_push_tail(&cache->lru, entry);
+        entry->link = cache->lru.tail;
+        g_hash_table_insert(cache->entries, entry->key, entry);
+        cache->cached_bytes += size;
+        enforce_budget(cache);
+    }
+    g_mutex_unlock(&cache->lock);
+}
+
+/**
+ * player_artwork_cache_configure:
+ * @max_bytes: budget for all cached images together
+ *
+ * Configures the process-wide cache of images loaded with
+ * player_artwork_load(). Images beyond the budget are evicted least
+ * recently used first.
+ */
+void player_artwork_cache_configure(guint64 max_bytes) {
+    ArtworkCache *cache = artwork_cache_get();
+
+    g_mutex_lock(&cache->lock);
+    cache->max_bytes = max_bytes;
+    enforce_budget(cache);
+    g_mutex_unlock(&cache->lock);
+}
+
+/**
+ * player_artwork_cache_get_stats:
+ * @stats: (out caller-allocates): return location for the statistics
+ */
+void player_artwork_cache_get_stats(PlayerArtworkCacheStats *stats) {
+    ArtworkCache *cache = artwork_cache_get();
+
+    g_return_if_fail (stats != NULL);
+
+    g_mutex_lock(&cache->lock);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->cached_bytes = cache->cached_bytes;
+    stats->max_bytes = cache->max_bytes;
+    stats->n_entries = g_hash_table_size(cache->entries);
+    stats->n_evictions = cache->n_evictions;
+    g_mutex_unlock(&cache->lock);
+}
+
+static gchar *sample_hash(GstSample *sample) {
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    GstMapInfo map;
+    gchar *hash;
+
+    if (!buffer || !gst_buffer_map(buffer, &map, GST_MAP_READ))
+        return NULL;
+    hash = g_compute_checksum_for_data(G_CHECKSUM_SHA1, map.data, map.size);
+    gst_buffer_unmap(buffer, &map);
+
+    return hash;
+}
+
+/* Describes the image in @sample, embedded in the media at @uri. The
+ * encoded image goes to the artwork cache, so loading it right away does
+ * not need to read the media again. */
+PlayerArtwork *player_artwork_new(const gchar *uri, GstSample *sample) {
+    PlayerArtwork *artwork;
+    const GstStructure *info;
+    GstCaps *caps;
+    gchar *hash;
+    gint image_type;
+
+    g_return_val_if_fail (sample != NULL, NULL);
+
+    hash = sample_hash(sample);
+    if (!hash)
+        return NULL;
+
+    artwork = g_new0 (PlayerArtwork, 1);
+    artwork->uri = g_strdup(uri);
+    artwork->hash = hash;
+    artwork->size = sample_size(sample);
+
+    caps = gst_sample_get_caps(sample);
+    if (caps && gst_caps_get_size(caps) > 0)
+        artwork->mime_type = g_strdup(gst_structure_get_name(gst_caps_get_structure(caps, 0)));
+    else
+        artwork->mime_type = g_strdup("application/octet-stream");
+
+    artwork->image_type = GST_TAG_IMAGE_TYPE_NONE;
+    info = gst_sample_get_info(sample);
+    if (info && gst_structure_get_enum(info, "image-type", GST_TYPE_TAG_IMAGE_TYPE, &image_type))
+        artwork->image_type = image_type;
+
+    cache_insert(artwork->hash, sample);
+
+    return artwork;
+}
+
+gboolean player_artwork_equal(const PlayerArtwork *a, const PlayerArtwork *b) {
+    if (a == b)
+        return TRUE;
+    if (!a || !b)
+        return FALSE;
+
+    return g_str_equal(a->hash, b->hash) && g_strcmp0(a->uri, b->uri) == 0;
+}
+
+PlayerArtwork *player_artwork_copy(const PlayerArtwork *artwork) {
+    PlayerArtwork *ret;
+
+    g_return_val_if_fail (artwork != NULL, NULL);
+
+    ret = g_new (PlayerArtwork, 1);
+    *ret = *artwork;
+    ret->uri = g_strdup(artwork->uri);
+    ret->hash = g_strdup(artwork->hash);
+    ret->mime_type = g_strdup(artwork->mime_type);
+
+    return ret;
+}
+
+void player_artwork_free(PlayerArtwork *artwork) {
+    g_return_if_fail (artwork != NULL);
+
+    g_free(artwork->uri);
+    g_free(artwork->hash);
+    g_free(artwork->mime_type);
+    g_free(artwork);
+}
+
+/**
+ * player_artwork_get_mime_type:
+ * @artwork: a #PlayerArtwork
+ *
+ * Returns: the media type of the encoded image, e.g. "image/jpeg"
+ */
+const gchar *player_artwork_get_mime_type(const PlayerArtwork *artwork) {
+    g_return_val_if_fail (artwork != NULL, NULL);
+
+    return artwork->mime_type;
+}
+
+/**
+ * player_artwork_get_size:
+ * @artwork: a #PlayerArtwork
+ *
+ * Returns: the size of the encoded image in bytes
+ */
+gsize player_artwork_get_size(const PlayerArtwork *artwork) {
+    g_return_val_if_fail (artwork != NULL, 0);
+
+    return artwork->size;
+}
+
+/**
+ * player_artwork_get_hash:
+ * @artwork: a #PlayerArtwork
+ *
+ * Returns: the SHA-1 of the encoded image as a hex string. Identical
+ * images embedded in different media have the same hash.
+ */
+const gchar *player_artwork_get_hash(const PlayerArtwork *artwork) {
+    g_return_val_if_fail (artwork != NULL, NULL);
+
+    return artwork->hash;
+}
+
+/**
+ * player_artwork_get_image_type:
+ * @artwork: a #PlayerArtwork
+ *
+ * Returns: what the image shows, as declared by the media
+ */
+GstTagImageType player_artwork_get_image_type(const PlayerArtwork *artwork) {
+    g_return_val_if_fail (artwork != NULL, GST_TAG_IMAGE_TYPE_NONE);
+
+    return artwork->image_type;
+}
+
+static GstSample *find_in_tags(const GstTagList *tags, const gchar *hash) {
+    static const gchar *const tag_names[] = {GST_TAG_IMAGE, GST_TAG_PREVIEW_IMAGE};
+    guint i, j, n;
+
+    if (!tags)
+        return NULL;
+
+    for (i = 0; i < G_N_ELEMENTS (tag_names); i++) {
+        n = gst_tag_list_get_tag_size(tags, tag_names[i]);
+        for (j = 0; j < n; j++) {
+            GstSample *sample = NULL;
+            gchar *sample_digest;
+            gboolean match;
+
+            if (!gst_tag_list_get_sample_index(tags, tag_names[i], j, &sample))
+                continue;
+            sample_digest = sample_hash(sample);
+            match = g_strcmp0(sample_digest, hash) == 0;
+            g_free(sample_digest);
+            if (match)
+                return sample;
+            gst_sample_unref(sample);
+        }
+    }
+
+    return NULL;
+}
+
+/* Reads the tags of the media again to get the encoded image back */
+static GstSample *artwork_read(const PlayerArtwork *artwork, GError **error) {
+    GstDiscoverer *discoverer;
+    GstDiscovererInfo *info;
+    GstSample *sample = NULL;
+    GError *err = NULL;
+
+    if (!artwork->uri) {
+        g_set_error(error, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_NOT_FOUND,
+                    "Artwork %s is no longer cached and has no media to read it from",
+                    artwork->hash);
+        return NULL;
+    }
+
+    GST_DEBUG ("Reading artwork %s from %s", artwork->hash, artwork->uri);
+
+    discoverer = gst_discoverer_new(ARTWORK_DISCOVER_TIMEOUT, error);
+    if (!discoverer)
+        return NULL;
+
+    info = gst_discoverer_discover_uri(discoverer, artwork->uri, &err);
+    if (info) {
+        sample = find_in_tags(gst_discoverer_info_get_tags(info), artwork->hash);
+        if (!sample) {
+            GList *streams = gst_discoverer_info_get_stream_list(info);
+            GList *l;
+
+            for (l = streams; l && !sample; l = l->next)
+                sample = find_in_tags(gst_discoverer_stream_info_get_tags(l->data),
+                                      artwork->hash);
+            gst_discoverer_stream_info_list_free(streams);
+        }
+        g_object_unref(info);
+    }
+    g_object_unref(discoverer);
+
+    if (sample) {
+        g_clear_error(&err);
+    } else if (err) {
+        g_propagate_error(error, err);
+    } else {
+        g_set_error(error, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_NOT_FOUND,
+                    "Artwork %s not found in %s", artwork->hash, artwork->uri);
+    }
+
+    return sample;
+}
+
+/* Decodes @encoded and scales it down to fit within the bounds, keeping
+ * its aspect ratio. A bound of 0 leaves that dimension unconstrained. */
+static GstSample *artwork_scale(GstSample *encoded, guint max_width, guint max_height,
+                                GError **error) {
+    GstSample *raw, *scaled;
+    GstVideoInfo info;
+    GstCaps *caps;
+    gdouble scale = 1.0;
+
+    /* Decoded at its own size first, the target size depends on it */
+    caps = gst_caps_new_simple("video/x-raw", "format", G_TYPE_STRING, "RGBA", NULL);
+    raw = gst_video_convert_sample(encoded, caps, ARTWORK_CONVERT_TIMEOUT, error);
+    gst_caps_unref(caps);
+    if (!raw)
+        return NULL;
+
+    if (!gst_video_info_from_caps(&info, gst_sample_get_caps(raw))) {
+        g_set_error(error, GST_STREAM_ERROR, GST_STREAM_ERROR_DECODE,
+                    "Cannot decode artwork");
+        gst_sample_unref(raw);
+        return NULL;
+    }
+
+    if (max_width > 0 && (guint) GST_VIDEO_INFO_WIDTH (&info) > max_width)
+        scale = (gdouble) max_width / GST_VIDEO_INFO_WIDTH (&info);
+    if (max_height > 0 && GST_VIDEO_INFO_HEIGHT (&info) * scale > max_height)
+        scale = (gdouble) max_height / GST_VIDEO_INFO_HEIGHT (&info);
+    if (scale >= 1.0)
+        return raw;
+
+    caps = gst_caps_new_simple("video/x-raw",
+                               "format", G_TYPE_STRING, "RGBA",
+                               "width", G_TYPE_INT, MAX (1, (gint) (GST_VIDEO_INFO_WIDTH (&info) * scale + 0.5)),
+                               "height", G_TYPE_INT, MAX (1, (gint) (GST_VIDEO_INFO_HEIGHT (&info) * scale + 0.5)),
+                               "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1,
+                               NULL);
+    scaled = gst_video_convert_sample(raw, caps, ARTWORK_CONVERT_TIMEOUT, error);
+    gst_caps_unref(caps);
+    gst_sample_unref(raw);
+
+    return scaled;
+}
+
+/**
+ * player_artwork_load:
+ * @artwork: a #PlayerArtwork
+ * @max_width: maximum width of the returned image, 0 for no limit
+ * @max_height: maximum height of the returned image, 0 for no limit
+ * @error: return location for a #GError, or %NULL
+ *
+ * Loads the image described by @artwork. With both bounds 0 the encoded
+ * image is returned as embedded in the media. Otherwise it is decoded to
+ * RGBA and scaled down to fit within the bounds, keeping its aspect ratio.
+ *
+ * Results are kept in a process-wide cache shared by all players. On a
+ * miss the media is read again, so this may block; call it from a worker
+ * thread for remote media.
+ *
+ * Returns: (transfer full) (nullable): the image, or %NULL on error
+ */
+GstSample *player_artwork_load(const PlayerArtwork *artwork, guint max_width,
+                               guint max_height, GError **error) {
+    GstSample *encoded, *sample;
+    gboolean scaled = max_width > 0 || max_height > 0;
+    gchar *key;
+
+    g_return_val_if_fail (artwork != NULL, NULL);
+    g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+    key = scaled ? g_strdup_printf("%s@%ux%u", artwork->hash, max_width, max_height)
+                 : g_strdup(artwork->hash);
+    sample = cache_lookup(key, TRUE);
+    if (sample)
+        goto done;
+
+    encoded = scaled ? cache_lookup(artwork->hash, FALSE) : NULL;
+    if (!encoded) {
+        encoded = artwork_read(artwork, error);
+        if (!encoded)
+            goto done;
+        cache_insert(artwork->hash, encoded);
+    }
+
+    if (scaled) {
+        sample = artwork_scale(encoded, max_width, max_height, error);
+        if (sample)
+            cache_insert(key, sample);
+        gst_sample_unref(encoded);
+    } else {
+        sample = encoded;
+    }
+
+done:
+    g_free(key);
+
+    return sample;
+}
@@ -0,0 +1,74 @@
+#ifndef __PLAYER_ARTWORK_H__
+#define __PLAYER_ARTWORK_H__
+
+#include <gst/gst.h>
+#include <gst/tag/tag.h>
+#include "PlayerPrelude.h"
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_PLAYER_ARTWORK (player_artwork_get_type ())
+
+/**
+ * PlayerArtwork:
+ *
+ * Descriptor of an image embedded in the tags of a media, such as its
+ * cover art. It only carries the image metadata; the image itself is
+ * loaded on demand with player_artwork_load().
+ */
+typedef struct _PlayerArtwork PlayerArtwork;
+
+/**
+ * PlayerArtworkCacheStats:
+ * @hits: loads served from the cache
+ * @misses: loads that had to read and decode the media
+ * @cached_bytes: bytes of images currently held in the cache
+ * @max_bytes: cache budget in bytes
+ * @n_entries: images currently held in the cache
+ * @n_evictions: images evicted to stay within the budget
+ *
+ * Statistics of the process-wide artwork cache.
+ */
+typedef struct {
+    guint64 hits;
+    guint64 misses;
+    guint64 cached_bytes;
+    guint64 max_bytes;
+    guint n_entries;
+    guint64 n_evictions;
+} PlayerArtworkCacheStats;
+
+GST_PLAYER_API
+GType           player_artwork_get_type (void);
+
+GST_PLAYER_API
+PlayerArtwork * player_artwork_copy (const PlayerArtwork *artwork);
+
+GST_PLAYER_API
+void            player_artwork_free (PlayerArtwork *artwork);
+
+GST_PLAYER_API
+const gchar *   player_artwork_get_mime_type (const PlayerArtwork *artwork);
+
+GST_PLAYER_API
+gsize           player_artwork_get_size (const PlayerArtwork *artwork);
+
+GST_PLAYER_API
+const gchar *   player_artwork_get_hash (const PlayerArtwork *artwork);
+
+GST_PLAYER_API
+GstTagImageType player_artwork_get_image_type (const PlayerArtwork *artwork);
+
+GST_PLAYER_API
+GstSample *     player_artwork_load (const PlayerArtwork *artwork, guint max_width,
+                                     guint max_height, GError **error);
+
+GST_PLAYER_API
+void            player_artwork_cache_configure (guint64 max_bytes);
+
+GST_PLAYER_API
+void            player_artwork_cache_get_stats (PlayerArtworkCacheStats *stats);
+
+G_END_DECLS
+
+#endif /* __PLAYER_ARTWORK_H__ */
@@ -0,0 +1,18 @@
+#include "Artwork.h"
+
+#ifndef __PLAYER_ARTWORK_PRIVATE_H__
+#define __PLAYER_ARTWORK_PRIVATE_H__
+
+struct _PlayerArtwork
+{
+  gchar *uri;         /* Media the image is embedded in */
+  gchar *hash;        /* SHA-1 of the encoded image */
+  gchar *mime_type;
+  gsize size;
+  GstTagImageType image_type;
+};
+
+G_GNUC_INTERNAL PlayerArtwork*  player_artwork_new(const gchar *uri, GstSample *sample);
+G_GNUC_INTERNAL gboolean        player_artwork_equal(const PlayerArtwork *a, const PlayerArtwork *b);
+
+#endif /* __PLAYER_ARTWORK_PRIVATE_H__ */
@@ -0,0 +1,99 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "BufferingPolicy.h"
+
+/* queue2 limits playbin uses when buffer-size is not set */
+#define DEFAULT_QUEUE2_MAX_SIZE_BYTES (2 * 1024 * 1024)
+
+void buffering_policy_init(BufferingPolicy *policy, gint low_percent,
+                           gint high_percent, gint64 buffer_size) {
+    policy->high_percent = CLAMP (high_percent, 1, 100);
+    policy->low_percent = CLAMP (low_percent, 0, policy->high_percent);
+    policy->buffer_size = buffer_size > 0 ? buffer_size : DEFAULT_QUEUE2_MAX_SIZE_BYTES;
+
+    buffering_policy_reset(policy);
+}
+
+void buffering_policy_reset(BufferingPolicy *policy) {
+    policy->primed = FALSE;
+    policy->holding = FALSE;
+    policy->percent = 100;
+    policy->mode = GST_BUFFERING_STREAM;
+    policy->avg_in = -1;
+    policy->avg_out = -1;
+    policy->buffering_left = -1;
+    policy->refill_time = GST_CLOCK_TIME_NONE;
+    policy->n_messages = 0;
+    policy->n_stalls = 0;
+    policy->stall_start = GST_CLOCK_TIME_NONE;
+    policy->stall_time = 0;
+}
+
+/* Time until high_percent is reached at the measured input rate, falling
+ * back to queue2's own estimate of the time until it is full */
+static GstClockTime estimate_refill_time(BufferingPolicy *policy) {
+    gint64 missing;
+
+    if (policy->percent >= policy->high_percent)
+        return 0;
+
+    if (policy->avg_in > 0) {
+        missing = policy->buffer_size * (policy->high_percent - policy->percent) / 100;
+        return gst_util_uint64_scale(missing, GST_SECOND, policy->avg_in);
+    }
+
+    if (policy->buffering_left >= 0)
+        return policy->buffering_left * GST_MSECOND;
+
+    return GST_CLOCK_TIME_NONE;
+}
+
+/* Feeds a buffering message into @policy and returns what the player
+ * should do about it */
+BufferingAction buffering_policy_update(BufferingPolicy *policy, GstMessage *msg) {
+    gst_message_parse_buffering(msg, &policy->percent);
+    gst_message_parse_buffering_stats(msg, &policy->mode, &policy->avg_in,
+                                      &policy->avg_out, &policy->buffering_left);
+    policy->refill_time = estimate_refill_time(policy);
+    policy->n_messages++;
+
+    /* Sources that buffer at all start out held until the first high
+     * watermark, everything else never posts buffering messages */
+    if (!policy->primed) {
+        policy->primed = TRUE;
+        if (policy->percent < policy->high_percent) {
+            policy->holding = TRUE;
+            return BUFFERING_ACTION_PAUSE;
+        }
+    }
+
+    if (policy->holding) {
+        if (policy->percent < policy->high_percent)
+            return BUFFERING_ACTION_NONE;
+
+        policy->holding = FALSE;
+        if (GST_CLOCK_TIME_IS_VALID (policy->stall_start)) {
+            policy->stall_time += gst_util_get_timestamp() - policy->stall_start;
+            policy->stall_start = GST_CLOCK_TIME_NONE;
+        }
+        return BUFFERING_ACTION_RESUME;
+    }
+
+    if (policy->percent >= policy->low_percent || policy->percent >= 100)
+        return BUFFERING_ACTION_NONE;
+
+    policy->holding = TRUE;
+    policy->n_stalls++;
+    policy->stall_start = gst_util_get_timestamp();
+    return BUFFERING_ACTION_PAUSE;
+}
+
+/* Total rebuffering time including a stall that is still ongoing */
+GstClockTime buffering_policy_get_stall_time(const BufferingPolicy *policy) {
+    if (GST_CLOCK_TIME_IS_VALID (policy->stall_start))
+        return policy->stall_time + (gst_util_get_timestamp() - policy->stall_start);
+
+    return policy->stall_time;
+}
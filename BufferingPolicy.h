@@ -0,0 +1,51 @@
+#ifndef __PLAYER_BUFFERING_POLICY_H__
+#define __PLAYER_BUFFERING_POLICY_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+    BUFFERING_ACTION_NONE,
+    BUFFERING_ACTION_PAUSE,
+    BUFFERING_ACTION_RESUME
+} BufferingAction;
+
+/*
+ * Watermark based buffering decisions: playback is held once the fill
+ * level drops below low_percent and released once it reaches
+ * high_percent, so a level hovering around a single threshold does not
+ * toggle between BUFFERING and PLAYING.
+ */
+typedef struct {
+    /* Configuration */
+    gint low_percent;
+    gint high_percent;
+    gint64 buffer_size;
+
+    /* State */
+    gboolean primed;
+    gboolean holding;
+    gint percent;
+    GstBufferingMode mode;
+    gint avg_in;
+    gint avg_out;
+    gint64 buffering_left;
+    GstClockTime refill_time;
+
+    /* Statistics */
+    guint n_messages;
+    guint n_stalls;
+    GstClockTime stall_start;
+    GstClockTime stall_time;
+} BufferingPolicy;
+
+G_GNUC_INTERNAL void            buffering_policy_init(BufferingPolicy *policy, gint low_percent,
+                                                      gint high_percent, gint64 buffer_size);
+G_GNUC_INTERNAL void            buffering_policy_reset(BufferingPolicy *policy);
+G_GNUC_INTERNAL BufferingAction buffering_policy_update(BufferingPolicy *policy, GstMessage *msg);
+G_GNUC_INTERNAL GstClockTime    buffering_policy_get_stall_time(const BufferingPolicy *policy);
+
+G_END_DECLS
+
+#endif /* __PLAYER_BUFFERING_POLICY_H__ */
@@ -0,0 +1,651 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "CacheSrc.h"
+#include "HttpCachePrivate.h"
+#include "HttpClient.h"
+
+#include <gst/base/gstbasesrc.h>
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (cache_src_debug);
+#define GST_CAT_DEFAULT cache_src_debug
+
+#define DEFAULT_BLOCKSIZE (64 * 1024)
+#define DEFAULT_PREFETCH_BLOCKS 4
+#define MAX_PREFETCH_THREADS 4
+
+typedef struct _PlayerCacheSrc PlayerCacheSrc;
+typedef struct _PlayerCacheSrcClass PlayerCacheSrcClass;
+
+#define PLAYER_CACHE_SRC(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_PLAYER_CACHE_SRC, PlayerCacheSrc))
+
+/*
+ * Fetches blocks of one resource into the cache, shared between the
+ * streaming thread and the prefetch tasks. Blocks being fetched are
+ * tracked so a block is never requested twice at the same time.
+ */
+typedef struct {
+    gint ref_count;
+    HttpClient *client;
+
+    /* Set once the first block arrived, constant afterwards */
+    HttpCacheEntry *entry;
+    gchar *uri;             /* Final URI after redirects */
+    guint64 size;
+
+    GMutex lock;
+    GCond cond;
+    GCancellable *cancellable;
+    GHashTable *pending;    /* Block numbers being fetched */
+} Fetcher;
+
+typedef struct {
+    Fetcher *fetcher;
+    guint block;
+    GCancellable *cancellable;  /* Of the generation that claimed the block */
+} PrefetchTask;
+
+/*
+ * Random access source for HTTP resources that reads through the
+ * process-wide block cache. Blocks missing from the cache are fetched
+ * with range requests, so seeks only download the blocks they touch and
+ * replays are served from disk. The blocks following the read position
+ * are prefetched in parallel over the keep-alive connections of the
+ * shared HTTP client.
+ */
+struct _PlayerCacheSrc {
+    GstBaseSrc parent;
+
+    gchar *location;        /* http(s) URI, protected by object lock */
+    gchar *user_agent;      /* protected by object lock */
+    guint prefetch_blocks;  /* protected by object lock */
+
+    Fetcher *fetcher;       /* protected by object lock */
+};
+
+struct _PlayerCacheSrcClass {
+    GstBaseSrcClass parent_class;
+};
+
+enum {
+    PROP_0,
+    PROP_LOCATION,
+    PROP_USER_AGENT,
+    PROP_PREFETCH_BLOCKS
+};
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+        GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+static void player_cache_src_uri_handler_init(gpointer g_iface, gpointer iface_data);
+
+#define player_cache_src_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (PlayerCacheSrc, player_cache_src, GST_TYPE_BASE_SRC,
+                         G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER,
+                                                player_cache_src_uri_handler_init));
+
+static Fetcher *fetcher_new(const gchar *user_agent) {
+    Fetcher *fetcher = g_new0 (Fetcher, 1);
+
+    fetcher->ref_count = 1;
+    fetcher->client = http_client_get_shared(user_agent);
+    g_mutex_init(&fetcher->lock);
+    g_cond_init(&fetcher->cond);
+    fetcher->cancellable = g_cancellable_new();
+    fetcher->pending = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    return fetcher;
+}
+
+static Fetcher *fetcher_ref(Fetcher *fetcher) {
+    g_atomic_int_inc(&fetcher->ref_count);
+
+    return fetcher;
+}
+
+static void fetcher_unref(Fetcher *fetcher) {
+    if (!g_atomic_int_dec_and_test(&fetcher->ref_count))
+        return;
+
+    g_hash_table_unref(fetcher->pending);
+    g_object_unref(fetcher->cancellable);
+    g_cond_clear(&fetcher->cond);
+    g_mutex_clear(&fetcher->lock);
+    if (fetcher->entry)
+        http_cache_entry_unref(fetcher->entry);
+    http_client_unref(fetcher->client);
+    g_free(fetcher->uri);
+    g_free(fetcher);
+}
+
+static GCancellable *fetcher_get_cancellable(Fetcher *fetcher) {
+    GCancellable *cancellable;
+
+    g_mutex_lock(&fetcher->lock);
+    cancellable = g_object_ref(fetcher->cancellable);
+    g_mutex_unlock(&fetcher->lock);
+
+    return cancellable;
+}
+
+/* Interrupts all requests and wakes up waiters */
+static void fetcher_cancel(Fetcher *fetcher) {
+    g_mutex_lock(&fetcher->lock);
+    g_cancellable_cancel(fetcher->cancellable);
+    g_cond_broadcast(&fetcher->cond);
+    g_mutex_unlock(&fetcher->lock);
+}
+
+/* Replaces the cancellable rather than resetting it, prefetch tasks of
+ * the cancelled generation may still be using the old one */
+static void fetcher_uncancel(Fetcher *fetcher) {
+    g_mutex_lock(&fetcher->lock);
+    if (g_cancellable_is_cancelled(fetcher->cancellable)) {
+        g_object_unref(fetcher->cancellable);
+        fetcher->cancellable = g_cancellable_new();
+    }
+    g_mutex_unlock(&fetcher->lock);
+}
+
+/* Fetches the first block, which tells the final URI and the resource
+ * size, and opens the cache entry */
+static gboolean fetcher_open(Fetcher *fetcher, const gchar *uri, GError **error) {
+    GCancellable *cancellable = fetcher_get_cancellable(fetcher);
+    HttpResponse *response;
+    gsize len;
+
+    response = http_client_get_range(fetcher->client, uri, 0, HTTP_CACHE_BLOCK_SIZE,
+                                     cancellable, error);
+    g_object_unref(cancellable);
+    if (!response)
+        return FALSE;
+
+    /* A server ignoring Range would send everything before each block
+     * again for every fetch. Failing here makes the player fall back to
+     * the regular HTTP source. */
+    if (response->status != 206) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                    "Server does not support range requests for %s", uri);
+        http_response_free(response);
+        return FALSE;
+    }
+
+    if (response->total_size == G_MAXUINT64 || response->total_size == 0) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                    "Server does not report the size of %s", uri);
+        http_response_free(response);
+        return FALSE;
+    }
+
+    len = g_bytes_get_size(response->body);
+    if (response->offset != 0 || len != MIN ((guint64) HTTP_CACHE_BLOCK_SIZE, response->total_size)) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Short range response for %s", uri);
+        http_response_free(response);
+        return FALSE;
+    }
+
+    /* Cached by the requested URI, later range requests go straight to
+     * the redirect target */
+    fetcher->entry = http_cache_entry_open(uri, response->total_size, error);
+    if (!fetcher->entry) {
+        http_response_free(response);
+        return FALSE;
+    }
+    fetcher->uri = g_strdup(response->final_uri);
+    fetcher->size = response->total_size;
+    http_cache_entry_store(fetcher->entry, 0, g_bytes_get_data(response->body, NULL), len);
+
+    if (g_strcmp0(uri, fetcher->uri) != 0)
+        GST_DEBUG ("%s redirected to %s", uri, fetcher->uri);
+    http_response_free(response);
+
+    return TRUE;
+}
+
+/* Waits until @block is not being fetched. Returns FALSE if cancelled. */
+static gboolean fetcher_wait(Fetcher *fetcher, guint block) {
+    gboolean ret;
+
+    g_mutex_lock(&fetcher->lock);
+    while (g_hash_table_contains(fetcher->pending, GUINT_TO_POINTER (block))
+           && !g_cancellable_is_cancelled(fetcher->cancellable))
+        g_cond_wait(&fetcher->cond, &fetcher->lock);
+    ret = !g_cancellable_is_cancelled(fetcher->cancellable);
+    g_mutex_unlock(&fetcher->lock);
+
+    return ret;
+}
+
+/* Claims @block unless it is cached or already being fetched */
+static gboolean fetcher_claim(Fetcher *fetcher, guint block) {
+    gboolean claimed = FALSE;
+
+    if (http_cache_entry_contains(fetcher->entry, block))
+        return FALSE;
+
+    g_mutex_lock(&fetcher->lock);
+    if (!g_hash_table_contains(fetcher->pending, GUINT_TO_POINTER (block))) {
+        g_hash_table_add(fetcher->pending, GUINT_TO_POINTER (block));
+        claimed = TRUE;
+    }
+    g_mutex_unlock(&fetcher->lock);
+
+    return claimed;
+}
+
+/* Fetches a block claimed with fetcher_claim() and stores it, unless
+ * @cancellable, the one current when the block was claimed, was cancelled
+ * meanwhile. The claim is released either way. */
+static GBytes *fetcher_fetch(Fetcher *fetcher, guint block, GCancellable *cancellable,
+                             GError **error) {
+    guint64 offset = (guint64) block * HTTP_CACHE_BLOCK_SIZE;
+    guint64 length = MIN ((guint64) HTTP_CACHE_BLOCK_SIZE, fetcher->size - offset);
+    HttpResponse *response = NULL;
+    GBytes *bytes = NULL;
+
+    if (!g_cancellable_set_error_if_cancelled(cancellable, error))
+        response = http_client_get_range(fetcher->client, fetcher->uri, offset, length,
+                                         cancellable, error);
+
+    if (response) {
+        if (response->offset == offset && g_bytes_get_size(response->body) == length) {
+            bytes = g_bytes_ref(response->body);
+            http_cache_entry_store(fetcher->entry, block, g_bytes_get_data(bytes, NULL), length);
+        } else {
+            g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                        "Short range response for block %u", block);
+        }
+        http_response_free(response);
+    }
+
+    g_mutex_lock(&fetcher->lock);
+    g_hash_table_remove(fetcher->pending, GUINT_TO_POINTER (block));
+    g_cond_broadcast(&fetcher->cond);
+    g_mutex_unlock(&fetcher->lock);
+
+    return bytes;
+}
+
+static void prefetch_task_run(PrefetchTask *task, G_GNUC_UNUSED gpointer user_data) {
+    GError *err = NULL;
+    GBytes *bytes;
+
+    bytes = fetcher_fetch(task->fetcher, task->block, task->cancellable, &err);
+    if (bytes) {
+        g_bytes_unref(bytes);
+    } else {
+        GST_DEBUG ("Prefetching block %u failed: %s", task->block, err->message);
+        g_clear_error(&err);
+    }
+
+    g_object_unref(task->cancellable);
+    fetcher_unref(task->fetcher);
+    g_free(task);
+}
+
+/* Shared by all sources so the number of parallel requests stays bounded */
+static GThreadPool *prefetch_pool_get(void) {
+    static gsize pool = 0;
+
+    if (g_once_init_enter (&pool)) {
+        GThreadPool *p = g_thread_pool_new((GFunc) prefetch_task_run, NULL,
+                                           MAX_PREFETCH_THREADS, FALSE, NULL);
+
+        g_once_init_leave (&pool, (gsize) p);
+    }
+
+    return (GThreadPool *) pool;
+}
+
+/* Tasks still queued after a flush drop out as soon as they run, so the
+ * shared workers move on to the blocks of the new position */
+static void fetcher_prefetch(Fetcher *fetcher, guint first, guint n_blocks) {
+    guint n_total = (guint) ((fetcher->size + HTTP_CACHE_BLOCK_SIZE - 1) / HTTP_CACHE_BLOCK_SIZE);
+    guint block;
+
+    for (block = first; block < n_total && block < first + n_blocks; block++) {
+        PrefetchTask *task;
+
+        if (!fetcher_claim(fetcher, block))
+            continue;
+
+        task = g_new (PrefetchTask, 1);
+        task->fetcher = fetcher_ref(fetcher);
+        task->block = block;
+        task->cancellable = fetcher_get_cancellable(fetcher);
+        g_thread_pool_push(prefetch_pool_get(), task, NULL);
+    }
+}
+
+static void player_cache_src_init(PlayerCacheSrc *self) {
+    self->prefetch_blocks = DEFAULT_PREFETCH_BLOCKS;
+    gst_base_src_set_blocksize(GST_BASE_SRC (self), DEFAULT_BLOCKSIZE);
+}
+
+static void player_cache_src_finalize(GObject *object) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (object);
+
+    g_free(self->location);
+    g_free(self->user_agent);
+
+    G_OBJECT_CLASS (parent_class)->finalize(object);
+}
+
+static void player_cache_src_set_property(GObject *object, guint prop_id,
+                                          const GValue *value, GParamSpec *pspec) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (object);
+
+    switch (prop_id) {
+        case PROP_LOCATION:
+            GST_OBJECT_LOCK (self);
+            g_free(self->location);
+            self->location = g_value_dup_string(value);
+            GST_OBJECT_UNLOCK (self);
+            break;
+        case PROP_USER_AGENT:
+            GST_OBJECT_LOCK (self);
+            g_free(self->user_agent);
+            self->user_agent = g_value_dup_string(value);
+            GST_OBJECT_UNLOCK (self);
+            break;
+        case PROP_PREFETCH_BLOCKS:
+            GST_OBJECT_LOCK (self);
+            self->prefetch_blocks = g_value_get_uint(value);
+            GST_OBJECT_UNLOCK (self);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void player_cache_src_get_property(GObject *object, guint prop_id,
+                                          GValue *value, GParamSpec *pspec) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (object);
+
+    switch (prop_id) {
+        case PROP_LOCATION:
+            GST_OBJECT_LOCK (self);
+            g_value_set_string(value, self->location);
+            GST_OBJECT_UNLOCK (self);
+            break;
+        case PROP_USER_AGENT:
+            GST_OBJECT_LOCK (self);
+            g_value_set_string(value, self->user_agent);
+            GST_OBJECT_UNLOCK (self);
+            break;
+        case PROP_PREFETCH_BLOCKS:
+            GST_OBJECT_LOCK (self);
+            g_value_set_uint(value, self->prefetch_blocks);
+            GST_OBJECT_UNLOCK (self);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static gboolean player_cache_src_start(GstBaseSrc *src) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (src);
+    gchar *location, *user_agent;
+    Fetcher *fetcher;
+    GError *err = NULL;
+
+    GST_OBJECT_LOCK (self);
+    location = g_strdup(self->location);
+    user_agent = g_strdup(self->user_agent);
+    GST_OBJECT_UNLOCK (self);
+
+    if (!location) {
+        GST_ELEMENT_ERROR (self, RESOURCE, NOT_FOUND, ("No location set"), (NULL));
+        g_free(user_agent);
+        return FALSE;
+    }
+
+    fetcher = fetcher_new(user_agent);
+    g_free(user_agent);
+
+    /* Published first so unlock() can interrupt the first request */
+    GST_OBJECT_LOCK (self);
+    self->fetcher = fetcher_ref(fetcher);
+    GST_OBJECT_UNLOCK (self);
+
+    if (!fetcher_open(fetcher, location, &err)) {
+        GST_ELEMENT_ERROR (self, RESOURCE, OPEN_READ, ("Could not open %s", location),
+                           ("%s", err->message));
+        g_clear_error(&err);
+        g_free(location);
+        fetcher_unref(fetcher);
+        return FALSE;
+    }
+
+    GST_DEBUG_OBJECT (self, "Opened %s, %" G_GUINT64_FORMAT " bytes", location, fetcher->size);
+
+    g_free(location);
+    fetcher_unref(fetcher);
+
+    return TRUE;
+}
+
+static gboolean player_cache_src_stop(GstBaseSrc *src) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (src);
+    Fetcher *fetcher;
+
+    GST_OBJECT_LOCK (self);
+    fetcher = self->fetcher;
+    self->fetcher = NULL;
+    GST_OBJECT_UNLOCK (self);
+
+    /* Prefetch tasks still running keep their own reference */
+    if (fetcher) {
+        fetcher_cancel(fetcher);
+        fetcher_unref(fetcher);
+    }
+
+    return TRUE;
+}
+
+static gboolean player_cache_src_get_size(GstBaseSrc *src, guint64 *size) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (src);
+
+    if (!self->fetcher || !self->fetcher->entry)
+        return FALSE;
+
+    *size = self->fetcher->size;
+
+    return TRUE;
+}
+
+static gboolean player_cache_src_is_seekable(G_GNUC_UNUSED GstBaseSrc *src) {
+    return TRUE;
+}
+
+static gboolean player_cache_src_unlock(GstBaseSrc *src) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (src);
+
+    GST_OBJECT_LOCK (self);
+    if (self->fetcher)
+        fetcher_cancel(self->fetcher);
+    GST_OBJECT_UNLOCK (self);
+
+    return TRUE;
+}
+
+static gboolean player_cache_src_unlock_stop(GstBaseSrc *src) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (src);
+
+    GST_OBJECT_LOCK (self);
+    if (self->fetcher)
+        fetcher_uncancel(self->fetcher);
+    GST_OBJECT_UNLOCK (self);
+
+    return TRUE;
+}
+
+static GstFlowReturn player_cache_src_fill(GstBaseSrc *src, guint64 offset, guint length,
+                                           GstBuffer *buf) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (src);
+    Fetcher *fetcher = self->fetcher;
+    GCancellable *cancellable;
+    guint prefetch_blocks;
+    GstMapInfo map;
+    gsize done = 0;
+    guint block = 0;
+
+    if (offset >= fetcher->size)
+        return GST_FLOW_EOS;
+    length = (guint) MIN ((guint64) length, fetcher->size - offset);
+
+    GST_OBJECT_LOCK (self);
+    prefetch_blocks = self->prefetch_blocks;
+    GST_OBJECT_UNLOCK (self);
+
+    gst_buffer_map(buf, &map, GST_MAP_WRITE);
+    while (done < length) {
+        guint64 pos = offset + done;
+        gsize within = pos % HTTP_CACHE_BLOCK_SIZE;
+        gsize n = MIN ((gsize) HTTP_CACHE_BLOCK_SIZE - within, length - done);
+        GError *err = NULL;
+        GBytes *bytes;
+
+        block = (guint) (pos / HTTP_CACHE_BLOCK_SIZE);
+
+        /* A prefetch of the block may be on its way */
+        if (!fetcher_wait(fetcher, block)) {
+            gst_buffer_unmap(buf, &map);
+            return GST_FLOW_FLUSHING;
+        }
+
+        if (http_cache_entry_read(fetcher->entry, block, within, map.data + done, n)) {
+            done += n;
+            continue;
+        }
+
+        /* A prefetch may have claimed the block since, wait for it */
+        if (!fetcher_claim(fetcher, block))
+            continue;
+
+        cancellable = fetcher_get_cancellable(fetcher);
+        bytes = fetcher_fetch(fetcher, block, cancellable, &err);
+        g_object_unref(cancellable);
+        if (!bytes) {
+            GstFlowReturn ret = GST_FLOW_FLUSHING;
+
+            gst_buffer_unmap(buf, &map);
+            if (!g_error_matches(err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+                GST_ELEMENT_ERROR (self, RESOURCE, READ, ("Could not read %s", fetcher->uri),
+                                   ("%s", err->message));
+                ret = GST_FLOW_ERROR;
+            }
+            g_clear_error(&err);
+            return ret;
+        }
+        memcpy(map.data + done, (const guint8 *) g_bytes_get_data(bytes, NULL) + within, n);
+        g_bytes_unref(bytes);
+        done += n;
+    }
+    gst_buffer_unmap(buf, &map);
+    gst_buffer_set_size(buf, length);
+
+    if (prefetch_blocks > 0)
+        fetcher_prefetch(fetcher, block + 1, prefetch_blocks);
+
+    GST_BUFFER_OFFSET (buf) = offset;
+    GST_BUFFER_OFFSET_END (buf) = offset + length;
+
+    return GST_FLOW_OK;
+}
+
+static void player_cache_src_class_init(PlayerCacheSrcClass *klass) {
+    GObjectClass *gobject_class = (GObjectClass *) klass;
+    GstElementClass *element_class = (GstElementClass *) klass;
+    GstBaseSrcClass *basesrc_class = (GstBaseSrcClass *) klass;
+
+    GST_DEBUG_CATEGORY_INIT (cache_src_debug, "playercachesrc", 0, "Player cache source");
+
+    gobject_class->set_property = player_cache_src_set_property;
+    gobject_class->get_property = player_cache_src_get_property;
+    gobject_class->finalize = player_cache_src_finalize;
+
+    g_object_class_install_property(gobject_class, PROP_LOCATION,
+                                    g_param_spec_string("location", "Location",
+                                                        "HTTP URI to read", NULL,
+                                                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(gobject_class, PROP_USER_AGENT,
+                                    g_param_spec_string("user-agent", "User-Agent",
+                                                        "User-Agent header sent to the server", NULL,
+                                                        G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+    g_object_class_install_property(gobject_class, PROP_PREFETCH_BLOCKS,
+                                    g_param_spec_uint("prefetch-blocks", "Prefetch blocks",
+                                                      "Cache blocks to fetch ahead of the read position in parallel",
+                                                      0, 64, DEFAULT_PREFETCH_BLOCKS,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+    gst_element_class_add_static_pad_template(element_class, &src_template);
+    gst_element_class_set_static_metadata(element_class, "Player cache source",
+                                          "Source/Network",
+                                          "Reads HTTP resources through a local block cache",
+                                          "gstdemo");
+
+    basesrc_class->start = player_cache_src_start;
+    basesrc_class->stop = player_cache_src_stop;
+    basesrc_class->get_size = player_cache_src_get_size;
+    basesrc_class->is_seekable = player_cache_src_is_seekable;
+    basesrc_class->unlock = player_cache_src_unlock;
+    basesrc_class->unlock_stop = player_cache_src_unlock_stop;
+    basesrc_class->fill = player_cache_src_fill;
+}
+
+/* GstURIHandler */
+
+static GstURIType player_cache_src_uri_get_type(G_GNUC_UNUSED GType type) {
+    return GST_URI_SRC;
+}
+
+static const gchar *const *player_cache_src_uri_get_protocols(G_GNUC_UNUSED GType type) {
+    static const gchar *protocols[] = {
+            PLAYER_CACHE_SRC_SCHEME_PREFIX "http",
+            PLAYER_CACHE_SRC_SCHEME_PREFIX "https",
+            NULL
+    };
+
+    return protocols;
+}
+
+static gchar *player_cache_src_uri_get_uri(GstURIHandler *handler) {
+    PlayerCacheSrc *self = PLAYER_CACHE_SRC (handler);
+    gchar *uri = NULL;
+
+    GST_OBJECT_LOCK (self);
+    if (self->location)
+        uri = g_strconcat(PLAYER_CACHE_SRC_SCHEME_PREFIX, self->location, NULL);
+    GST_OBJECT_UNLOCK (self);
+
+    return uri;
+}
+
+static gboolean player_cache_src_uri_set_uri(GstURIHandler *handler, const gchar *uri,
+                                             GError **error) {
+    if (!g_str_has_prefix(uri, PLAYER_CACHE_SRC_SCHEME_PREFIX)) {
+        g_set_error(error, GST_URI_ERROR, GST_URI_ERROR_UNSUPPORTED_PROTOCOL,
+                    "Not a " PLAYER_CACHE_SRC_SCHEME_PREFIX " URI: %s", uri);
+        return FALSE;
+    }
+
+    g_object_set(handler, "location", uri + strlen(PLAYER_CACHE_SRC_SCHEME_PREFIX), NULL);
+
+    return TRUE;
+}
+
+static void player_cache_src_uri_handler_init(gpointer g_iface,
+                                              G_GNUC_UNUSED gpointer iface_data) {
+    GstURIHandlerInterface *iface = (GstURIHandlerInterface *) g_iface;
+
+    iface->get_type = player_cache_src_uri_get_type;
+    iface->get_protocols = player_cache_src_uri_get_protocols;
+    iface->get_uri = player_cache_src_uri_get_uri;
+    iface->set_uri = player_cache_src_uri_set_uri;
+}
@@ -0,0 +1,17 @@
+#ifndef __PLAYER_CACHE_SRC_H__
+#define __PLAYER_CACHE_SRC_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* URI schemes handled by playercachesrc, prefixed to http:// and https:// */
+#define PLAYER_CACHE_SRC_SCHEME_PREFIX "playercache+"
+
+#define GST_TYPE_PLAYER_CACHE_SRC (player_cache_src_get_type ())
+
+G_GNUC_INTERNAL GType player_cache_src_get_type(void);
+
+G_END_DECLS
+
+#endif /* __PLAYER_CACHE_SRC_H__ */
@@ -0,0 +1,678 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Fingerprint.h"
+#include "PlayerDefine.h"
+
+#include <gst/fft/gstfftf32.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (fingerprint_debug);
+#define GST_CAT_DEFAULT fingerprint_debug
+
+/* Spectral-band hashing after Haitsma & Kalker: 33 logarithmically spaced
+ * bands between 300 Hz and 2 kHz give 32 bits of sign information about
+ * the energy differences between neighbouring bands and frames. */
+#define FRAME_SIZE 2048
+#define HOP_SIZE 256
+#define N_BANDS 33
+#define MIN_FREQ 300.0
+#define MAX_FREQ 2000.0
+
+/* Only every INDEX_STRIDE-th hash is posted to the index; queries still
+ * use every hash, so any alignment finds the sparse postings */
+#define INDEX_STRIDE 8
+/* Hashes with more postings than this (silence, DC) carry no information */
+#define MAX_POSTINGS 20000
+#define MIN_VOTES 2
+#define MAX_CANDIDATES 64
+#define MIN_OVERLAP 16
+
+struct _PlayerFingerprint {
+    gint ref_count;
+    guint n_hashes;
+    guint32 hashes[];
+};
+
+struct _PlayerFingerprinter {
+    gint ref_count;
+
+    GMutex lock;
+    GstFFTF32 *fft;
+    guint band_edges[N_BANDS + 1];
+
+    gfloat frame[FRAME_SIZE];
+    gfloat windowed[FRAME_SIZE];
+    GstFFTF32Complex spectrum[FRAME_SIZE / 2 + 1];
+    guint filled;
+
+    gfloat prev_energy[N_BANDS];
+    gboolean have_prev;
+    GArray *hashes;
+};
+
+typedef struct {
+    guint32 entry;
+    guint32 offset;
+} Posting;
+
+typedef struct {
+    guint64 id;
+    PlayerFingerprint *fingerprint;
+} IndexEntry;
+
+typedef struct {
+    guint32 entry;
+    gint32 delta;
+} Vote;
+
+typedef struct {
+    guint n_votes;
+    Vote vote;
+} Candidate;
+
+struct _PlayerFingerprintIndex {
+    GRWLock lock;
+    GArray *entries;
+    GHashTable *postings;
+};
+
+G_DEFINE_BOXED_TYPE (PlayerFingerprint, player_fingerprint,
+                     player_fingerprint_ref, player_fingerprint_unref);
+
+static void fingerprint_init_debug(void) {
+    static gsize initialized = 0;
+
+    if (g_once_init_enter (&initialized)) {
+        GST_DEBUG_CATEGORY_INIT (fingerprint_debug, "player-fingerprint", 0,
+                                 "Player fingerprint");
+        g_once_init_leave (&initialized, 1);
+    }
+}
+
+static guint popcount32(guint32 v) {
+    v = v - ((v >> 1) & 0x55555555);
+    v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+    return (((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+static PlayerFingerprint *player_fingerprint_new(const guint32 *hashes, guint n_hashes) {
+    PlayerFingerprint *fingerprint;
+
+    fingerprint = g_malloc(sizeof(PlayerFingerprint) + n_hashes * sizeof(guint32));
+    fingerprint->ref_count = 1;
+    fingerprint->n_hashes = n_hashes;
+    if (n_hashes)
+        memcpy(fingerprint->hashes, hashes, n_hashes * sizeof(guint32));
+
+    return fingerprint;
+}
+
+PlayerFingerprint *player_fingerprint_ref(PlayerFingerprint *fingerprint) {
+    g_return_val_if_fail (fingerprint != NULL, NULL);
+
+    g_atomic_int_inc(&fingerprint->ref_count);
+
+    return fingerprint;
+}
+
+void player_fingerprint_unref(PlayerFingerprint *fingerprint) {
+    g_return_if_fail (fingerprint != NULL);
+
+    if (g_atomic_int_dec_and_test(&fingerprint->ref_count))
+        g_free(fingerprint);
+}
+
+/**
+ * player_fingerprint_get_hashes:
+ * @fingerprint: a #PlayerFingerprint
+ * @n_hashes: (out): number of hashes
+ *
+ * Returns: (transfer none) (array length=n_hashes): the hash sequence,
+ * one hash every %PLAYER_FINGERPRINT_HASH_DURATION.
+ */
+const guint32 *player_fingerprint_get_hashes(const PlayerFingerprint *fingerprint,
+                                             guint *n_hashes) {
+    g_return_val_if_fail (fingerprint != NULL, NULL);
+
+    if (n_hashes)
+        *n_hashes = fingerprint->n_hashes;
+
+    return fingerprint->hashes;
+}
+
+GstClockTime player_fingerprint_get_duration(const PlayerFingerprint *fingerprint) {
+    g_return_val_if_fail (fingerprint != NULL, GST_CLOCK_TIME_NONE);
+
+    return fingerprint->n_hashes * PLAYER_FINGERPRINT_HASH_DURATION;
+}
+
+/**
+ * player_fingerprint_compare:
+ * @reference: a #PlayerFingerprint
+ * @query: the #PlayerFingerprint to compare with @reference
+ * @offset: index in @reference that the first hash of @query aligns to,
+ * may be negative
+ *
+ * Returns: 1.0 minus the bit error rate over the overlapping hashes, or
+ * 0.0 if they overlap too little to tell.
+ */
+gdouble player_fingerprint_compare(const PlayerFingerprint *reference,
+                                   const PlayerFingerprint *query,
+                                   gint offset) {
+    gint64 first, last, j;
+    guint64 errors = 0;
+
+    g_return_val_if_fail (reference != NULL, 0.0);
+    g_return_val_if_fail (query != NULL, 0.0);
+
+    first = MAX (0, -(gint64) offset);
+    last = MIN ((gint64) query->n_hashes, (gint64) reference->n_hashes - offset);
+    if (last - first < MIN_OVERLAP)
+        return 0.0;
+
+    for (j = first; j < last; j++)
+        errors += popcount32(query->hashes[j] ^ reference->hashes[j + offset]);
+
+    return 1.0 - (gdouble) errors / (gdouble) ((last - first) * 32);
+}
+
+/* Fingerprinter */
+
+PlayerFingerprinter *player_fingerprinter_new(void) {
+    PlayerFingerprinter *self;
+    guint i;
+
+    fingerprint_init_debug();
+
+    self = g_new0 (PlayerFingerprinter, 1);
+    self->ref_count = 1;
+    g_mutex_init(&self->lock);
+    self->fft = gst_fft_f32_new(FRAME_SIZE, FALSE);
+    self->hashes = g_array_new(FALSE, FALSE, sizeof(guint32));
+
+    for (i = 0; i <= N_BANDS; i++) {
+        gdouble freq = MIN_FREQ * pow(MAX_FREQ / MIN_FREQ, (gdouble) i / N_BANDS);
+
+        self->band_edges[i] = (guint) (freq * FRAME_SIZE / PLAYER_FINGERPRINT_SAMPLE_RATE);
+    }
+
+    return self;
+}
+
+PlayerFingerprinter *player_fingerprinter_ref(PlayerFingerprinter *self) {
+    g_return_val_if_fail (self != NULL, NULL);
+
+    g_atomic_int_inc(&self->ref_count);
+
+    return self;
+}
+
+void player_fingerprinter_unref(PlayerFingerprinter *self) {
+    g_return_if_fail (self != NULL);
+
+    if (!g_atomic_int_dec_and_test(&self->ref_count))
+        return;
+
+    gst_fft_f32_free(self->fft);
+    g_array_unref(self->hashes);
+    g_mutex_clear(&self->lock);
+    g_free(self);
+}
+
+/* Must be called with lock and a full frame */
+static void fingerprinter_process_frame(PlayerFingerprinter *self) {
+    gfloat energy[N_BANDS];
+    guint32 hash = 0;
+    guint b, k;
+
+    memcpy(self->windowed, self->frame, sizeof(self->windowed));
+    gst_fft_f32_window(self->fft, self->windowed, GST_FFT_WINDOW_HAMMING);
+    gst_fft_f32_fft(self->fft, self->windowed, self->spectrum);
+
+    /* Straight loops over contiguous floats, left to the auto-vectorizer */
+    for (b = 0; b < N_BANDS; b++) {
+        gfloat sum = 0.0f;
+
+        for (k = self->band_edges[b]; k < self->band_edges[b + 1]; k++)
+            sum += self->spectrum[k].r * self->spectrum[k].r +
+                   self->spectrum[k].i * self->spectrum[k].i;
+        energy[b] = sum;
+    }
+
+    if (self->have_prev) {
+        for (b = 0; b < N_BANDS - 1; b++) {
+            gfloat d = (energy[b] - energy[b + 1]) -
+                       (self->prev_energy[b] - self->prev_energy[b + 1]);
+
+            if (d > 0.0f)
+                hash |= 1u << b;
+        }
+        g_array_append_val(self->hashes, hash);
+    }
+
+    memcpy(self->prev_energy, energy, sizeof(energy));
+    self->have_prev = TRUE;
+}
+
+/**
+ * player_fingerprinter_feed:
+ * @fingerprinter: a #PlayerFingerprinter
+ * @samples: mono samples at %PLAYER_FINGERPRINT_SAMPLE_RATE
+ * @n_samples: number of samples
+ *
+ * Adds decoded audio to the running fingerprint.
+ */
+void player_fingerprinter_feed(PlayerFingerprinter *self,
+                               const gfloat *samples, gsize n_samples) {
+    g_return_if_fail (self != NULL);
+
+    g_mutex_lock(&self->lock);
+    while (n_samples > 0) {
+        gsize n = MIN (n_samples, (gsize) (FRAME_SIZE - self->filled));
+
+        memcpy(self->frame + self->filled, samples, n * sizeof(gfloat));
+        self->filled += n;
+        samples += n;
+        n_samples -= n;
+
+        if (self->filled == FRAME_SIZE) {
+            fingerprinter_process_frame(self);
+            memmove(self->frame, self->frame + HOP_SIZE,
+                    (FRAME_SIZE - HOP_SIZE) * sizeof(gfloat));
+            self->filled = FRAME_SIZE - HOP_SIZE;
+        }
+    }
+    g_mutex_unlock(&self->lock);
+}
+
+/**
+ * player_fingerprinter_finish:
+ * @fingerprinter: a #PlayerFingerprinter
+ *
+ * Returns the fingerprint of everything fed so far and resets
+ * @fingerprinter for the next stream.
+ *
+ * Returns: (transfer full): the #PlayerFingerprint
+ */
+PlayerFingerprint *player_fingerprinter_finish(PlayerFingerprinter *self) {
+    PlayerFingerprint *fingerprint;
+
+    g_return_val_if_fail (self != NULL, NULL);
+
+    g_mutex_lock(&self->lock);
+    fingerprint = player_fingerprint_new((const guint32 *) self->hashes->data,
+                                         self->hashes->len);
+    g_array_set_size(self->hashes, 0);
+    self->filled = 0;
+    self->have_prev = FALSE;
+    g_mutex_unlock(&self->lock);
+
+    GST_DEBUG ("Finished fingerprint with %u hashes", fingerprint->n_hashes);
+
+    return fingerprint;
+}
+
+static void fingerprint_sink_handoff_cb(G_GNUC_UNUSED GstElement *sink, GstBuffer *buffer,
+                                        G_GNUC_UNUSED GstPad *pad,
+                                        PlayerFingerprinter *self) {
+    GstMapInfo map;
+
+    if (!gst_buffer_map(buffer, &map, GST_MAP_READ))
+        return;
+
+    player_fingerprinter_feed(self, (const gfloat *) map.data, map.size / sizeof(gfloat));
+    gst_buffer_unmap(buffer, &map);
+}
+
+/**
+ * player_fingerprinter_create_sink:
+ * @fingerprinter: a #PlayerFingerprinter
+ *
+ * Creates an unsynchronized audio sink bin that converts and resamples
+ * whatever it receives and feeds it to @fingerprinter, suitable as
+ * playbin audio-sink or behind a decoder.
+ *
+ * Returns: (transfer floating): the sink bin, or %NULL if elements are missing
+ */
+GstElement *player_fingerprinter_create_sink(PlayerFingerprinter *self) {
+    GstElement *bin, *convert, *resample, *filter, *sink;
+    GstCaps *caps;
+    GstPad *pad;
+
+    g_return_val_if_fail (self != NULL, NULL);
+
+    convert = gst_element_factory_make("audioconvert", NULL);
+    resample = gst_element_factory_make("audioresample", NULL);
+    filter = gst_element_factory_make("capsfilter", NULL);
+    sink = gst_element_factory_make("fakesink", NULL);
+
+    if (!convert || !resample || !filter || !sink) {
+        GST_ERROR ("audioconvert, audioresample, capsfilter or fakesink not available");
+        if (convert)
+            gst_object_unref(convert);
+        if (resample)
+            gst_object_unref(resample);
+        if (filter)
+            gst_object_unref(filter);
+        if (sink)
+            gst_object_unref(sink);
+        return NULL;
+    }
+
+    caps = gst_caps_new_simple("audio/x-raw",
+                               "format", G_TYPE_STRING,
+                               G_BYTE_ORDER == G_LITTLE_ENDIAN ? "F32LE" : "F32BE",
+                               "layout", G_TYPE_STRING, "interleaved",
+                               "rate", G_TYPE_INT, PLAYER_FINGERPRINT_SAMPLE_RATE,
+                               "channels", G_TYPE_INT, 1, NULL);
+    g_object_set(filter, "caps", caps, NULL);
+    gst_caps_unref(caps);
+
+    g_object_set(sink, "sync", FALSE, "signal-handoffs", TRUE, NULL);
+    g_signal_connect_data(sink, "handoff", G_CALLBACK(fingerprint_sink_handoff_cb),
+                          player_fingerprinter_ref(self),
+                          (GClosureNotify) player_fingerprinter_unref, 0);
+
+    bin = gst_bin_new("fingerprint-sink");
+    gst_bin_add_many(GST_BIN (bin), convert, resample, filter, sink, NULL);
+    gst_element_link_many(convert, resample, filter, sink, NULL);
+
+    pad = gst_element_get_static_pad(convert, "sink");
+    gst_element_add_pad(bin, gst_ghost_pad_new("sink", pad));
+    gst_object_unref(pad);
+
+    return bin;
+}
+
+static void fingerprint_decoder_pad_added_cb(G_GNUC_UNUSED GstElement *decoder,
+                                             GstPad *pad, GstElement *sink) {
+    GstPad *sinkpad = gst_element_get_static_pad(sink, "sink");
+
+    /* The first audio stream wins, later ones stay unlinked */
+    if (!gst_pad_is_linked(sinkpad))
+        gst_pad_link(pad, sinkpad);
+
+    gst_object_unref(sinkpad);
+}
+
+/**
+ * player_fingerprint_compute:
+ * @uri: the URI to fingerprint
+ * @error: return location for a #GError
+ *
+ * Decodes the first audio stream of @uri as fast as possible and
+ * fingerprints it. Blocks until the whole stream has been decoded.
+ *
+ * Returns: (transfer full): the #PlayerFingerprint or %NULL on error
+ */
+PlayerFingerprint *player_fingerprint_compute(const gchar *uri, GError **error) {
+    PlayerFingerprinter *fingerprinter;
+    PlayerFingerprint *fingerprint = NULL;
+    GstElement *pipeline, *decoder, *sink;
+    GstCaps *caps;
+    GstBus *bus;
+    GstMessage *msg;
+
+    g_return_val_if_fail (uri != NULL, NULL);
+
+    fingerprinter = player_fingerprinter_new();
+
+    decoder = gst_element_factory_make("uridecodebin", NULL);
+    sink = player_fingerprinter_create_sink(fingerprinter);
+    if (!decoder || !sink) {
+        g_set_error(error, PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                    "Elements for fingerprinting not available");
+        if (decoder)
+            gst_object_unref(decoder);
+        if (sink)
+            gst_object_unref(sink);
+        player_fingerprinter_unref(fingerprinter);
+        return NULL;
+    }
+
+    caps = gst_caps_new_empty_simple("audio/x-raw");
+    g_object_set(decoder, "uri", uri, "caps", caps, "expose-all-streams", FALSE, NULL);
+    gst_caps_unref(caps);
+
+    pipeline = gst_pipeline_new(NULL);
+    gst_bin_add_many(GST_BIN (pipeline), decoder, sink, NULL);
+    g_signal_connect (decoder, "pad-added",
+                      G_CALLBACK(fingerprint_decoder_pad_added_cb), sink);
+
+    bus = gst_element_get_bus(pipeline);
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        g_set_error(error, PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                    "Failed to start decoding %s", uri);
+    } else {
+        msg = gst_bus_timed_pop_filtered(bus, GST_CLOCK_TIME_NONE,
+                                         GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+        if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS) {
+            fingerprint = player_fingerprinter_finish(fingerprinter);
+        } else {
+            GError *err = NULL;
+
+            gst_message_parse_error(msg, &err, NULL);
+            g_set_error(error, PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                        "Failed to decode %s: %s", uri, err->message);
+            g_clear_error(&err);
+        }
+        gst_message_unref(msg);
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(bus);
+    gst_object_unref(pipeline);
+    player_fingerprinter_unref(fingerprinter);
+
+    return fingerprint;
+}
+
+/* Index */
+
+static void postings_free(GArray *postings) {
+    g_array_unref(postings);
+}
+
+PlayerFingerprintIndex *player_fingerprint_index_new(void) {
+    PlayerFingerprintIndex *index;
+
+    fingerprint_init_debug();
+
+    index = g_new0 (PlayerFingerprintIndex, 1);
+    g_rw_lock_init(&index->lock);
+    index->entries = g_array_new(FALSE, FALSE, sizeof(IndexEntry));
+    index->postings = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                            (GDestroyNotify) postings_free);
+
+    return index;
+}
+
+void player_fingerprint_index_free(PlayerFingerprintIndex *index) {
+    guint i;
+
+    g_return_if_fail (index != NULL);
+
+    for (i = 0; i < index->entries->len; i++)
+        player_fingerprint_unref(g_array_index (index->entries, IndexEntry, i).fingerprint);
+    g_array_unref(index->entries);
+    g_hash_table_unref(index->postings);
+    g_rw_lock_clear(&index->lock);
+    g_free(index);
+}
+
+/**
+ * player_fingerprint_index_add:
+ * @index: a #PlayerFingerprintIndex
+ * @id: caller-defined id returned in matches
+ * @fingerprint: the #PlayerFingerprint to add, a reference is kept for
+ * verifying candidates
+ */
+void player_fingerprint_index_add(PlayerFingerprintIndex *index, guint64 id,
+                                  PlayerFingerprint *fingerprint) {
+    IndexEntry entry;
+    guint32 i;
+
+    g_return_if_fail (index != NULL);
+    g_return_if_fail (fingerprint != NULL);
+
+    entry.id = id;
+    entry.fingerprint = player_fingerprint_ref(fingerprint);
+
+    g_rw_lock_writer_lock(&index->lock);
+    g_array_append_val(index->entries, entry);
+
+    for (i = 0; i < fingerprint->n_hashes; i += INDEX_STRIDE) {
+        gpointer key = GUINT_TO_POINTER (fingerprint->hashes[i]);
+        GArray *postings = g_hash_table_lookup(index->postings, key);
+        Posting posting;
+
+        if (!postings) {
+            postings = g_array_sized_new(FALSE, FALSE, sizeof(Posting), 1);
+            g_hash_table_insert(index->postings, key, postings);
+        }
+        posting.entry = index->entries->len - 1;
+        posting.offset = i;
+        g_array_append_val(postings, posting);
+    }
+    g_rw_lock_writer_unlock(&index->lock);
+}
+
+guint player_fingerprint_index_get_size(PlayerFingerprintIndex *index) {
+    guint size;
+
+    g_return_val_if_fail (index != NULL, 0);
+
+    g_rw_lock_reader_lock(&index->lock);
+    size = index->entries->len;
+    g_rw_lock_reader_unlock(&index->lock);
+
+    return size;
+}
+
+static gint vote_compare(gconstpointer a, gconstpointer b) {
+    const Vote *va = a, *vb = b;
+
+    if (va->entry != vb->entry)
+        return va->entry < vb->entry ? -1 : 1;
+    if (va->delta != vb->delta)
+        return va->delta < vb->delta ? -1 : 1;
+    return 0;
+}
+
+static gint candidate_compare(gconstpointer a, gconstpointer b) {
+    const Candidate *ca = a, *cb = b;
+
+    return (gint) cb->n_votes - (gint) ca->n_votes;
+}
+
+static gint match_compare(gconstpointer a, gconstpointer b) {
+    const PlayerFingerprintMatch *ma = a, *mb = b;
+
+    if (ma->score == mb->score)
+        return 0;
+    return ma->score < mb->score ? 1 : -1;
+}
+
+/**
+ * player_fingerprint_index_lookup:
+ * @index: a #PlayerFingerprintIndex
+ * @query: the #PlayerFingerprint to look up, may be an excerpt
+ * @min_score: minimum similarity, e.g. 0.65
+ * @max_results: maximum number of matches
+ *
+ * Finds indexed fingerprints containing @query. Candidates are found by
+ * voting on exact hash hits with a consistent time offset, so the cost
+ * depends on the number of hits rather than the size of the index, and
+ * are then verified by bit error rate.
+ *
+ * Returns: (transfer full) (element-type PlayerFingerprintMatch): matches
+ * sorted by descending score
+ */
+GArray *player_fingerprint_index_lookup(PlayerFingerprintIndex *index,
+                                        const PlayerFingerprint *query,
+                                        gdouble min_score,
+                                        guint max_results) {
+    GArray *votes, *candidates, *matches;
+    GHashTable *seen;
+    guint i, j, run;
+
+    g_return_val_if_fail (index != NULL, NULL);
+    g_return_val_if_fail (query != NULL, NULL);
+
+    matches = g_array_new(FALSE, FALSE, sizeof(PlayerFingerprintMatch));
+    votes = g_array_new(FALSE, FALSE, sizeof(Vote));
+    candidates = g_array_new(FALSE, FALSE, sizeof(Candidate));
+
+    g_rw_lock_reader_lock(&index->lock);
+
+    for (i = 0; i < query->n_hashes; i++) {
+        GArray *postings = g_hash_table_lookup(index->postings,
+                                               GUINT_TO_POINTER (query->hashes[i]));
+
+        if (!postings || postings->len > MAX_POSTINGS)
+            continue;
+
+        for (j = 0; j < postings->len; j++) {
+            const Posting *posting = &g_array_index (postings, Posting, j);
+            Vote vote;
+
+            vote.entry = posting->entry;
+            vote.delta = (gint32) posting->offset - (gint32) i;
+            g_array_append_val(votes, vote);
+        }
+    }
+
+    /* Count runs of identical (entry, delta) pairs */
+    g_array_sort(votes, vote_compare);
+    for (i = 0; i < votes->len; i += run) {
+        const Vote *vote = &g_array_index (votes, Vote, i);
+
+        for (run = 1; i + run < votes->len &&
+                      vote_compare(vote, &g_array_index (votes, Vote, i + run)) == 0; run++);
+
+        if (run >= MIN_VOTES) {
+            Candidate candidate = {run, *vote};
+
+            g_array_append_val(candidates, candidate);
+        }
+    }
+    g_array_sort(candidates, candidate_compare);
+
+    seen = g_hash_table_new(g_direct_hash, g_direct_equal);
+    for (i = 0; i < candidates->len && i < MAX_CANDIDATES; i++) {
+        const Vote *vote = &g_array_index (candidates, Candidate, i).vote;
+        const IndexEntry *entry = &g_array_index (index->entries, IndexEntry, vote->entry);
+        PlayerFingerprintMatch match;
+
+        if (g_hash_table_contains(seen, GUINT_TO_POINTER (vote->entry)))
+            continue;
+
+        match.score = player_fingerprint_compare(entry->fingerprint, query, vote->delta);
+        if (match.score < min_score)
+            continue;
+
+        g_hash_table_add(seen, GUINT_TO_POINTER (vote->entry));
+        match.id = entry->id;
+        match.offset = (GstClockTimeDiff) vote->delta *
+                       (GstClockTimeDiff) PLAYER_FINGERPRINT_HASH_DURATION;
+        g_array_append_val(matches, match);
+    }
+
+    g_rw_lock_reader_unlock(&index->lock);
+
+    g_hash_table_unref(seen);
+    g_array_unref(candidates);
+    g_array_unref(votes);
+
+    g_array_sort(matches, match_compare);
+    if (matches->len > max_results)
+        g_array_set_size(matches, max_results);
+
+    GST_DEBUG ("Lookup of %u hashes found %u matches", query->n_hashes, matches->len);
+
+    return matches;
+}
@@ -0,0 +1,118 @@
+#ifndef __PLAYER_FINGERPRINT_H__
+#define __PLAYER_FINGERPRINT_H__
+
+#include <gst/gst.h>
+#include "PlayerPrelude.h"
+
+G_BEGIN_DECLS
+
+/* Decoded audio is resampled to this mono rate before hashing */
+#define PLAYER_FINGERPRINT_SAMPLE_RATE 5512
+
+/* Duration covered by one hash step */
+#define PLAYER_FINGERPRINT_HASH_DURATION \
+  (gst_util_uint64_scale_int (GST_SECOND, 256, PLAYER_FINGERPRINT_SAMPLE_RATE))
+
+#define GST_TYPE_PLAYER_FINGERPRINT (player_fingerprint_get_type ())
+
+/**
+ * PlayerFingerprint:
+ *
+ * Compact acoustic fingerprint of a stream: one 32 bit spectral-band hash
+ * per hash step. Immutable and reference counted.
+ */
+typedef struct _PlayerFingerprint PlayerFingerprint;
+
+/**
+ * PlayerFingerprinter:
+ *
+ * Incremental fingerprint calculator fed with mono float samples at
+ * %PLAYER_FINGERPRINT_SAMPLE_RATE.
+ */
+typedef struct _PlayerFingerprinter PlayerFingerprinter;
+
+/**
+ * PlayerFingerprintIndex:
+ *
+ * Inverted index over fingerprints for near-duplicate lookups.
+ */
+typedef struct _PlayerFingerprintIndex PlayerFingerprintIndex;
+
+/**
+ * PlayerFingerprintMatch:
+ * @id: id the matching fingerprint was added with
+ * @score: similarity in [0, 1], 1.0 minus the bit error rate
+ * @offset: position of the query inside the matching fingerprint
+ */
+typedef struct {
+    guint64 id;
+    gdouble score;
+    GstClockTimeDiff offset;
+} PlayerFingerprintMatch;
+
+GST_PLAYER_API
+GType               player_fingerprint_get_type (void);
+
+GST_PLAYER_API
+PlayerFingerprint * player_fingerprint_ref (PlayerFingerprint *fingerprint);
+
+GST_PLAYER_API
+void                player_fingerprint_unref (PlayerFingerprint *fingerprint);
+
+GST_PLAYER_API
+const guint32 *     player_fingerprint_get_hashes (const PlayerFingerprint *fingerprint,
+                                                   guint *n_hashes);
+
+GST_PLAYER_API
+GstClockTime        player_fingerprint_get_duration (const PlayerFingerprint *fingerprint);
+
+GST_PLAYER_API
+gdouble             player_fingerprint_compare (const PlayerFingerprint *reference,
+                                                const PlayerFingerprint *query,
+                                                gint offset);
+
+GST_PLAYER_API
+PlayerFingerprint * player_fingerprint_compute (const gchar *uri, GError **error);
+
+GST_PLAYER_API
+PlayerFingerprinter * player_fingerprinter_new (void);
+
+GST_PLAYER_API
+PlayerFingerprinter * player_fingerprinter_ref (PlayerFingerprinter *fingerprinter);
+
+GST_PLAYER_API
+void                player_fingerprinter_unref (PlayerFingerprinter *fingerprinter);
+
+GST_PLAYER_API
+void                player_fingerprinter_feed (PlayerFingerprinter *fingerprinter,
+                                               const gfloat *samples, gsize n_samples);
+
+GST_PLAYER_API
+PlayerFingerprint * player_fingerprinter_finish (PlayerFingerprinter *fingerprinter);
+
+GST_PLAYER_API
+GstElement *        player_fingerprinter_create_sink (PlayerFingerprinter *fingerprinter);
+
+GST_PLAYER_API
+PlayerFingerprintIndex * player_fingerprint_index_new (void);
+
+GST_PLAYER_API
+void                player_fingerprint_index_free (PlayerFingerprintIndex *index);
+
+GST_PLAYER_API
+void                player_fingerprint_index_add (PlayerFingerprintIndex *index,
+                                                  guint64 id,
+                                                  PlayerFingerprint *fingerprint);
+
+GST_PLAYER_API
+guint               player_fingerprint_index_get_size (PlayerFingerprintIndex *index);
+
+GST_PLAYER_API
+GArray *            player_fingerprint_index_lookup (PlayerFingerprintIndex *index,
+                                                     const PlayerFingerprint *query,
+                                                     gdouble min_score,
+                                                     guint max_results);
+
+G_END_DECLS
+
+#endif /* __PLAYER_FINGERPRINT_H__ */
@@ -0,0 +1,413 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/* For fallocate() */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "HttpCache.h"
+#include "HttpCachePrivate.h"
+
+#include <glib/gstdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+GST_DEBUG_CATEGORY_STATIC (http_cache_debug);
+#define GST_CAT_DEFAULT http_cache_debug
+
+#define DEFAULT_MAX_BYTES (512 * 1024 * 1024)
+
+/*
+ * One sparse file per URI, sized to the resource, so blocks are written
+ * where they belong and only fetched blocks take up disk space. A single
+ * LRU list over the blocks of all entries keeps the total within the
+ * budget; evicted blocks are punched out of their file. Blocks go through
+ * pread() and pwrite() rather than a shared mapping, as writing a mapping
+ * of a sparse file raises SIGBUS once the disk is full. They are copied
+ * without the cache lock: a block being read is pinned so it is not
+ * evicted meanwhile, and a block being stored is only added to the LRU
+ * list once complete.
+ */
+struct _HttpCacheEntry {
+    gint ref_count;
+    gchar *uri;
+    gchar *path;
+    gint fd;
+    guint64 size;
+    guint n_blocks;
+    GList **blocks;     /* Link in the LRU list per block, NULL if absent */
+    guint *pins;        /* Readers copying out of each block */
+    gboolean *storing;  /* Whether each block is being copied in */
+    guint n_cached;
+    gboolean dropped;   /* No longer in the cache, still referenced */
+};
+
+typedef struct {
+    HttpCacheEntry *entry;
+    guint block;
+} BlockRef;
+
+typedef struct {
+    GMutex lock;
+    gchar *directory;
+    guint64 max_bytes;
+    guint64 cached_bytes;
+    GHashTable *entries;   /* uri -> HttpCacheEntry, holds a reference */
+    GQueue lru;            /* BlockRef, least recently used first */
+
+    guint64 hits;
+    guint64 misses;
+    guint64 n_evictions;
+} HttpCache;
+
+static HttpCache *http_cache_get(void) {
+    static gsize initialized = 0;
+    static HttpCache cache;
+
+    if (g_once_init_enter (&initialized)) {
+        GST_DEBUG_CATEGORY_INIT (http_cache_debug, "player-http-cache", 0,
+                                 "Player HTTP cache");
+        g_mutex_init(&cache.lock);
+        cache.directory = g_build_filename(g_get_user_cache_dir(), "gstdemo", "http", NULL);
+        cache.max_bytes = DEFAULT_MAX_BYTES;
+        cache.entries = g_hash_table_new(g_str_hash, g_str_equal);
+        g_queue_init(&cache.lru);
+        g_once_init_leave (&initialized, 1);
+    }
+
+    return &cache;
+}
+
+static guint block_length(HttpCacheEntry *entry, guint block) {
+    guint64 start = (guint64) block * HTTP_CACHE_BLOCK_SIZE;
+
+    return (guint) MIN ((guint64) HTTP_CACHE_BLOCK_SIZE, entry->size - start);
+}
+
+static void entry_free(HttpCacheEntry *entry) {
+    GST_DEBUG ("Closing cache file %s", entry->path);
+
+    if (entry->fd >= 0)
+        close(entry->fd);
+    if (!entry->dropped)
+        g_unlink(entry->path);
+    g_free(entry->blocks);
+    g_free(entry->pins);
+    g_free(entry->storing);
+    g_free(entry->path);
+    g_free(entry->uri);
+    g_free(entry);
+}
+
+static void entry_drop(HttpCache *cache, HttpCacheEntry *entry);
+
+/* Must be called with lock */
+static void evict_block(HttpCache *cache, GList *link) {
+    BlockRef *ref = link->data;
+    HttpCacheEntry *entry = ref->entry;
+    guint len = block_length(entry, ref->block);
+
+    g_queue_delete_link(&cache->lru, link);
+    entry->blocks[ref->block] = NULL;
+    entry->n_cached--;
+    cache->cached_bytes -= len;
+    cache->n_evictions++;
+
+#ifdef FALLOC_FL_PUNCH_HOLE
+    fallocate(entry->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+              (off_t) ref->block * HTTP_CACHE_BLOCK_SIZE, len);
+#endif
+    g_free(ref);
+
+    /* Close and delete files nobody reads from once they are empty */
+    if (entry->n_cached == 0 && g_atomic_int_get(&entry->ref_count) == 1)
+        entry_drop(cache, entry);
+}
+
+/* Must be called with lock */
+static void entry_drop(HttpCache *cache, HttpCacheEntry *entry) {
+    guint i;
+
+    for (i = 0; i < entry->n_blocks; i++) {
+        if (entry->blocks[i]) {
+            g_free(entry->blocks[i]->data);
+            g_queue_delete_link(&cache->lru, entry->blocks[i]);
+            entry->blocks[i] = NULL;
+            cache->cached_bytes -= block_length(entry, i);
+        }
+    }
+    entry->n_cached = 0;
+    /* Unlinked right away so a new entry for the URI gets a new file */
+    entry->dropped = TRUE;
+    g_unlink(entry->path);
+    g_hash_table_remove(cache->entries, entry->uri);
+    http_cache_entry_unref(entry);
+}
+
+/* Must be called with lock. Pinned blocks are skipped and evicted by the
+ * call after their last reader. */
+static void enforce_budget(HttpCache *cache) {
+    GList *link = cache->lru.head, *next;
+
+    while (cache->cached_bytes > cache->max_bytes && link) {
+        BlockRef *ref = link->data;
+
+        next = link->next;
+        if (ref->entry->pins[ref->block] == 0)
+            evict_block(cache, link);
+        link = next;
+    }
+}
+
+/**
+ * player_http_cache_configure:
+ * @directory: (nullable): directory for the cache files, %NULL for the
+ * user cache directory
+ * @max_bytes: budget for all cached blocks together
+ *
+ * Configures the process-wide HTTP block cache used by players with the
+ * http-cache config enabled. The files are scratch space: their contents
+ * are not reused by later processes.
+ */
+void player_http_cache_configure(const gchar *directory, guint64 max_bytes) {
+    HttpCache *cache = http_cache_get();
+
+    g_mutex_lock(&cache->lock);
+    if (directory) {
+        g_free(cache->directory);
+        cache->directory = g_strdup(directory);
+    }
+    cache->max_bytes = max_bytes;
+    enforce_budget(cache);
+    g_mutex_unlock(&cache->lock);
+}
+
+/**
+ * player_http_cache_get_stats:
+ * @stats: (out caller-allocates): return location for the statistics
+ */
+void player_http_cache_get_stats(PlayerHttpCacheStats *stats) {
+    HttpCache *cache = http_cache_get();
+
+    g_return_if_fail (stats != NULL);
+
+    g_mutex_lock(&cache->lock);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->hit_ratio = cache->hits + cache->misses > 0
+                       ? (gdouble) cache->hits / (gdouble) (cache->hits + cache->misses) : 0.0;
+    stats->cached_bytes = cache->cached_bytes;
+    stats->max_bytes = cache->max_bytes;
+    stats->n_evictions = cache->n_evictions;
+    g_mutex_unlock(&cache->lock);
+}
+
+static HttpCacheEntry *entry_create(HttpCache *cache, const gchar *uri, guint64 size,
+                                    GError **error) {
+    HttpCacheEntry *entry;
+    gchar *name;
+
+    if (g_mkdir_with_parents(cache->directory, 0700) < 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno),
+                    "Cannot create cache directory %s: %s", cache->directory, g_strerror(errno));
+        return NULL;
+    }
+
+    entry = g_new0 (HttpCacheEntry, 1);
+    entry->ref_count = 1;
+    entry->uri = g_strdup(uri);
+    entry->size = size;
+    entry->n_blocks = (guint) ((size + HTTP_CACHE_BLOCK_SIZE - 1) / HTTP_CACHE_BLOCK_SIZE);
+    entry->blocks = g_new0 (GList *, entry->n_blocks);
+    entry->pins = g_new0 (guint, entry->n_blocks);
+    entry->storing = g_new0 (gboolean, entry->n_blocks);
+
+    name = g_compute_checksum_for_string(G_CHECKSUM_SHA256, uri, -1);
+    entry->path = g_build_filename(cache->directory, name, NULL);
+    g_free(name);
+
+    entry->fd = g_open(entry->path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (entry->fd < 0 || ftruncate(entry->fd, (off_t) size) < 0) {
+        g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(errno),
+                    "Cannot create cache file %s: %s", entry->path, g_strerror(errno));
+        entry_free(entry);
+        return NULL;
+    }
+
+    GST_DEBUG ("Created cache file %s for %s (%" G_GUINT64_FORMAT " bytes)",
+               entry->path, uri, size);
+
+    return entry;
+}
+
+/* Returns the cache entry for @uri, creating it if needed. An existing
+ * entry of a different size is discarded as the resource changed. */
+HttpCacheEntry *http_cache_entry_open(const gchar *uri, guint64 size, GError **error) {
+    HttpCache *cache = http_cache_get();
+    HttpCacheEntry *entry;
+
+    g_return_val_if_fail (size > 0, NULL);
+
+    g_mutex_lock(&cache->lock);
+    entry = g_hash_table_lookup(cache->entries, uri);
+    if (entry && entry->size != size) {
+        entry_drop(cache, entry);
+        entry = NULL;
+    }
+
+    if (!entry) {
+        entry = entry_create(cache, uri, size, error);
+        if (entry)
+            g_hash_table_insert(cache->entries, entry->uri, entry);
+    }
+
+    if (entry)
+        g_atomic_int_inc(&entry->ref_count);
+    g_mutex_unlock(&cache->lock);
+
+    return entry;
+}
+
+HttpCacheEntry *http_cache_entry_ref(HttpCacheEntry *entry) {
+    g_atomic_int_inc(&entry->ref_count);
+
+    return entry;
+}
+
+void http_cache_entry_unref(HttpCacheEntry *entry) {
+    if (g_atomic_int_dec_and_test(&entry->ref_count))
+        entry_free(entry);
+}
+
+guint64 http_cache_entry_get_size(HttpCacheEntry *entry) {
+    return entry->size;
+}
+
+static gboolean read_all(gint fd, guint8 *dest, gsize len, guint64 offset) {
+    while (len > 0) {
+        gssize n = pread(fd, dest, len, (off_t) offset);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return FALSE;
+        dest += n;
+        len -= n;
+        offset += n;
+    }
+
+    return TRUE;
+}
+
+static gboolean write_all(gint fd, const guint8 *data, gsize len, guint64 offset) {
+    while (len > 0) {
+        gssize n = pwrite(fd, data, len, (off_t) offset);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return FALSE;
+        data += n;
+        len -= n;
+        offset += n;
+    }
+
+    return TRUE;
+}
+
+/* Whether @block is cached, without counting a hit or a miss or touching
+ * the LRU order */
+gboolean http_cache_entry_contains(HttpCacheEntry *entry, guint block) {
+    HttpCache *cache = http_cache_get();
+    gboolean cached;
+
+    g_return_val_if_fail (block < entry->n_blocks, FALSE);
+
+    g_mutex_lock(&cache->lock);
+    cached = !entry->dropped && entry->blocks[block] != NULL;
+    g_mutex_unlock(&cache->lock);
+
+    return cached;
+}
+
+/* Copies @len bytes at @offset inside @block to @dest if the block is
+ * cached. Counts as a hit or a miss. */
+gboolean http_cache_entry_read(HttpCacheEntry *entry, guint block, gsize offset,
+                               guint8 *dest, gsize len) {
+    HttpCache *cache = http_cache_get();
+    gboolean hit;
+
+    g_return_val_if_fail (block < entry->n_blocks, FALSE);
+
+    g_mutex_lock(&cache->lock);
+    hit = !entry->dropped && entry->blocks[block] != NULL;
+    if (hit) {
+        GList *link = entry->blocks[block];
+
+        entry->pins[block]++;
+        g_queue_unlink(&cache->lru, link);
+        g_queue_push_tail_link(&cache->lru, link);
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+    g_mutex_unlock(&cache->lock);
+
+    if (!hit)
+        return FALSE;
+
+    /* The fd stays open while the caller holds the entry, even if it is
+     * dropped meanwhile */
+    if (!read_all(entry->fd, dest, len, (guint64) block * HTTP_CACHE_BLOCK_SIZE + offset)) {
+        GST_WARNING ("Cannot read cache file %s: %s", entry->path, g_strerror(errno));
+        hit = FALSE;
+    }
+
+    g_mutex_lock(&cache->lock);
+    entry->pins[block]--;
+    enforce_budget(cache);
+    g_mutex_unlock(&cache->lock);
+
+    return hit;
+}
+
+/* Stores a complete block fetched from the network */
+void http_cache_entry_store(HttpCacheEntry *entry, guint block, const guint8 *data, gsize len) {
+    HttpCache *cache = http_cache_get();
+    BlockRef *ref;
+    gboolean stored;
+
+    g_return_if_fail (block < entry->n_blocks);
+    g_return_if_fail (len == block_length(entry, block));
+
+    g_mutex_lock(&cache->lock);
+    if (entry->dropped || entry->blocks[block] || entry->storing[block] || len > cache->max_bytes) {
+        g_mutex_unlock(&cache->lock);
+        return;
+    }
+    entry->storing[block] = TRUE;
+    g_mutex_unlock(&cache->lock);
+
+    /* A full disk only costs the block, it is fetched again next time */
+    stored = write_all(entry->fd, data, len, (guint64) block * HTTP_CACHE_BLOCK_SIZE);
+    if (!stored)
+        GST_WARNING ("Cannot write cache file %s: %s", entry->path, g_strerror(errno));
+
+    g_mutex_lock(&cache->lock);
+    entry->storing[block] = FALSE;
+    if (stored && !entry->dropped) {
+        ref = g_new (BlockRef, 1);
+        ref->entry = entry;
+        ref->block = block;
+        g_queue_push_tail(&cache->lru, ref);
+        entry->blocks[block] = cache->lru.tail;
+        entry->n_cached++;
+        cache->cached_bytes += len;
+        enforce_budget(cache);
+    }
+    g_mutex_unlock(&cache->lock);
+}
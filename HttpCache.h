@@ -0,0 +1,37 @@
+#ifndef __PLAYER_HTTP_CACHE_H__
+#define __PLAYER_HTTP_CACHE_H__
+
+#include <gst/gst.h>
+#include "PlayerPrelude.h"
+
+G_BEGIN_DECLS
+
+/**
+ * PlayerHttpCacheStats:
+ * @hits: block reads served from the cache
+ * @misses: block reads that went to the network
+ * @hit_ratio: @hits / (@hits + @misses), 0.0 before the first read
+ * @cached_bytes: bytes currently held in the cache
+ * @max_bytes: cache budget in bytes
+ * @n_evictions: blocks evicted to stay within the budget
+ *
+ * Statistics of the process-wide HTTP block cache.
+ */
+typedef struct {
+    guint64 hits;
+    guint64 misses;
+    gdouble hit_ratio;
+    guint64 cached_bytes;
+    guint64 max_bytes;
+    guint64 n_evictions;
+} PlayerHttpCacheStats;
+
+GST_PLAYER_API
+void player_http_cache_configure (const gchar *directory, guint64 max_bytes);
+
+GST_PLAYER_API
+void player_http_cache_get_stats (PlayerHttpCacheStats *stats);
+
+G_END_DECLS
+
+#endif /* __PLAYER_HTTP_CACHE_H__ */
@@ -0,0 +1,24 @@
+#include "HttpCache.h"
+
+#ifndef __PLAYER_HTTP_CACHE_PRIVATE_H__
+#define __PLAYER_HTTP_CACHE_PRIVATE_H__
+
+G_BEGIN_DECLS
+
+#define HTTP_CACHE_BLOCK_SIZE (256 * 1024)
+
+typedef struct _HttpCacheEntry HttpCacheEntry;
+
+G_GNUC_INTERNAL HttpCacheEntry* http_cache_entry_open(const gchar *uri, guint64 size, GError **error);
+G_GNUC_INTERNAL HttpCacheEntry* http_cache_entry_ref(HttpCacheEntry *entry);
+G_GNUC_INTERNAL void            http_cache_entry_unref(HttpCacheEntry *entry);
+G_GNUC_INTERNAL guint64         http_cache_entry_get_size(HttpCacheEntry *entry);
+G_GNUC_INTERNAL gboolean        http_cache_entry_contains(HttpCacheEntry *entry, guint block);
+G_GNUC_INTERNAL gboolean        http_cache_entry_read(HttpCacheEntry *entry, guint block,
+                                                      gsize offset, guint8 *dest, gsize len);
+G_GNUC_INTERNAL void            http_cache_entry_store(HttpCacheEntry *entry, guint block,
+                                                       const guint8 *data, gsize len);
+
+G_END_DECLS
+
+#endif /* __PLAYER_HTTP_CACHE_PRIVATE_H__ */
@@ -0,0 +1,236 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "HttpClient.h"
+
+#include <libsoup/soup.h>
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (http_client_debug);
+#define GST_CAT_DEFAULT http_client_debug
+
+/* Same as the souphttpsrc defaults */
+#define DEFAULT_TIMEOUT 15
+#define DEFAULT_USER_AGENT "gstdemo"
+
+struct _HttpClient {
+    gint ref_count;
+    SoupSession *session;
+};
+
+HttpClient *http_client_new(const gchar *user_agent) {
+    static gsize initialized = 0;
+    HttpClient *client;
+    const gchar *proxy;
+
+    if (g_once_init_enter (&initialized)) {
+        GST_DEBUG_CATEGORY_INIT (http_client_debug, "player-http", 0, "Player HTTP client");
+        g_once_init_leave (&initialized, 1);
+    }
+
+    client = g_new0 (HttpClient, 1);
+    client->ref_count = 1;
+
+    /* Set up like souphttpsrc sets up its session, so the cache and the
+     * mirror probes reach the same servers as playback: proxy from
+     * $http_proxy or the system, a cookie jar and strict TLS with the
+     * default database */
+    client->session = soup_session_new_with_options("user-agent",
+                                                    user_agent ? user_agent : DEFAULT_USER_AGENT,
+                                                    "timeout", DEFAULT_TIMEOUT, NULL);
+    proxy = g_getenv("http_proxy");
+    if (proxy && *proxy) {
+        GProxyResolver *resolver;
+        gchar *proxy_uri;
+
+        proxy_uri = strstr(proxy, "://") ? g_strdup(proxy) : g_strconcat("http://", proxy, NULL);
+        resolver = g_simple_proxy_resolver_new(proxy_uri, NULL);
+        soup_session_set_proxy_resolver(client->session, resolver);
+        g_object_unref(resolver);
+        g_free(proxy_uri);
+    }
+    soup_session_add_feature_by_type(client->session, SOUP_TYPE_COOKIE_JAR);
+
+    return client;
+}
+
+/* Returns a new reference to the process-wide client for @user_agent, so
+ * keep-alive connections are reused across sources, playlist items and
+ * players talking to the same host */
+HttpClient *http_client_get_shared(const gchar *user_agent) {
+    static GMutex lock;
+    static GHashTable *clients = NULL;
+    HttpClient *client;
+
+    if (!user_agent)
+        user_agent = DEFAULT_USER_AGENT;
+
+    g_mutex_lock(&lock);
+    if (!clients)
+        clients = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                        (GDestroyNotify) http_client_unref);
+
+    client = g_hash_table_lookup(clients, user_agent);
+    if (!client) {
+        client = http_client_new(user_agent);
+        g_hash_table_insert(clients, g_strdup(user_agent), client);
+    }
+    http_client_ref(client);
+    g_mutex_unlock(&lock);
+
+    return client;
+}
+
+HttpClient *http_client_ref(HttpClient *client) {
+    g_atomic_int_inc(&client->ref_count);
+
+    return client;
+}
+
+void http_client_unref(HttpClient *client) {
+    if (!g_atomic_int_dec_and_test(&client->ref_count))
+        return;
+
+    g_object_unref(client->session);
+    g_free(client);
+}
+
+void http_response_free(HttpResponse *response) {
+    g_free(response->final_uri);
+    if (response->body)
+        g_bytes_unref(response->body);
+    g_free(response);
+}
+
+/* Credentials from the URI, or for the proxy from $http_proxy, as
+ * souphttpsrc takes them */
+static gboolean authenticate_cb(SoupMessage *msg, SoupAuth *auth, gboolean retrying,
+                                G_GNUC_UNUSED gpointer user_data) {
+    GUri *uri = NULL;
+    gboolean handled = FALSE;
+
+    if (retrying)
+        return FALSE;
+
+    if (soup_auth_is_for_proxy(auth)) {
+        const gchar *proxy = g_getenv("http_proxy");
+
+        if (proxy)
+            uri = g_uri_parse(proxy, G_URI_FLAGS_HAS_PASSWORD, NULL);
+    } else {
+        uri = g_uri_ref(soup_message_get_uri(msg));
+    }
+
+    if (uri && g_uri_get_user(uri) && g_uri_get_password(uri)) {
+        soup_auth_authenticate(auth, g_uri_get_user(uri), g_uri_get_password(uri));
+        handled = TRUE;
+    }
+    if (uri)
+        g_uri_unref(uri);
+
+    return handled;
+}
+
+/* Reads up to @want bytes after skipping @skip bytes of the body into
+ * @out. A body ending early is reported by libsoup as an error. */
+static gboolean read_body(GInputStream *in, guint64 skip, guint64 want, GByteArray *out,
+                          GCancellable *cancellable, GError **error) {
+    guint8 buf[16384];
+
+    while (out->len < want) {
+        gssize n = g_input_stream_read(in, buf, sizeof(buf), cancellable, error);
+
+        if (n < 0)
+            return FALSE;
+        if (n == 0)
+            break;
+
+        if (skip >= (guint64) n) {
+            skip -= n;
+        } else {
+            g_byte_array_append(out, buf + skip, MIN ((guint64) n - skip, want - out->len));
+            skip = 0;
+        }
+    }
+
+    return TRUE;
+}
+
+/* Fetches @length bytes of @uri starting at @offset, G_MAXUINT64 for
+ * everything up to the end. Redirects are followed. Servers ignoring the
+ * Range header are handled by skipping to @offset. */
+HttpResponse *http_client_get_range(HttpClient *client, const gchar *uri,
+                                    guint64 offset, guint64 length,
+                                    GCancellable *cancellable, GError **error) {
+    SoupMessage *msg;
+    SoupMessageHeaders *headers;
+    HttpResponse *response;
+    GInputStream *in;
+    GByteArray *body;
+    goffset start, end, total;
+    guint64 skip = 0;
+    guint status;
+
+    msg = soup_message_new("GET", uri);
+    if (!msg) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid URI %s", uri);
+        return NULL;
+    }
+
+    headers = soup_message_get_request_headers(msg);
+    soup_message_headers_set_range(headers, (goffset) offset,
+                                   length == G_MAXUINT64 ? -1 : (goffset) (offset + length - 1));
+    soup_message_headers_replace(headers, "Accept-Encoding", "identity");
+    g_signal_connect (msg, "authenticate", G_CALLBACK(authenticate_cb), NULL);
+
+    in = soup_session_send(client->session, msg, cancellable, error);
+    if (!in) {
+        g_object_unref(msg);
+        return NULL;
+    }
+
+    status = soup_message_get_status(msg);
+    if (status != SOUP_STATUS_OK && status != SOUP_STATUS_PARTIAL_CONTENT) {
+        g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "HTTP error %u for %s", status, uri);
+        g_input_stream_close(in, NULL, NULL);
+        g_object_unref(in);
+        g_object_unref(msg);
+        return NULL;
+    }
+
+    headers = soup_message_get_response_headers(msg);
+    response = g_new0 (HttpResponse, 1);
+    response->status = status;
+    response->final_uri = g_uri_to_string(soup_message_get_uri(msg));
+    response->total_size = G_MAXUINT64;
+    if (status == SOUP_STATUS_PARTIAL_CONTENT) {
+        if (soup_message_headers_get_content_range(headers, &start, &end, &total)) {
+            response->offset = (guint64) start;
+            if (total >= 0)
+                response->total_size = (guint64) total;
+        }
+    } else {
+        skip = offset;
+        response->offset = offset;
+        if (soup_message_headers_get_encoding(headers) == SOUP_ENCODING_CONTENT_LENGTH)
+            response->total_size = (guint64) soup_message_headers_get_content_length(headers);
+    }
+
+    body = g_byte_array_new();
+    if (!read_body(in, skip, length, body, cancellable, error)) {
+        g_byte_array_unref(body);
+        http_response_free(response);
+        response = NULL;
+    } else {
+        response->body = g_byte_array_free_to_bytes(body);
+    }
+
+    /* Closing before the end of the body drops the connection instead of
+     * returning it to the pool */
+    g_input_stream_close(in, NULL, NULL);
+    g_object_unref(in);
+    g_object_unref(msg);
+
+    return response;
+}
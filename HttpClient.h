@@ -0,0 +1,35 @@
+#ifndef __PLAYER_HTTP_CLIENT_H__
+#define __PLAYER_HTTP_CLIENT_H__
+
+#include <gio/gio.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Blocking client for range requests on a libsoup session set up like the
+ * one of souphttpsrc. Connections are kept alive and reused per host, and
+ * redirects are followed. Safe to use from several threads at once.
+ */
+typedef struct _HttpClient HttpClient;
+
+typedef struct {
+    guint status;
+    gchar *final_uri;        /* URI after redirects */
+    guint64 offset;          /* Resource offset of the first body byte */
+    guint64 total_size;      /* Resource size, G_MAXUINT64 if unknown */
+    GBytes *body;
+} HttpResponse;
+
+G_GNUC_INTERNAL HttpClient*   http_client_new(const gchar *user_agent);
+G_GNUC_INTERNAL HttpClient*   http_client_get_shared(const gchar *user_agent);
+G_GNUC_INTERNAL HttpClient*   http_client_ref(HttpClient *client);
+G_GNUC_INTERNAL void          http_client_unref(HttpClient *client);
+G_GNUC_INTERNAL HttpResponse* http_client_get_range(HttpClient *client, const gchar *uri,
+                                                    guint64 offset, guint64 length,
+                                                    GCancellable *cancellable, GError **error);
+G_GNUC_INTERNAL void          http_response_free(HttpResponse *response);
+
+G_END_DECLS
+
+#endif /* __PLAYER_HTTP_CLIENT_H__ */
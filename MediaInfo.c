@@ -4,6 +4,9 @@
 
 #include "MediaInfo.h"
 #include "MediaInfoPrivate.h"
+#include "ArtworkPrivate.h"
+
+#include <string.h>
 
 /* Per-stream information */
 G_DEFINE_ABSTRACT_TYPE (PlayerStreamInfo, player_stream_info,
@@ -209,6 +212,12 @@ static void player_media_info_finalize(GObject *object) {
 
     g_free(info->container);
 
+    if (info->fingerprint)
+        player_fingerprint_unref(info->fingerprint);
+
+    if (info->artwork)
+        player_artwork_free(info->artwork);
+
     if (info->audio_stream_list)
         g_list_free(info->audio_stream_list);
 
@@ -260,7 +269,7 @@ PlayerStreamInfo *player_stream_info_copy(PlayerStreamInfo *ref) {
     if (ref->tags)
         info->tags = gst_tag_list_ref(ref->tags);
     if (ref->caps)
-        info->caps = gst_caps_copy (ref->caps);
+        info->caps = gst_caps_ref(ref->caps);
 //  if (ref->codec)
 //    info->codec = g_strdup (ref->codec);
     if (ref->stream_id)
@@ -280,10 +289,15 @@ PlayerMediaInfo *player_media_info_copy(PlayerMediaInfo *ref) {
     info->duration = ref->duration;
     info->seekable = ref->seekable;
     info->is_live = ref->is_live;
+    info->version = ref->version;
     if (ref->title)
         info->title = g_strdup(ref->title);
     if (ref->container)
         info->container = g_strdup(ref->container);
+    if (ref->fingerprint)
+        info->fingerprint = player_fingerprint_ref(ref->fingerprint);
+    if (ref->artwork)
+        info->artwork = player_artwork_copy(ref->artwork);
 
     for (l = ref->stream_list; l != NULL; l = l->next) {
         PlayerStreamInfo *s;
@@ -396,6 +410,48 @@ GstClockTime player_media_info_get_duration(const PlayerMediaInfo *info) {
     return info->duration;
 }
 
+/**
+ * player_media_info_get_fingerprint:
+ * @info: a #PlayerMediaInfo
+ *
+ * Returns: (transfer none) (nullable): the acoustic fingerprint of the
+ * stream, only available after end-of-stream with fingerprinting enabled.
+ */
+PlayerFingerprint *player_media_info_get_fingerprint(const PlayerMediaInfo *info) {
+    g_return_val_if_fail (GST_IS_PLAYER_MEDIA_INFO(info), NULL);
+
+    return info->fingerprint;
+}
+
+/**
+ * player_media_info_get_version:
+ * @info: a #PlayerMediaInfo
+ *
+ * Returns: the version of this snapshot, to match against the
+ * #PlayerMediaInfoDiff of the "media-info-changed" signal
+ */
+guint64 player_media_info_get_version(const PlayerMediaInfo *info) {
+    g_return_val_if_fail (GST_IS_PLAYER_MEDIA_INFO(info), 0);
+
+    return info->version;
+}
+
+/**
+ * player_media_info_get_artwork:
+ * @info: a #PlayerMediaInfo
+ *
+ * Embedded images are not kept in the tags of the media info. This
+ * describes the first one found, use player_artwork_load() to get the
+ * image itself.
+ *
+ * Returns: (transfer none) (nullable): the cover art of the media
+ */
+PlayerArtwork *player_media_info_get_artwork(const PlayerMediaInfo *info) {
+    g_return_val_if_fail (GST_IS_PLAYER_MEDIA_INFO(info), NULL);
+
+    return info->artwork;
+}
+
 /**
  * player_media_info_get_title:
  * @info: a #PlayerMediaInfo
@@ -462,3 +518,99 @@ GList *player_get_audio_streams(const PlayerMediaInfo *info) {
 #endif
 
 
+
+/* Memory estimates. They count what the values reference, buffers of
+ * samples in particular, plus a rough per-value overhead; allocator
+ * slack is not accounted for. */
+
+static gsize value_estimate_size(const GValue *value) {
+    gsize size = sizeof(GValue);
+
+    if (G_VALUE_HOLDS_STRING (value)) {
+        const gchar *str = g_value_get_string(value);
+
+        if (str)
+            size += strlen(str) + 1;
+    } else if (G_VALUE_TYPE (value) == GST_TYPE_SAMPLE) {
+        GstSample *sample = g_value_get_boxed(value);
+        GstBuffer *buffer = sample ? gst_sample_get_buffer(sample) : NULL;
+
+        if (buffer)
+            size += gst_buffer_get_size(buffer);
+        if (sample && gst_sample_get_caps(sample))
+            size += player_caps_estimate_size(gst_sample_get_caps(sample));
+    } else if (G_VALUE_TYPE (value) == GST_TYPE_BUFFER) {
+        GstBuffer *buffer = g_value_get_boxed(value);
+
+        if (buffer)
+            size += gst_buffer_get_size(buffer);
+    }
+
+    return size;
+}
+
+gsize player_tag_list_estimate_size(const GstTagList *tags) {
+    gsize size = 0;
+    gint i, n;
+
+    if (!tags)
+        return 0;
+
+    n = gst_tag_list_n_tags(tags);
+    for (i = 0; i < n; i++) {
+        const gchar *tag = gst_tag_list_nth_tag_name(tags, i);
+        guint j, n_values = gst_tag_list_get_tag_size(tags, tag);
+
+        for (j = 0; j < n_values; j++)
+            size += value_estimate_size(gst_tag_list_get_value_index(tags, tag, j));
+    }
+
+    return size;
+}
+
+gsize player_caps_estimate_size(const GstCaps *caps) {
+    gsize size = 0;
+    guint i, n;
+
+    if (!caps)
+        return 0;
+
+    n = gst_caps_get_size(caps);
+    for (i = 0; i < n; i++) {
+        const GstStructure *s = gst_caps_get_structure(caps, i);
+        gint j, n_fields = gst_structure_n_fields(s);
+
+        for (j = 0; j < n_fields; j++)
+            size += value_estimate_size(gst_structure_get_value(s, gst_structure_nth_field_name(s, j)));
+    }
+
+    return size;
+}
+
+gsize player_media_info_estimate_size(const PlayerMediaInfo *info) {
+    gsize size;
+    GList *l;
+
+    if (!info)
+        return 0;
+
+    size = sizeof(PlayerMediaInfo);
+    if (info->uri)
+        size += strlen(info->uri) + 1;
+    if (info->title)
+        size += strlen(info->title) + 1;
+    if (info->container)
+        size += strlen(info->container) + 1;
+    if (info->artwork)
+        size += sizeof(PlayerArtwork) + strlen(info->artwork->hash) + 1;
+
+    for (l = info->stream_list; l != NULL; l = l->next) {
+        PlayerStreamInfo *stream = l->data;
+
+        size += sizeof(PlayerAudioInfo);
+        size += player_tag_list_estimate_size(stream->tags);
+        size += player_caps_estimate_size(stream->caps);
+    }
+
+    return size;
+}
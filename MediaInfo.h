@@ -3,6 +3,8 @@
 
 #include <gst/gst.h>
 #include "PlayerPrelude.h"
+#include "Fingerprint.h"
+#include "Artwork.h"
 
 G_BEGIN_DECLS
 
@@ -113,6 +115,15 @@ gboolean      player_media_info_is_live (const PlayerMediaInfo *info);
 GST_PLAYER_API
 GstClockTime  player_media_info_get_duration (const PlayerMediaInfo *info);
 
+GST_PLAYER_API
+PlayerFingerprint * player_media_info_get_fingerprint (const PlayerMediaInfo *info);
+
+GST_PLAYER_API
+PlayerArtwork * player_media_info_get_artwork (const PlayerMediaInfo *info);
+
+GST_PLAYER_API
+guint64       player_media_info_get_version (const PlayerMediaInfo *info);
+
 GST_PLAYER_API
 GList*        player_media_info_get_stream_list (const PlayerMediaInfo *info);
 
@@ -0,0 +1,375 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "MediaInfoDiff.h"
+#include "MediaInfoDiffPrivate.h"
+#include "MediaInfoPrivate.h"
+#include "ArtworkPrivate.h"
+
+#include <string.h>
+
+struct _PlayerMediaInfoDiff {
+    gint ref_count;
+
+    guint64 version;
+    guint64 base_version;
+    PlayerMediaInfoFields fields;
+
+    /* Current values, whether changed or not */
+    gchar *title;
+    gchar *container;
+    GstClockTime duration;
+    gboolean seekable;
+    gboolean is_live;
+    PlayerFingerprint *fingerprint;
+    PlayerArtwork *artwork;
+
+    GArray *stream_changes;   /* PlayerStreamChange */
+};
+
+G_DEFINE_BOXED_TYPE (PlayerMediaInfoDiff, player_media_info_diff,
+                     player_media_info_diff_ref, player_media_info_diff_unref);
+
+static void stream_change_clear(PlayerStreamChange *change) {
+    if (change->tags)
+        gst_tag_list_unref(change->tags);
+    g_strfreev(change->removed_tags);
+    if (change->caps)
+        gst_caps_unref(change->caps);
+}
+
+static gboolean tag_values_equal(const GstTagList *a, const GstTagList *b, const gchar *tag) {
+    guint i, n = gst_tag_list_get_tag_size(a, tag);
+
+    if (gst_tag_list_get_tag_size(b, tag) != n)
+        return FALSE;
+
+    for (i = 0; i < n; i++) {
+        if (gst_value_compare(gst_tag_list_get_value_index(a, tag, i),
+                              gst_tag_list_get_value_index(b, tag, i)) != GST_VALUE_EQUAL)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* Fills in the tags of @change that differ between @base and @tags,
+ * either may be NULL. Returns whether any did. */
+static gboolean diff_tags(const GstTagList *base, const GstTagList *tags,
+                          PlayerStreamChange *change) {
+    GPtrArray *removed;
+    gint i, j, n;
+
+    /* Interned tag lists are usually identical by pointer */
+    if (base == tags)
+        return FALSE;
+
+    n = tags ? gst_tag_list_n_tags(tags) : 0;
+    for (i = 0; i < n; i++) {
+        const gchar *name = gst_tag_list_nth_tag_name(tags, i);
+        guint n_values;
+
+        if (base && tag_values_equal(base, tags, name))
+            continue;
+
+        if (!change->tags) {
+            change->tags = gst_tag_list_new_empty();
+            gst_tag_list_set_scope(change->tags, gst_tag_list_get_scope(tags));
+        }
+        n_values = gst_tag_list_get_tag_size(tags, name);
+        for (j = 0; j < (gint) n_values; j++)
+            gst_tag_list_add_value(change->tags, GST_TAG_MERGE_APPEND, name,
+                                   gst_tag_list_get_value_index(tags, name, j));
+    }
+
+    n = base ? gst_tag_list_n_tags(base) : 0;
+    removed = g_ptr_array_new();
+    for (i = 0; i < n; i++) {
+        const gchar *name = gst_tag_list_nth_tag_name(base, i);
+
+        if (!tags || gst_tag_list_get_tag_size(tags, name) == 0)
+            g_ptr_array_add(removed, g_strdup(name));
+    }
+    if (removed->len > 0) {
+        g_ptr_array_add(removed, NULL);
+        change->removed_tags = (gchar **) g_ptr_array_free(removed, FALSE);
+    } else {
+        g_ptr_array_free(removed, TRUE);
+    }
+
+    return change->tags != NULL || change->removed_tags != NULL;
+}
+
+static PlayerStreamInfo *find_stream(const PlayerMediaInfo *info, gint stream_index) {
+    GList *l;
+
+    for (l = info->stream_list; l != NULL; l = l->next) {
+        PlayerStreamInfo *s = l->data;
+
+        if (s->stream_index == stream_index)
+            return s;
+    }
+
+    return NULL;
+}
+
+static void diff_streams(PlayerMediaInfoDiff *diff, const PlayerMediaInfo *base,
+                         const PlayerMediaInfo *info) {
+    PlayerStreamChange change;
+    GList *l;
+
+    for (l = info->stream_list; l != NULL; l = l->next) {
+        PlayerStreamInfo *s = l->data;
+        PlayerStreamInfo *b = base ? find_stream(base, s->stream_index) : NULL;
+
+        memset(&change, 0, sizeof(change));
+        change.stream_index = s->stream_index;
+        if (!b)
+            change.flags |= PLAYER_STREAM_CHANGE_ADDED;
+        if (diff_tags(b ? b->tags : NULL, s->tags, &change))
+            change.flags |= PLAYER_STREAM_CHANGE_TAGS;
+        if (b ? !(b->caps == s->caps || (b->caps && s->caps && gst_caps_is_strictly_equal(b->caps, s->caps)))
+              : s->caps != NULL) {
+            change.flags |= PLAYER_STREAM_CHANGE_CAPS;
+            if (s->caps)
+                change.caps = gst_caps_ref(s->caps);
+        }
+
+        if (change.flags)
+            g_array_append_val(diff->stream_changes, change);
+    }
+
+    for (l = base ? base->stream_list : NULL; l != NULL; l = l->next) {
+        PlayerStreamInfo *b = l->data;
+
+        if (find_stream(info, b->stream_index))
+            continue;
+        memset(&change, 0, sizeof(change));
+        change.stream_index = b->stream_index;
+        change.flags = PLAYER_STREAM_CHANGE_REMOVED;
+        g_array_append_val(diff->stream_changes, change);
+    }
+}
+
+/* Returns the changes from @base to @info, or NULL if there are none. With
+ * @base NULL or for another URI everything is reported as changed, and
+ * the diff applies to an empty media info. */
+PlayerMediaInfoDiff *player_media_info_diff_new(const PlayerMediaInfo *base,
+                                                const PlayerMediaInfo *info) {
+    PlayerMediaInfoDiff *diff;
+
+    g_return_val_if_fail (info != NULL, NULL);
+
+    if (base && g_strcmp0(base->uri, info->uri) != 0)
+        base = NULL;
+
+    diff = g_new0 (PlayerMediaInfoDiff, 1);
+    diff->ref_count = 1;
+    diff->version = info->version;
+    diff->base_version = base ? base->version : 0;
+    diff->stream_changes = g_array_new(FALSE, TRUE, sizeof(PlayerStreamChange));
+    g_array_set_clear_func(diff->stream_changes, (GDestroyNotify) stream_change_clear);
+
+    if (!base || g_strcmp0(base->title, info->title) != 0)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_TITLE;
+    if (!base || g_strcmp0(base->container, info->container) != 0)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_CONTAINER;
+    if (!base || base->duration != info->duration)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_DURATION;
+    if (!base || base->seekable != info->seekable || base->is_live != info->is_live)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_SEEKABLE;
+    if (base ? base->fingerprint != info->fingerprint : info->fingerprint != NULL)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_FINGERPRINT;
+    if (base ? !player_artwork_equal(base->artwork, info->artwork) : info->artwork != NULL)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_ARTWORK;
+
+    diff_streams(diff, base, info);
+    if (diff->stream_changes->len > 0)
+        diff->fields |= PLAYER_MEDIA_INFO_FIELD_STREAMS;
+
+    if (diff->fields == 0) {
+        player_media_info_diff_unref(diff);
+        return NULL;
+    }
+
+    diff->title = g_strdup(info->title);
+    diff->container = g_strdup(info->container);
+    diff->duration = info->duration;
+    diff->seekable = info->seekable;
+    diff->is_live = info->is_live;
+    if (info->fingerprint)
+        diff->fingerprint = player_fingerprint_ref(info->fingerprint);
+    if (info->artwork)
+        diff->artwork = player_artwork_copy(info->artwork);
+
+    return diff;
+}
+
+PlayerMediaInfoDiff *player_media_info_diff_ref(PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, NULL);
+
+    g_atomic_int_inc(&diff->ref_count);
+
+    return diff;
+}
+
+void player_media_info_diff_unref(PlayerMediaInfoDiff *diff) {
+    g_return_if_fail (diff != NULL);
+
+    if (g_atomic_int_dec_and_test(&diff->ref_count)) {
+        g_free(diff->title);
+        g_free(diff->container);
+        if (diff->fingerprint)
+            player_fingerprint_unref(diff->fingerprint);
+        if (diff->artwork)
+            player_artwork_free(diff->artwork);
+        g_array_unref(diff->stream_changes);
+        g_free(diff);
+    }
+}
+
+/**
+ * player_media_info_diff_get_version:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: the version of the media information after applying @diff, as
+ * returned by player_media_info_get_version(). Versions increase but are
+ * not contiguous.
+ */
+guint64 player_media_info_diff_get_version(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, 0);
+
+    return diff->version;
+}
+
+/**
+ * player_media_info_diff_get_base_version:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * A client holding another version than this missed a change and should
+ * start over from player_get_media_info().
+ *
+ * Returns: the version @diff applies to, 0 if it describes new media and
+ * applies to nothing
+ */
+guint64 player_media_info_diff_get_base_version(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, 0);
+
+    return diff->base_version;
+}
+
+/**
+ * player_media_info_diff_get_fields:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: the parts of the media information that changed
+ */
+PlayerMediaInfoFields player_media_info_diff_get_fields(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, 0);
+
+    return diff->fields;
+}
+
+/**
+ * player_media_info_diff_get_title:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: (nullable): the current title
+ */
+const gchar *player_media_info_diff_get_title(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, NULL);
+
+    return diff->title;
+}
+
+/**
+ * player_media_info_diff_get_container_format:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: (nullable): the current container format
+ */
+const gchar *player_media_info_diff_get_container_format(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, NULL);
+
+    return diff->container;
+}
+
+/**
+ * player_media_info_diff_get_duration:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: the current duration
+ */
+GstClockTime player_media_info_diff_get_duration(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, GST_CLOCK_TIME_NONE);
+
+    return diff->duration;
+}
+
+/**
+ * player_media_info_diff_is_seekable:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: whether the media is currently seekable
+ */
+gboolean player_media_info_diff_is_seekable(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, FALSE);
+
+    return diff->seekable;
+}
+
+/**
+ * player_media_info_diff_is_live:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: whether the media is live
+ */
+gboolean player_media_info_diff_is_live(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, FALSE);
+
+    return diff->is_live;
+}
+
+/**
+ * player_media_info_diff_get_fingerprint:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: (transfer none) (nullable): the current fingerprint
+ */
+PlayerFingerprint *player_media_info_diff_get_fingerprint(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, NULL);
+
+    return diff->fingerprint;
+}
+
+/**
+ * player_media_info_diff_get_artwork:
+ * @diff: a #PlayerMediaInfoDiff
+ *
+ * Returns: (transfer none) (nullable): the current artwork
+ */
+PlayerArtwork *player_media_info_diff_get_artwork(const PlayerMediaInfoDiff *diff) {
+    g_return_val_if_fail (diff != NULL, NULL);
+
+    return diff->artwork;
+}
+
+/**
+ * player_media_info_diff_get_stream_changes:
+ * @diff: a #PlayerMediaInfoDiff
+ * @n_changes: (out): return location for the number of changes
+ *
+ * Returns: (transfer none) (array length=n_changes) (nullable): the
+ * changed streams, only the ones that changed are listed
+ */
+const PlayerStreamChange *player_media_info_diff_get_stream_changes(const PlayerMediaInfoDiff *diff,
+                                                                   guint *n_changes) {
+    g_return_val_if_fail (diff != NULL, NULL);
+    g_return_val_if_fail (n_changes != NULL, NULL);
+
+    *n_changes = diff->stream_changes->len;
+
+    return diff->stream_changes->len > 0
+           ? &g_array_index (diff->stream_changes, PlayerStreamChange, 0) : NULL;
+}
@@ -0,0 +1,121 @@
+#ifndef __PLAYER_MEDIA_INFO_DIFF_H__
+#define __PLAYER_MEDIA_INFO_DIFF_H__
+
+#include <gst/gst.h>
+#include "PlayerPrelude.h"
+#include "MediaInfo.h"
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_PLAYER_MEDIA_INFO_DIFF (player_media_info_diff_get_type ())
+
+/**
+ * PlayerMediaInfoFields:
+ * @PLAYER_MEDIA_INFO_FIELD_TITLE: the title changed
+ * @PLAYER_MEDIA_INFO_FIELD_CONTAINER: the container format changed
+ * @PLAYER_MEDIA_INFO_FIELD_DURATION: the duration changed
+ * @PLAYER_MEDIA_INFO_FIELD_SEEKABLE: seekability or liveness changed
+ * @PLAYER_MEDIA_INFO_FIELD_FINGERPRINT: a fingerprint became available
+ * @PLAYER_MEDIA_INFO_FIELD_ARTWORK: the artwork changed
+ * @PLAYER_MEDIA_INFO_FIELD_STREAMS: streams were added, removed or changed,
+ * see player_media_info_diff_get_stream_changes()
+ *
+ * Parts of a #PlayerMediaInfo changed by a #PlayerMediaInfoDiff.
+ */
+typedef enum {
+    PLAYER_MEDIA_INFO_FIELD_TITLE = (1 << 0),
+    PLAYER_MEDIA_INFO_FIELD_CONTAINER = (1 << 1),
+    PLAYER_MEDIA_INFO_FIELD_DURATION = (1 << 2),
+    PLAYER_MEDIA_INFO_FIELD_SEEKABLE = (1 << 3),
+    PLAYER_MEDIA_INFO_FIELD_FINGERPRINT = (1 << 4),
+    PLAYER_MEDIA_INFO_FIELD_ARTWORK = (1 << 5),
+    PLAYER_MEDIA_INFO_FIELD_STREAMS = (1 << 6),
+} PlayerMediaInfoFields;
+
+/**
+ * PlayerStreamChangeFlags:
+ * @PLAYER_STREAM_CHANGE_ADDED: the stream is new, all its tags are listed
+ * @PLAYER_STREAM_CHANGE_REMOVED: the stream is gone
+ * @PLAYER_STREAM_CHANGE_TAGS: tags were added, changed or removed
+ * @PLAYER_STREAM_CHANGE_CAPS: the caps changed
+ */
+typedef enum {
+    PLAYER_STREAM_CHANGE_ADDED = (1 << 0),
+    PLAYER_STREAM_CHANGE_REMOVED = (1 << 1),
+    PLAYER_STREAM_CHANGE_TAGS = (1 << 2),
+    PLAYER_STREAM_CHANGE_CAPS = (1 << 3),
+} PlayerStreamChangeFlags;
+
+/**
+ * PlayerStreamChange:
+ * @stream_index: index of the stream, as in player_stream_info_get_index()
+ * @flags: what changed
+ * @tags: (nullable): tags that were added or changed, with all their
+ * new values
+ * @removed_tags: (nullable): names of the tags that were removed
+ * @caps: (nullable): the new caps if they changed
+ *
+ * Change of a single stream in a #PlayerMediaInfoDiff.
+ */
+typedef struct {
+    gint stream_index;
+    PlayerStreamChangeFlags flags;
+    GstTagList *tags;
+    gchar **removed_tags;
+    GstCaps *caps;
+} PlayerStreamChange;
+
+/**
+ * PlayerMediaInfoDiff:
+ *
+ * Changes between two versions of the media information of a player.
+ * Immutable and reference counted.
+ */
+typedef struct _PlayerMediaInfoDiff PlayerMediaInfoDiff;
+
+GST_PLAYER_API
+GType                   player_media_info_diff_get_type (void);
+
+GST_PLAYER_API
+PlayerMediaInfoDiff *   player_media_info_diff_ref (PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+void                    player_media_info_diff_unref (PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+guint64                 player_media_info_diff_get_version (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+guint64                 player_media_info_diff_get_base_version (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+PlayerMediaInfoFields   player_media_info_diff_get_fields (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+const gchar *           player_media_info_diff_get_title (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+const gchar *           player_media_info_diff_get_container_format (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+GstClockTime            player_media_info_diff_get_duration (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+gboolean                player_media_info_diff_is_seekable (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+gboolean                player_media_info_diff_is_live (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+PlayerFingerprint *     player_media_info_diff_get_fingerprint (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+PlayerArtwork *         player_media_info_diff_get_artwork (const PlayerMediaInfoDiff *diff);
+
+GST_PLAYER_API
+const PlayerStreamChange * player_media_info_diff_get_stream_changes (const PlayerMediaInfoDiff *diff,
+                                                                      guint *n_changes);
+
+G_END_DECLS
+
+#endif /* __PLAYER_MEDIA_INFO_DIFF_H__ */
@@ -0,0 +1,9 @@
+#include "MediaInfoDiff.h"
+
+#ifndef __PLAYER_MEDIA_INFO_DIFF_PRIVATE_H__
+#define __PLAYER_MEDIA_INFO_DIFF_PRIVATE_H__
+
+G_GNUC_INTERNAL PlayerMediaInfoDiff*  player_media_info_diff_new(const PlayerMediaInfo *base,
+                                                                 const PlayerMediaInfo *info);
+
+#endif /* __PLAYER_MEDIA_INFO_DIFF_PRIVATE_H__ */
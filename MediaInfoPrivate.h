@@ -53,6 +53,11 @@ struct _PlayerMediaInfo
   GList *audio_stream_list;
 
   GstClockTime  duration;
+
+  PlayerFingerprint *fingerprint;
+  PlayerArtwork *artwork;
+
+  guint64 version;
 };
 
 struct _PlayerMediaInfoClass
@@ -65,4 +70,8 @@ G_GNUC_INTERNAL PlayerMediaInfo*   player_media_info_copy(PlayerMediaInfo *ref);
 G_GNUC_INTERNAL PlayerStreamInfo*  player_stream_info_new(gint stream_index, GType type);
 G_GNUC_INTERNAL PlayerStreamInfo*  player_stream_info_copy(PlayerStreamInfo *ref);
 
+G_GNUC_INTERNAL gsize              player_tag_list_estimate_size(const GstTagList *tags);
+G_GNUC_INTERNAL gsize              player_caps_estimate_size(const GstCaps *caps);
+G_GNUC_INTERNAL gsize              player_media_info_estimate_size(const PlayerMediaInfo *info);
+
 #endif /* __MEDIA_INFO_PRIVATE_H__ */
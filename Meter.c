@@ -0,0 +1,180 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Meter.h"
+#include "MeterPrivate.h"
+
+#include <string.h>
+
+G_DEFINE_BOXED_TYPE (PlayerMeter, player_meter, player_meter_copy, player_meter_free);
+
+PlayerMeter *player_meter_new(void) {
+    PlayerMeter *meter = g_new0 (PlayerMeter, 1);
+
+    meter->timestamp = GST_CLOCK_TIME_NONE;
+
+    return meter;
+}
+
+PlayerMeter *player_meter_copy(const PlayerMeter *meter) {
+    PlayerMeter *ret;
+
+    g_return_val_if_fail (meter != NULL, NULL);
+
+    ret = g_new (PlayerMeter, 1);
+    *ret = *meter;
+    if (meter->bands)
+        ret->bands = g_memdup2(meter->bands, meter->n_bands * sizeof(gfloat));
+
+    return ret;
+}
+
+void player_meter_free(PlayerMeter *meter) {
+    g_return_if_fail (meter != NULL);
+
+    g_free(meter->bands);
+    g_free(meter);
+}
+
+/* Reads the per-channel doubles of a level message field, which is a
+ * GValueArray for historical reasons */
+static guint read_level_values(const GstStructure *s, const gchar *field,
+                               gdouble *values) {
+    const GValue *value;
+    GValueArray *array;
+    guint i, n;
+
+    value = gst_structure_get_value(s, field);
+    if (!value || !G_VALUE_HOLDS (value, G_TYPE_VALUE_ARRAY))
+        return 0;
+
+    G_GNUC_BEGIN_IGNORE_DEPRECATIONS
+    array = g_value_get_boxed(value);
+    n = MIN (array->n_values, PLAYER_METER_MAX_CHANNELS);
+    for (i = 0; i < n; i++)
+        values[i] = g_value_get_double(g_value_array_get_nth(array, i));
+    G_GNUC_END_IGNORE_DEPRECATIONS
+
+    return n;
+}
+
+/* Updates @meter from a "level" element message */
+gboolean player_meter_update_level(PlayerMeter *meter, const GstStructure *s) {
+    guint n_peak, n_rms;
+    GstClockTime timestamp;
+
+    n_peak = read_level_values(s, "peak", meter->peak);
+    n_rms = read_level_values(s, "rms", meter->rms);
+    if (n_peak == 0 || n_peak != n_rms)
+        return FALSE;
+
+    meter->n_channels = n_peak;
+    if (gst_structure_get_clock_time(s, "stream-time", &timestamp))
+        meter->timestamp = timestamp;
+
+    return TRUE;
+}
+
+/* Updates @meter from a "spectrum" element message */
+gboolean player_meter_update_spectrum(PlayerMeter *meter, const GstStructure *s) {
+    const GValue *magnitude;
+    gboolean is_list;
+    guint i, n;
+
+    magnitude = gst_structure_get_value(s, "magnitude");
+    if (!magnitude)
+        return FALSE;
+
+    is_list = GST_VALUE_HOLDS_LIST (magnitude);
+    if (!is_list && !GST_VALUE_HOLDS_ARRAY (magnitude))
+        return FALSE;
+
+    n = is_list ? gst_value_list_get_size(magnitude) : gst_value_array_get_size(magnitude);
+    if (n != meter->n_bands) {
+        meter->bands = g_renew (gfloat, meter->bands, n);
+        meter->n_bands = n;
+    }
+
+    for (i = 0; i < n; i++) {
+        const GValue *v = is_list ? gst_value_list_get_value(magnitude, i)
+                                  : gst_value_array_get_value(magnitude, i);
+
+        /* Multi-channel spectra nest one array per channel, use the first */
+        if (GST_VALUE_HOLDS_ARRAY (v))
+            v = gst_value_array_get_value(v, 0);
+        meter->bands[i] = g_value_get_float(v);
+    }
+
+    return TRUE;
+}
+
+/**
+ * player_meter_get_timestamp:
+ * @meter: a #PlayerMeter
+ *
+ * Returns: the stream time the reading ends at.
+ */
+GstClockTime player_meter_get_timestamp(const PlayerMeter *meter) {
+    g_return_val_if_fail (meter != NULL, GST_CLOCK_TIME_NONE);
+
+    return meter->timestamp;
+}
+
+/**
+ * player_meter_get_n_channels:
+ * @meter: a #PlayerMeter
+ *
+ * Returns: number of metered channels.
+ */
+guint player_meter_get_n_channels(const PlayerMeter *meter) {
+    g_return_val_if_fail (meter != NULL, 0);
+
+    return meter->n_channels;
+}
+
+/**
+ * player_meter_get_peak:
+ * @meter: a #PlayerMeter
+ * @channel: channel index
+ *
+ * Returns: peak level of @channel over the interval in dB, 0.0 is full scale.
+ */
+gdouble player_meter_get_peak(const PlayerMeter *meter, guint channel) {
+    g_return_val_if_fail (meter != NULL, -G_MAXDOUBLE);
+    g_return_val_if_fail (channel < meter->n_channels, -G_MAXDOUBLE);
+
+    return meter->peak[channel];
+}
+
+/**
+ * player_meter_get_rms:
+ * @meter: a #PlayerMeter
+ * @channel: channel index
+ *
+ * Returns: RMS level of @channel over the interval in dB.
+ */
+gdouble player_meter_get_rms(const PlayerMeter *meter, guint channel) {
+    g_return_val_if_fail (meter != NULL, -G_MAXDOUBLE);
+    g_return_val_if_fail (channel < meter->n_channels, -G_MAXDOUBLE);
+
+    return meter->rms[channel];
+}
+
+/**
+ * player_meter_get_bands:
+ * @meter: a #PlayerMeter
+ * @n_bands: (out): number of bands
+ *
+ * Returns: (transfer none) (array length=n_bands) (nullable): magnitude
+ * in dB of each linearly spaced frequency band, or %NULL if the spectrum
+ * is disabled.
+ */
+const gfloat *player_meter_get_bands(const PlayerMeter *meter, guint *n_bands) {
+    g_return_val_if_fail (meter != NULL, NULL);
+
+    if (n_bands)
+        *n_bands = meter->n_bands;
+
+    return meter->bands;
+}
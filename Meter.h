@@ -0,0 +1,48 @@
+#ifndef __PLAYER_METER_H__
+#define __PLAYER_METER_H__
+
+#include <gst/gst.h>
+#include "PlayerPrelude.h"
+
+G_BEGIN_DECLS
+
+/* Channels beyond this are not metered */
+#define PLAYER_METER_MAX_CHANNELS 8
+
+#define GST_TYPE_PLAYER_METER (player_meter_get_type ())
+
+/**
+ * PlayerMeter:
+ *
+ * One coalesced meter reading of the audio being played: per-channel
+ * peak and RMS levels and, if enabled, the magnitude spectrum.
+ */
+typedef struct _PlayerMeter PlayerMeter;
+
+GST_PLAYER_API
+GType         player_meter_get_type (void);
+
+GST_PLAYER_API
+PlayerMeter * player_meter_copy (const PlayerMeter *meter);
+
+GST_PLAYER_API
+void          player_meter_free (PlayerMeter *meter);
+
+GST_PLAYER_API
+GstClockTime  player_meter_get_timestamp (const PlayerMeter *meter);
+
+GST_PLAYER_API
+guint         player_meter_get_n_channels (const PlayerMeter *meter);
+
+GST_PLAYER_API
+gdouble       player_meter_get_peak (const PlayerMeter *meter, guint channel);
+
+GST_PLAYER_API
+gdouble       player_meter_get_rms (const PlayerMeter *meter, guint channel);
+
+GST_PLAYER_API
+const gfloat * player_meter_get_bands (const PlayerMeter *meter, guint *n_bands);
+
+G_END_DECLS
+
+#endif /* __PLAYER_METER_H__ */
@@ -0,0 +1,22 @@
+#include "Meter.h"
+
+#ifndef __PLAYER_METER_PRIVATE_H__
+#define __PLAYER_METER_PRIVATE_H__
+
+struct _PlayerMeter
+{
+  GstClockTime timestamp;
+
+  guint n_channels;
+  gdouble peak[PLAYER_METER_MAX_CHANNELS];
+  gdouble rms[PLAYER_METER_MAX_CHANNELS];
+
+  guint n_bands;
+  gfloat *bands;
+};
+
+G_GNUC_INTERNAL PlayerMeter*  player_meter_new(void);
+G_GNUC_INTERNAL gboolean      player_meter_update_level(PlayerMeter *meter, const GstStructure *s);
+G_GNUC_INTERNAL gboolean      player_meter_update_spectrum(PlayerMeter *meter, const GstStructure *s);
+
+#endif /* __PLAYER_METER_PRIVATE_H__ */
@@ -0,0 +1,222 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Mirrors.h"
+#include "HttpClient.h"
+
+MirrorList *mirror_list_new(const gchar * const *uris) {
+    MirrorList *list = g_new0 (MirrorList, 1);
+    guint i;
+
+    list->n_mirrors = g_strv_length((gchar **) uris);
+    list->mirrors = g_new0 (Mirror, list->n_mirrors);
+    for (i = 0; i < list->n_mirrors; i++) {
+        list->mirrors[i].uri = g_strdup(uris[i]);
+        list->mirrors[i].ttfb = GST_CLOCK_TIME_NONE;
+    }
+    list->current = -1;
+
+    return list;
+}
+
+void mirror_list_free(MirrorList *list) {
+    guint i;
+
+    for (i = 0; i < list->n_mirrors; i++)
+        g_free(list->mirrors[i].uri);
+    g_free(list->mirrors);
+    g_free(list);
+}
+
+/* Forgets the winner and past failures, statistics are kept */
+void mirror_list_reset(MirrorList *list) {
+    guint i;
+
+    for (i = 0; i < list->n_mirrors; i++)
+        list->mirrors[i].failed = FALSE;
+    list->current = -1;
+}
+
+/* Returns the first mirror after @after that did not fail, or -1 */
+gint mirror_list_next_candidate(MirrorList *list, gint after) {
+    guint i;
+
+    for (i = (guint) (after + 1); i < list->n_mirrors; i++) {
+        if (!list->mirrors[i].failed)
+            return (gint) i;
+    }
+
+    return -1;
+}
+
+typedef struct {
+    gchar *uri;
+    gchar *user_agent;
+    gboolean cached;
+    GstContext *context;    /* HTTP session of the source, nullable */
+    gchar *final_uri;
+    GstClockTime ttfb;
+} Probe;
+
+static void probe_free(Probe *probe) {
+    g_free(probe->uri);
+    g_free(probe->user_agent);
+    if (probe->context)
+        gst_context_unref(probe->context);
+    g_free(probe->final_uri);
+    g_free(probe);
+}
+
+/* Probes through playercachesrc's client with a one byte range request */
+static gboolean probe_cache_client(Probe *probe, GCancellable *cancellable, GError **error) {
+    HttpClient *client = http_client_get_shared(probe->user_agent);
+    GstClockTime start = gst_util_get_timestamp();
+    HttpResponse *response;
+
+    response = http_client_get_range(client, probe->uri, 0, 1, cancellable, error);
+    http_client_unref(client);
+
+    if (!response)
+        return FALSE;
+
+    probe->ttfb = gst_util_get_timestamp() - start;
+    probe->final_uri = g_strdup(response->final_uri);
+    http_response_free(response);
+
+    return TRUE;
+}
+
+/* Probes through the source element playbin picks for the URI, usually
+ * souphttpsrc, prerolling a fakesink on its first buffer. The source gets
+ * the same settings and shared session as in playback, so the winner's
+ * connection is kept alive for it. */
+static gboolean probe_source(Probe *probe, GCancellable *cancellable, GError **error) {
+    GstElement *pipeline, *source, *sink;
+    GstClockTime start;
+    GstBus *bus;
+    GstQuery *query;
+    gboolean done = FALSE, ret = FALSE;
+
+    source = gst_element_make_from_uri(GST_URI_SRC, probe->uri, NULL, error);
+    if (!source)
+        return FALSE;
+
+    if (probe->user_agent && g_object_class_find_property(G_OBJECT_GET_CLASS (source), "user-agent"))
+        g_object_set(source, "user-agent", probe->user_agent, NULL);
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS (source), "keep-alive"))
+        g_object_set(source, "keep-alive", TRUE, NULL);
+    if (probe->context)
+        gst_element_set_context(source, probe->context);
+
+    pipeline = gst_pipeline_new(NULL);
+    sink = gst_element_factory_make("fakesink", NULL);
+    gst_bin_add_many(GST_BIN (pipeline), source, sink, NULL);
+    gst_element_link(source, sink);
+    bus = gst_element_get_bus(pipeline);
+
+    start = gst_util_get_timestamp();
+    gst_element_set_state(pipeline, GST_STATE_PAUSED);
+
+    while (!done) {
+        GstMessage *msg;
+
+        if (g_cancellable_set_error_if_cancelled(cancellable, error))
+            break;
+
+        msg = gst_bus_timed_pop_filtered(bus, 100 * GST_MSECOND,
+                                         GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR
+                                         | GST_MESSAGE_HAVE_CONTEXT);
+        if (!msg)
+            continue;
+
+        switch (GST_MESSAGE_TYPE (msg)) {
+            case GST_MESSAGE_ASYNC_DONE:
+                probe->ttfb = gst_util_get_timestamp() - start;
+                done = ret = TRUE;
+                break;
+            case GST_MESSAGE_ERROR:
+                gst_message_parse_error(msg, error, NULL);
+                done = TRUE;
+                break;
+            case GST_MESSAGE_HAVE_CONTEXT:
+                /* A session created for the probe, offered to playback */
+                if (!probe->context)
+                    gst_message_parse_have_context(msg, &probe->context);
+                break;
+            default:
+                break;
+        }
+        gst_message_unref(msg);
+    }
+
+    if (ret) {
+        gchar *redirect = NULL;
+
+        query = gst_query_new_uri();
+        if (gst_element_query(source, query))
+            gst_query_parse_uri_redirection(query, &redirect);
+        gst_query_unref(query);
+        probe->final_uri = redirect ? redirect : g_strdup(probe->uri);
+    }
+
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+    gst_object_unref(bus);
+    gst_object_unref(pipeline);
+
+    return ret;
+}
+
+static void probe_thread(GTask *task, G_GNUC_UNUSED gpointer source_object,
+                         gpointer task_data, GCancellable *cancellable) {
+    Probe *probe = task_data;
+    GError *err = NULL;
+    gboolean ok;
+
+    if (probe->cached)
+        ok = probe_cache_client(probe, cancellable, &err);
+    else
+        ok = probe_source(probe, cancellable, &err);
+
+    if (!ok) {
+        g_task_return_error(task, err);
+        return;
+    }
+
+    g_task_return_boolean(task, TRUE);
+}
+
+void mirror_probe_async(GObject *source_object, const gchar *uri, const gchar *user_agent,
+                        gboolean cached, GstContext *context, GCancellable *cancellable,
+                        GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task;
+    Probe *probe;
+
+    probe = g_new0 (Probe, 1);
+    probe->uri = g_strdup(uri);
+    probe->user_agent = g_strdup(user_agent);
+    probe->cached = cached;
+    probe->context = context ? gst_context_ref(context) : NULL;
+
+    task = g_task_new(source_object, cancellable, callback, user_data);
+    g_task_set_task_data(task, probe, (GDestroyNotify) probe_free);
+    g_task_run_in_thread(task, probe_thread);
+    g_object_unref(task);
+}
+
+/* Returns the time to first byte, or GST_CLOCK_TIME_NONE on error */
+GstClockTime mirror_probe_finish(GAsyncResult *result, gchar **final_uri,
+                                 GstContext **context, GError **error) {
+    GTask *task = G_TASK (result);
+    Probe *probe = g_task_get_task_data(task);
+
+    if (!g_task_propagate_boolean(task, error))
+        return GST_CLOCK_TIME_NONE;
+
+    if (final_uri)
+        *final_uri = g_strdup(probe->final_uri);
+    if (context)
+        *context = probe->context ? gst_context_ref(probe->context) : NULL;
+
+    return probe->ttfb;
+}
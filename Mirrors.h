@@ -0,0 +1,49 @@
+#ifndef __PLAYER_MIRRORS_H__
+#define __PLAYER_MIRRORS_H__
+
+#include <gio/gio.h>
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct {
+    gchar *uri;
+    GstClockTime ttfb;      /* Last measured time to first byte */
+    guint n_wins;
+    guint n_failures;
+    gboolean failed;        /* Failed since the last reset */
+} Mirror;
+
+/*
+ * Candidate URIs for one media item, in order of preference. current is
+ * the mirror in use, -1 until one won a race.
+ */
+typedef struct {
+    Mirror *mirrors;
+    guint n_mirrors;
+    gint current;
+} MirrorList;
+
+G_GNUC_INTERNAL MirrorList* mirror_list_new(const gchar * const *uris);
+G_GNUC_INTERNAL void        mirror_list_free(MirrorList *list);
+G_GNUC_INTERNAL void        mirror_list_reset(MirrorList *list);
+G_GNUC_INTERNAL gint        mirror_list_next_candidate(MirrorList *list, gint after);
+
+/*
+ * Measures the time to first byte of an HTTP URI through the stack
+ * playback will read it with: the client of playercachesrc if @cached,
+ * otherwise the source element for the URI, given the shared HTTP session
+ * @context if any. The session the probe used is returned from finish,
+ * so the connection is warm when the source opens the winner. Completes
+ * on the thread-default main context of the caller.
+ */
+G_GNUC_INTERNAL void         mirror_probe_async(GObject *source_object, const gchar *uri,
+                                                const gchar *user_agent, gboolean cached,
+                                                GstContext *context, GCancellable *cancellable,
+                                                GAsyncReadyCallback callback, gpointer user_data);
+G_GNUC_INTERNAL GstClockTime mirror_probe_finish(GAsyncResult *result, gchar **final_uri,
+                                                 GstContext **context, GError **error);
+
+G_END_DECLS
+
+#endif /* __PLAYER_MIRRORS_H__ */
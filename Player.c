@@ -1,6 +1,18 @@
 #include "PlayerDefine.h"
+#include "PlayerPrivate.h"
 #include "PlayerSignalDispatcherPrivate.h"
+#include "PlayerFdSignalDispatcher.h"
+#include "PlayerSyncSignalDispatcher.h"
 #include "MediaInfoPrivate.h"
+#include "MeterPrivate.h"
+#include "ArtworkPrivate.h"
+#include "TagStorePrivate.h"
+#include "MediaInfoDiffPrivate.h"
+#include "TaskPoolPrivate.h"
+#include "BufferingPolicy.h"
+#include "CacheSrc.h"
+#include "RedirectCache.h"
+#include "Mirrors.h"
 
 #include <gst/gst.h>
 #include <gst/pbutils/descriptions.h>
@@ -17,6 +29,40 @@ GST_DEBUG_CATEGORY_STATIC (player_debug);
 #define DEFAULT_MUTE FALSE
 #define DEFAULT_RATE 1.0
 #define DEFAULT_POSITION_UPDATE_INTERVAL_MS 100
+#define DEFAULT_SINK_BUFFER_TIME_US 20000
+#define DEFAULT_SINK_LATENCY_TIME_US 5000
+#define DEFAULT_BUFFERING_LOW_PERCENT 10
+#define DEFAULT_BUFFERING_HIGH_PERCENT 100
+#define DEFAULT_HTTP_PREFETCH_BLOCKS 4
+#define DEFAULT_IDLE_TIMEOUT_MS 60000
+
+/* Mirrors probed in parallel when a mirror list starts */
+#define MIRROR_RACE_WIDTH 2
+
+/* Fraction of the memory budget the network queues hold together, the
+ * rest is split between the other queues and multiqueue streams */
+#define MEMORY_BUDGET_NETWORK_SHARE 2
+
+/* Context type souphttpsrc keeps its SoupSession in */
+#define SOUP_SESSION_CONTEXT_TYPE "gst.soup.session"
+
+/* Session of the first souphttpsrc, handed to the sources of all players
+ * and to mirror probes so they share its keep-alive connections */
+static GMutex http_context_lock;
+static GstContext *http_context = NULL;
+
+/* Keeps @context as the shared session unless there is one already */
+static void share_http_context(GstContext *context) {
+    if (!g_str_equal(gst_context_get_context_type(context), SOUP_SESSION_CONTEXT_TYPE))
+        return;
+
+    g_mutex_lock(&http_context_lock);
+    if (!http_context) {
+        GST_DEBUG ("Sharing HTTP session");
+        http_context = gst_context_ref(context);
+    }
+    g_mutex_unlock(&http_context_lock);
+}
 
 /**
  * player_error_quark:
@@ -32,6 +78,23 @@ typedef enum {
     CONFIG_QUARK_USER_AGENT = 0,
     CONFIG_QUARK_POSITION_INTERVAL_UPDATE,
     CONFIG_QUARK_ACCURATE_SEEK,
+    CONFIG_QUARK_OFFLINE,
+    CONFIG_QUARK_FINGERPRINT,
+    CONFIG_QUARK_METER_INTERVAL,
+    CONFIG_QUARK_METER_BANDS,
+    CONFIG_QUARK_LOW_LATENCY,
+    CONFIG_QUARK_SINK_BUFFER_TIME,
+    CONFIG_QUARK_SINK_LATENCY_TIME,
+    CONFIG_QUARK_BUFFERING_LOW_PERCENT,
+    CONFIG_QUARK_BUFFERING_HIGH_PERCENT,
+    CONFIG_QUARK_BUFFER_SIZE,
+    CONFIG_QUARK_BUFFER_DURATION,
+    CONFIG_QUARK_PROGRESSIVE_DOWNLOAD,
+    CONFIG_QUARK_HTTP_CACHE,
+    CONFIG_QUARK_HTTP_PREFETCH,
+    CONFIG_QUARK_MEMORY_BUDGET,
+    CONFIG_QUARK_ARTWORK_IN_TAGS,
+    CONFIG_QUARK_IDLE_TIMEOUT,
 
     CONFIG_QUARK_MAX
 } ConfigQuarkId;
@@ -40,12 +103,90 @@ static const gchar *_config_quark_strings[] = {
         "user-agent",
         "position-interval-update",
         "accurate-seek",
+        "offline",
+        "fingerprint",
+        "meter-interval",
+        "meter-bands",
+        "low-latency",
+        "sink-buffer-time",
+        "sink-latency-time",
+        "buffering-low-percent",
+        "buffering-high-percent",
+        "buffer-size",
+        "buffer-duration",
+        "progressive-download",
+        "http-cache",
+        "http-prefetch",
+        "memory-budget",
+        "artwork-in-tags",
+        "idle-timeout",
 };
 
 GQuark _config_quark_table[CONFIG_QUARK_MAX];
 
+/* Keys that can change while playing, see player_set_config(). All others
+ * only apply to the next stream and require the player to be stopped. */
+static const gboolean _config_quark_live[CONFIG_QUARK_MAX] = {
+        [CONFIG_QUARK_USER_AGENT] = TRUE,
+        [CONFIG_QUARK_POSITION_INTERVAL_UPDATE] = TRUE,
+        [CONFIG_QUARK_ACCURATE_SEEK] = TRUE,
+        [CONFIG_QUARK_BUFFERING_LOW_PERCENT] = TRUE,
+        [CONFIG_QUARK_BUFFERING_HIGH_PERCENT] = TRUE,
+        [CONFIG_QUARK_IDLE_TIMEOUT] = TRUE,
+};
+
 #define CONFIG_QUARK(q) _config_quark_table[CONFIG_QUARK_##q]
 
+/* The config structure compiled into plain fields once when it is set,
+ * so that nothing reads the GstStructure at runtime. Add a field here
+ * along with every new key. */
+typedef struct {
+    gchar *user_agent;
+    guint position_update_interval;
+    gboolean seek_accurate;
+    gboolean offline;
+    gboolean fingerprint;
+    guint meter_interval;
+    guint meter_bands;
+    gboolean low_latency;
+    guint sink_buffer_time;
+    guint sink_latency_time;
+    gint buffering_low_percent;
+    gint buffering_high_percent;
+    gint buffer_size;
+    gint64 buffer_duration;
+    gboolean progressive_download;
+    gboolean http_cache;
+    guint http_prefetch;
+    guint64 memory_budget;
+    gboolean artwork_in_tags;
+    guint idle_timeout;
+} PlayerConfig;
+
+static void player_config_compile(PlayerConfig *compiled, const GstStructure *config) {
+    g_free(compiled->user_agent);
+    compiled->user_agent = player_config_get_user_agent(config);
+    compiled->position_update_interval = player_config_get_position_update_interval(config);
+    compiled->seek_accurate = player_config_get_seek_accurate(config);
+    compiled->offline = player_config_get_offline(config);
+    compiled->fingerprint = player_config_get_fingerprint(config);
+    compiled->meter_interval = player_config_get_meter_interval(config);
+    compiled->meter_bands = player_config_get_meter_bands(config);
+    compiled->low_latency = player_config_get_low_latency(config);
+    compiled->sink_buffer_time = player_config_get_sink_buffer_time(config);
+    compiled->sink_latency_time = player_config_get_sink_latency_time(config);
+    compiled->buffering_low_percent = player_config_get_buffering_low_percent(config);
+    compiled->buffering_high_percent = player_config_get_buffering_high_percent(config);
+    compiled->buffer_size = player_config_get_buffer_size(config);
+    compiled->buffer_duration = player_config_get_buffer_duration(config);
+    compiled->progressive_download = player_config_get_progressive_download(config);
+    compiled->http_cache = player_config_get_http_cache(config);
+    compiled->http_prefetch = player_config_get_http_prefetch(config);
+    compiled->memory_budget = player_config_get_memory_budget(config);
+    compiled->artwork_in_tags = player_config_get_artwork_in_tags(config);
+    compiled->idle_timeout = player_config_get_idle_timeout(config);
+}
+
 enum {
     PROP_0,
     PROP_SIGNAL_DISPATCHER,
@@ -75,49 +216,143 @@ enum {
     SIGNAL_VOLUME_CHANGED,
     SIGNAL_MUTE_CHANGED,
     SIGNAL_SEEK_DONE,
+    SIGNAL_METER_UPDATED,
+    SIGNAL_MEDIA_INFO_CHANGED,
     SIGNAL_LAST
 };
 
+G_STATIC_ASSERT (SIGNAL_LAST <= 32);
+
 enum {
     GST_PLAY_FLAG_VIDEO = (1 << 0),
     GST_PLAY_FLAG_AUDIO = (1 << 1),
     GST_PLAY_FLAG_SUBTITLE = (1 << 2),
-    GST_PLAY_FLAG_VIS = (1 << 3)
+    GST_PLAY_FLAG_VIS = (1 << 3),
+    GST_PLAY_FLAG_DOWNLOAD = (1 << 7),
+    GST_PLAY_FLAG_BUFFERING = (1 << 8)
 };
 
 struct _Player {
     GstObject parent;
 
     PlayerSignalDispatcher *signal_dispatcher;
+    /* Events may be drained as records, which need no handlers */
+    gboolean queue_all_events;
+    /* Events are emitted before dispatching returns */
+    gboolean sync_dispatch;
 
     gchar *uri;
     gchar *redirect_uri;
+    /* URI whose remembered redirect gave redirect_uri, dropped on a source error */
+    gchar *redirect_cache_key;
     gchar *suburi;
 
+    /* Audio track to restore once a redirect target prerolled, or -1 */
+    gint redirect_audio_track;
+
+    /* Whether the current item is read without the HTTP cache after the
+     * cache failed to read it, protected by lock */
+    gboolean http_cache_bypass;
+
+    /* Candidates for uri, protected by lock. Probes report back with the
+     * generation they started in and are ignored after a reset. */
+    MirrorList *mirrors;
+    guint mirror_generation;
+    guint mirror_probes;
+    gint mirror_next;
+
+    /* Started on first use, protected by lock. Once shut down the thread
+     * is gone and is not started again. shutting_down is set as soon as
+     * a shutdown is requested, so no command or pipeline sneaks in
+     * while the thread tears down. */
     GThread *thread;
+    gboolean shutting_down;
+    gboolean shut_down;
+    GList *shutdown_tasks;
     GMutex lock;
-    GCond cond;
     GMainContext *context;
     GMainLoop *loop;
 
+    /* Created on first use, set once under lock */
     GstElement *playbin;
     GstBus *bus;
+    GSource *bus_source;
+    /* Messages handled and time spent on them in nanoseconds, only
+     * written from main context, atomic */
+    gsize bus_n_messages;
+    gsize bus_handling_time;
+    gint bus_n_dropped;     /* atomic */
     GstState target_state, current_state;
     gboolean is_live, is_eos;
     GSource *tick_source, *ready_timeout_source;
+
+    /* Idle in READY after a stop, see WarmPool. warm_link is protected by
+     * the pool lock, idle_hint is atomic. */
+    GWeakRef self_ref;
+    GList *warm_link;
+    gint idle_hint;
     GstClockTime cached_duration;
 
     gdouble rate;
 
+    /* Protected by lock. Kept here until there is a pipeline to apply
+     * them to, and updated from it afterwards. */
+    gdouble volume;
+    gboolean mute;
+
     PlayerState app_state;
     gint buffering;
 
     GstTagList *global_tags;
     PlayerMediaInfo *media_info;
+    /* First image found in the tags of the current media, protected by lock */
+    PlayerArtwork *artwork;
+    /* Media info as of the last diff sent, NULL while nobody listens for
+     * diffs, protected by lock */
+    PlayerMediaInfo *published_info;
+    guint64 media_info_version;
 
     GstElement *current_vis_element;
 
+    /* Protected by lock, only replaced while stopped. Everything reads
+     * the compiled copy. */
     GstStructure *config;
+    PlayerConfig compiled_config;
+
+    /* Offline decode mode, only touched from main context except
+     * realtime_factor which is protected by lock */
+    gboolean offline;
+    PlayerFingerprinter *fingerprinter;   /* Non-NULL while fingerprinting */
+    GstClockTime offline_start_time;
+    GstClockTime offline_start_position;
+    gdouble realtime_factor;
+
+    /* Watermarks and fill state, only written from main context, read
+     * elsewhere with lock */
+    BufferingPolicy buffering_policy;
+    /* queue2 elements inside playbin, protected by lock */
+    GPtrArray *network_queues;
+    /* queue and multiqueue elements inside playbin, protected by lock */
+    GPtrArray *buffer_queues;
+    /* Memory budget as applied, 0 for none, and the resulting limit per
+     * network queue and per other queue or multiqueue stream, protected
+     * by lock */
+    guint64 memory_budget;
+    guint network_queue_limit;
+    guint buffer_queue_limit;
+
+    /* Low-latency sink setup as applied, only touched from main context */
+    gboolean low_latency;
+    guint sink_buffer_time;
+    guint sink_latency_time;
+    gboolean restore_buffering_flag;
+
+    /* Metering as applied to the audio filter, only touched from main context */
+    guint meter_interval;
+    guint meter_bands;
+    /* Latest reading and whether a dispatch is queued, protected by lock */
+    PlayerMeter *meter;
+    gboolean meter_dispatch_pending;
 
     /* Protected by lock */
     gboolean seek_pending;        /* Only set from main context */
@@ -128,6 +363,8 @@ struct _Player {
    * state-changed:PLAYER_STATE_STOPPED/PAUSED. This ensures that no signal
    * is emitted after player_stop/pause() has been called by the user. */
     gboolean inhibit_sigs;
+    /* Handlers connected with player_signal_connect(), atomic */
+    gint n_handlers[SIGNAL_LAST];
 
     /* For playbin3 */
     gboolean use_playbin3;
@@ -153,6 +390,8 @@ static void player_dispose(GObject *object);
 
 static void player_finalize(GObject *object);
 
+static void warm_pool_remove(Player *self);
+
 static void player_set_property(GObject *object, guint prop_id,
                                 const GValue *value, GParamSpec *pspec);
 
@@ -163,6 +402,8 @@ static void player_constructed(GObject *object);
 
 static gpointer player_main(gpointer data);
 
+static GstElement *player_create_audio_filter(guint meter_interval, guint meter_bands);
+
 static void player_seek_internal_locked(Player *self);
 
 static void player_stop_internal(Player *self, gboolean transient);
@@ -222,17 +463,23 @@ static void *get_container_format(GstTagList *tags);
 static void *get_from_tags(Player *self, PlayerMediaInfo *media_info,
                            void *(*func)(GstTagList *));
 
-static void *get_cover_sample(GstTagList *tags);
 
 static void remove_seek_source(Player *self);
 
+static gboolean uri_is_http(const gchar *uri);
+
+static void player_reset_mirrors_locked(Player *self);
+
+static void player_ensure_pipeline(Player *self);
+
+static GstElement *player_ref_playbin(Player *self);
+
 static void player_init(Player *self) {
     GST_TRACE_OBJECT (self, "Initializing");
 
     self = player_get_instance_private(self);
 
     g_mutex_init(&self->lock);
-    g_cond_init(&self->cond);
 
     self->context = g_main_context_new();
     self->loop = g_main_loop_new(self->context, FALSE);
@@ -244,11 +491,32 @@ static void player_init(Player *self) {
                                         CONFIG_QUARK (ACCURATE_SEEK), G_TYPE_BOOLEAN, FALSE,
                                         NULL);
     /* *INDENT-ON* */
+    player_config_compile(&self->compiled_config, self->config);
 
     self->seek_pending = FALSE;
     self->seek_position = GST_CLOCK_TIME_NONE;
     self->last_seek_time = GST_CLOCK_TIME_NONE;
     self->inhibit_sigs = FALSE;
+    self->offline_start_time = GST_CLOCK_TIME_NONE;
+    self->offline_start_position = GST_CLOCK_TIME_NONE;
+    self->redirect_audio_track = -1;
+    self->mirror_next = -1;
+    buffering_policy_init(&self->buffering_policy, DEFAULT_BUFFERING_LOW_PERCENT,
+                          DEFAULT_BUFFERING_HIGH_PERCENT, -1);
+    self->network_queues = g_ptr_array_new_with_free_func(gst_object_unref);
+    self->buffer_queues = g_ptr_array_new_with_free_func(gst_object_unref);
+
+    self->target_state = GST_STATE_NULL;
+    self->current_state = GST_STATE_NULL;
+    self->app_state = PLAYER_STATE_STOPPED;
+    self->buffering = 100;
+    self->is_eos = FALSE;
+    self->is_live = FALSE;
+    self->rate = 1.0;
+    self->volume = DEFAULT_VOLUME;
+    self->mute = DEFAULT_MUTE;
+    self->idle_hint = PLAYER_IDLE_HINT_DEFAULT;
+    g_weak_ref_init(&self->self_ref, self);
 
     GST_TRACE_OBJECT (self, "Initialized");
 }
@@ -389,25 +657,88 @@ static void player_class_init(PlayerClass *klass) {
                          G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS, 0, NULL,
                          NULL, NULL, G_TYPE_NONE, 1, GST_TYPE_CLOCK_TIME);
 
+    signals[SIGNAL_METER_UPDATED] =
+            g_signal_new("meter-updated", G_TYPE_FROM_CLASS (klass),
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS, 0, NULL,
+                         NULL, NULL, G_TYPE_NONE, 1, GST_TYPE_PLAYER_METER);
+
+    signals[SIGNAL_MEDIA_INFO_CHANGED] =
+            g_signal_new("media-info-changed", G_TYPE_FROM_CLASS (klass),
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS, 0, NULL,
+                         NULL, NULL, G_TYPE_NONE, 1, GST_TYPE_PLAYER_MEDIA_INFO_DIFF);
+
     config_quark_initialize();
 
 
 }
 
+static gboolean main_loop_quit_cb(gpointer user_data) {
+    g_main_loop_quit(user_data);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Must be called with lock */
+static void player_ensure_thread_locked(Player *self) {
+    if (self->thread || self->shut_down)
+        return;
+
+    GST_TRACE_OBJECT (self, "Starting main thread");
+    self->thread = g_thread_new("Player", player_main, self);
+}
+
+/* Runs @func on the player thread, starting it if needed. Until the
+ * thread owns the context, g_main_context_invoke() would run @func right
+ * away in the calling thread, so commands are queued as sources instead
+ * and run in order once the loop is up. Commands from the player thread
+ * itself, i.e. from signal handlers run synchronously, are queued as well
+ * instead of reentering whatever emitted the signal. */
+static void player_invoke(Player *self, GSourceFunc func) {
+    GSource *source;
+
+    g_mutex_lock(&self->lock);
+    if (self->shutting_down || self->shut_down) {
+        g_mutex_unlock(&self->lock);
+        GST_DEBUG_OBJECT (self, "Ignoring command after shutdown");
+        return;
+    }
+    player_ensure_thread_locked(self);
+    g_mutex_unlock(&self->lock);
+
+    source = g_idle_source_new();
+    g_source_set_priority(source, G_PRIORITY_DEFAULT);
+    g_source_set_callback(source, func, self, NULL);
+    g_source_attach(source, self->context);
+    g_source_unref(source);
+}
+
 static void player_dispose(GObject *object) {
     Player *self = GST_PLAYER (object);
 
     GST_TRACE_OBJECT (self, "Stopping main thread");
 
-    if (self->loop) {
-        g_main_loop_quit(self->loop);
+    warm_pool_remove(self);
+
+    if (self->thread) {
+        if (self->thread != g_thread_self()) {
+            GSource *source;
+
+            /* The loop may not be running yet, so quit from inside it */
+            source = g_idle_source_new();
+            g_source_set_priority(source, G_PRIORITY_HIGH);
+            g_source_set_callback(source, main_loop_quit_cb, self->loop, NULL);
+            g_source_attach(source, self->context);
+            g_source_unref(source);
 
-        if (self->thread != g_thread_self())
             g_thread_join(self->thread);
-        else
+        } else {
+            g_main_loop_quit(self->loop);
             g_thread_unref(self->thread);
+        }
         self->thread = NULL;
+    }
 
+    if (self->loop) {
         g_main_loop_unref(self->loop);
         self->loop = NULL;
 
@@ -425,22 +756,36 @@ static void player_finalize(GObject *object) {
 
     g_free(self->uri);
     g_free(self->redirect_uri);
+    g_free(self->redirect_cache_key);
     g_free(self->suburi);
+    if (self->mirrors)
+        mirror_list_free(self->mirrors);
     g_free(self->video_sid);
     g_free(self->audio_sid);
     g_free(self->subtitle_sid);
     if (self->global_tags)
         gst_tag_list_unref(self->global_tags);
+    if (self->artwork)
+        player_artwork_free(self->artwork);
+    if (self->published_info)
+        g_object_unref(self->published_info);
     if (self->signal_dispatcher)
         g_object_unref(self->signal_dispatcher);
     if (self->current_vis_element)
         gst_object_unref(self->current_vis_element);
     if (self->config)
         gst_structure_free(self->config);
+    g_free(self->compiled_config.user_agent);
     if (self->collection)
         gst_object_unref(self->collection);
+    if (self->fingerprinter)
+        player_fingerprinter_unref(self->fingerprinter);
+    if (self->meter)
+        player_meter_free(self->meter);
+    g_ptr_array_unref(self->network_queues);
+    g_ptr_array_unref(self->buffer_queues);
+    g_weak_ref_clear(&self->self_ref);
     g_mutex_clear(&self->lock);
-    g_cond_clear(&self->cond);
 
     G_OBJECT_CLASS (parent_class)->finalize(object);
 }
@@ -450,34 +795,181 @@ static void player_constructed(GObject *object) {
 
     GST_TRACE_OBJECT (self, "Constructed");
 
-    g_mutex_lock(&self->lock);
-    self->thread = g_thread_new("Player", player_main, self);
-    while (!self->loop || !g_main_loop_is_running(self->loop))
-        g_cond_wait(&self->cond, &self->lock);
-    g_mutex_unlock(&self->lock);
+    /* The thread and the pipeline are only created on first use, see
+     * player_ensure_thread_locked() and player_ensure_pipeline() */
 
     G_OBJECT_CLASS (parent_class)->constructed(object);
 }
 
-typedef struct {
-    Player *player;
-    gchar *uri;
-} UriLoadedSignalData;
+/* Events emitted before dispatching returns borrow the player. With a
+ * reference of their own, the last unref could happen on the player
+ * thread when the application dropped its reference meanwhile, and
+ * dispose would then free the player under the running loop. */
+static PlayerEvent *player_event_new(Player *self, PlayerEventKind kind) {
+    PlayerEvent *event = g_new0 (PlayerEvent, 1);
 
-static void uri_loaded_dispatch(gpointer user_data) {
-    UriLoadedSignalData *data = user_data;
+    event->kind = kind;
+    event->player = self->sync_dispatch ? self : g_object_ref(self);
 
-    g_signal_emit(data->player, signals[SIGNAL_URI_LOADED], 0, data->uri);
+    return event;
 }
 
-static void uri_loaded_signal_data_free(UriLoadedSignalData *data) {
-    g_object_unref(data->player);
-    g_free(data->uri);
-    g_free(data);
+/**
+ * player_event_clear:
+ * @event: a record from player_fd_signal_dispatcher_drain()
+ *
+ * Releases the player reference and the payload held by @event.
+ */
+void player_event_clear(PlayerEvent *event) {
+    switch (event->kind) {
+        case PLAYER_EVENT_URI_LOADED:
+            g_clear_pointer(&event->payload.uri, g_free);
+            break;
+        case PLAYER_EVENT_ERROR:
+        case PLAYER_EVENT_WARNING:
+            g_clear_error(&event->payload.error);
+            break;
+        case PLAYER_EVENT_MEDIA_INFO_UPDATED:
+            g_clear_object(&event->payload.media_info);
+            break;
+        case PLAYER_EVENT_METER_UPDATED:
+            g_clear_pointer(&event->payload.meter, player_meter_free);
+            break;
+        case PLAYER_EVENT_MEDIA_INFO_CHANGED:
+            g_clear_pointer(&event->payload.diff, player_media_info_diff_unref);
+            break;
+        default:
+            break;
+    }
+    g_clear_object(&event->player);
+}
+
+static void player_event_free(PlayerEvent *event) {
+    player_event_clear(event);
+    g_free(event);
+}
+
+static void player_event_free_borrowed(PlayerEvent *event) {
+    event->player = NULL;
+    player_event_free(event);
+}
+
+/* Completes @event right before it is delivered, as a signal or as a
+ * record, and returns FALSE if it must not go out anymore. If
+ * inhibit_sigs is set, only state changes to STOPPED and PAUSED pass. */
+gboolean player_event_resolve(PlayerEvent *event) {
+    Player *self = event->player;
+
+    switch (event->kind) {
+        case PLAYER_EVENT_URI_LOADED:
+            return TRUE;
+        case PLAYER_EVENT_STATE_CHANGED:
+            return !self->inhibit_sigs || event->payload.state == PLAYER_STATE_STOPPED
+                   || event->payload.state == PLAYER_STATE_PAUSED;
+        case PLAYER_EVENT_METER_UPDATED:
+            /* Takes whatever reading is the latest by now, so a slow consumer
+             * skips intermediate readings instead of queueing them up */
+            g_mutex_lock(&self->lock);
+            self->meter_dispatch_pending = FALSE;
+            if (self->meter && !event->payload.meter)
+                event->payload.meter = player_meter_copy(self->meter);
+            g_mutex_unlock(&self->lock);
+
+            return event->payload.meter && !self->inhibit_sigs
+                   && self->target_state >= GST_STATE_PAUSED;
+        case PLAYER_EVENT_POSITION_UPDATED:
+        case PLAYER_EVENT_DURATION_CHANGED:
+        case PLAYER_EVENT_BUFFERING:
+        case PLAYER_EVENT_MEDIA_INFO_UPDATED:
+        case PLAYER_EVENT_MEDIA_INFO_CHANGED:
+            return !self->inhibit_sigs && self->target_state >= GST_STATE_PAUSED;
+        default:
+            return !self->inhibit_sigs;
+    }
+}
+
+static void player_event_emit(const PlayerEvent *event) {
+    Player *self = event->player;
+
+    switch (event->kind) {
+        case PLAYER_EVENT_URI_LOADED:
+            g_signal_emit(self, signals[SIGNAL_URI_LOADED], 0, event->payload.uri);
+            break;
+        case PLAYER_EVENT_POSITION_UPDATED:
+            g_signal_emit(self, signals[SIGNAL_POSITION_UPDATED], 0, event->payload.position);
+            g_object_notify_by_pspec(G_OBJECT (self), param_specs[PROP_POSITION]);
+            break;
+        case PLAYER_EVENT_DURATION_CHANGED:
+            g_signal_emit(self, signals[SIGNAL_DURATION_CHANGED], 0, event->payload.duration);
+            g_object_notify_by_pspec(G_OBJECT (self), param_specs[PROP_DURATION]);
+            break;
+        case PLAYER_EVENT_STATE_CHANGED:
+            g_signal_emit(self, signals[SIGNAL_STATE_CHANGED], 0, event->payload.state);
+            break;
+        case PLAYER_EVENT_BUFFERING:
+            g_signal_emit(self, signals[SIGNAL_BUFFERING], 0, event->payload.percent);
+            break;
+        case PLAYER_EVENT_END_OF_STREAM:
+            g_signal_emit(self, signals[SIGNAL_END_OF_STREAM], 0);
+            break;
+        case PLAYER_EVENT_ERROR:
+            g_signal_emit(self, signals[SIGNAL_ERROR], 0, event->payload.error);
+            break;
+        case PLAYER_EVENT_WARNING:
+            g_signal_emit(self, signals[SIGNAL_WARNING], 0, event->payload.error);
+            break;
+        case PLAYER_EVENT_MEDIA_INFO_UPDATED:
+            g_signal_emit(self, signals[SIGNAL_MEDIA_INFO_UPDATED], 0, event->payload.media_info);
+            break;
+        case PLAYER_EVENT_VOLUME_CHANGED:
+            g_signal_emit(self, signals[SIGNAL_VOLUME_CHANGED], 0);
+            g_object_notify_by_pspec(G_OBJECT (self), param_specs[PROP_VOLUME]);
+            break;
+        case PLAYER_EVENT_MUTE_CHANGED:
+            g_signal_emit(self, signals[SIGNAL_MUTE_CHANGED], 0);
+            g_object_notify_by_pspec(G_OBJECT (self), param_specs[PROP_MUTE]);
+            break;
+        case PLAYER_EVENT_SEEK_DONE:
+            g_signal_emit(self, signals[SIGNAL_SEEK_DONE], 0, event->payload.position);
+            break;
+        case PLAYER_EVENT_METER_UPDATED:
+            g_signal_emit(self, signals[SIGNAL_METER_UPDATED], 0, event->payload.meter);
+            break;
+        case PLAYER_EVENT_MEDIA_INFO_CHANGED:
+            g_signal_emit(self, signals[SIGNAL_MEDIA_INFO_CHANGED], 0, event->payload.diff);
+            break;
+    }
+}
+
+/* The emitter of all player signals, whatever the dispatcher */
+void player_event_deliver(gpointer user_data) {
+    PlayerEvent *event = user_data;
+
+    if (player_event_resolve(event))
+        player_event_emit(event);
+}
+
+/* Not under the lock, a synchronous dispatcher runs handlers right away */
+static void player_post_event(Player *self, PlayerEvent *event) {
+    player_signal_dispatcher_dispatch(self->signal_dispatcher, self, player_event_deliver, event,
+                                      self->sync_dispatch ? (GDestroyNotify) player_event_free_borrowed
+                                                          : (GDestroyNotify) player_event_free);
+}
+
+/* Whether emitting signal @id reaches anyone, so the payload is only
+ * built for signals with handlers. Handlers from player_signal_connect()
+ * are counted, any others are found by GObject. An fd dispatcher gets
+ * everything, player_fd_signal_dispatcher_drain() needs no handlers. */
+static gboolean player_has_subscriber(Player *self, guint id) {
+    if (self->queue_all_events || g_atomic_int_get(&self->n_handlers[id]) > 0)
+        return TRUE;
+
+    return g_signal_has_handler_pending(self, signals[id], 0, FALSE);
 }
 
 static gboolean player_set_uri_internal(gpointer user_data) {
     Player *self = user_data;
+    PlayerEvent *event = NULL;
 
     player_stop_internal(self, FALSE);
 
@@ -487,21 +979,18 @@ static gboolean player_set_uri_internal(gpointer user_data) {
 
     g_object_set(self->playbin, "uri", self->uri, NULL);
 
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_URI_LOADED], 0, NULL, NULL, NULL) != 0) {
-        UriLoadedSignalData *data = g_new (UriLoadedSignalData, 1);
-
-        data->player = g_object_ref(self);
-        data->uri = g_strdup(self->uri);
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          uri_loaded_dispatch, data,
-                                          (GDestroyNotify) uri_loaded_signal_data_free);
+    if (player_has_subscriber(self, SIGNAL_URI_LOADED)) {
+        event = player_event_new(self, PLAYER_EVENT_URI_LOADED);
+        event->payload.uri = g_strdup(self->uri);
     }
 
     g_object_set(self->playbin, "suburi", NULL, NULL);
 
     g_mutex_unlock(&self->lock);
 
+    if (event)
+        player_post_event(self, event);
+
     return G_SOURCE_REMOVE;
 }
 
@@ -523,34 +1012,80 @@ static void player_set_rate_internal(Player *self) {
     }
 }
 
+static gboolean player_set_volume_internal(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    gdouble volume;
+
+    g_mutex_lock(&self->lock);
+    volume = self->volume;
+    g_mutex_unlock(&self->lock);
+
+    if (self->playbin)
+        g_object_set(self->playbin, "volume", volume, NULL);
+
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean player_set_mute_internal(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    gboolean mute;
+
+    g_mutex_lock(&self->lock);
+    mute = self->mute;
+    g_mutex_unlock(&self->lock);
+
+    if (self->playbin)
+        g_object_set(self->playbin, "mute", mute, NULL);
+
+    return G_SOURCE_REMOVE;
+}
+
 static void player_set_property(GObject *object, guint prop_id,
                                 const GValue *value, GParamSpec *pspec) {
     Player *self = GST_PLAYER (object);
+    gboolean apply;
 
     switch (prop_id) {
         case PROP_SIGNAL_DISPATCHER:
             self->signal_dispatcher = g_value_dup_object(value);
+            self->queue_all_events = GST_IS_PLAYER_FD_SIGNAL_DISPATCHER(self->signal_dispatcher);
+            self->sync_dispatch = !self->signal_dispatcher
+                                  || GST_IS_PLAYER_SYNC_SIGNAL_DISPATCHER(self->signal_dispatcher);
             break;
         case PROP_URI: {
             g_mutex_lock(&self->lock);
             g_free(self->uri);
             g_free(self->redirect_uri);
             self->redirect_uri = NULL;
+            g_clear_pointer(&self->redirect_cache_key, g_free);
+            self->http_cache_bypass = FALSE;
 
             g_free(self->suburi);
             self->suburi = NULL;
 
+            if (self->mirrors) {
+                player_reset_mirrors_locked(self);
+                mirror_list_free(self->mirrors);
+                self->mirrors = NULL;
+            }
+
             self->uri = g_value_dup_string(value);
             GST_DEBUG_OBJECT (self, "Set uri=%s", self->uri);
             g_mutex_unlock(&self->lock);
 
-            g_main_context_invoke_full(self->context, G_PRIORITY_DEFAULT,
-                                       player_set_uri_internal, self, NULL);
+            player_ensure_pipeline(self);
+            player_invoke(self, player_set_uri_internal);
             break;
         }
         case PROP_VOLUME:
             GST_DEBUG_OBJECT (self, "Set volume=%lf", g_value_get_double(value));
-            g_object_set_property(G_OBJECT (self->playbin), "volume", value);
+            g_mutex_lock(&self->lock);
+            self->volume = g_value_get_double(value);
+            apply = self->playbin != NULL;
+            g_mutex_unlock(&self->lock);
+            /* Otherwise applied when the pipeline is created */
+            if (apply)
+                player_invoke(self, player_set_volume_internal);
             break;
         case PROP_RATE:
             g_mutex_lock(&self->lock);
@@ -561,7 +1096,12 @@ static void player_set_property(GObject *object, guint prop_id,
             break;
         case PROP_MUTE:
             GST_DEBUG_OBJECT (self, "Set mute=%d", g_value_get_boolean(value));
-            g_object_set_property(G_OBJECT (self->playbin), "mute", value);
+            g_mutex_lock(&self->lock);
+            self->mute = g_value_get_boolean(value);
+            apply = self->playbin != NULL;
+            g_mutex_unlock(&self->lock);
+            if (apply)
+                player_invoke(self, player_set_mute_internal);
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -572,6 +1112,7 @@ static void player_set_property(GObject *object, guint prop_id,
 static void player_get_property(GObject *object, guint prop_id,
                                 GValue *value, GParamSpec *pspec) {
     Player *self = GST_PLAYER (object);
+    GstElement *playbin;
 
     switch (prop_id) {
         case PROP_URI:
@@ -582,7 +1123,11 @@ static void player_get_property(GObject *object, guint prop_id,
         case PROP_POSITION: {
             gint64 position = GST_CLOCK_TIME_NONE;
 
-            gst_element_query_position(self->playbin, GST_FORMAT_TIME, &position);
+            playbin = player_ref_playbin(self);
+            if (playbin) {
+                gst_element_query_position(playbin, GST_FORMAT_TIME, &position);
+                gst_object_unref(playbin);
+            }
             g_value_set_uint64(value, position);
             GST_TRACE_OBJECT (self, "Returning position=%" GST_TIME_FORMAT,
                               GST_TIME_ARGS(g_value_get_uint64(value)));
@@ -606,7 +1151,9 @@ static void player_get_property(GObject *object, guint prop_id,
             break;
         }
         case PROP_VOLUME:
-            g_object_get_property(G_OBJECT (self->playbin), "volume", value);
+            g_mutex_lock(&self->lock);
+            g_value_set_double(value, self->volume);
+            g_mutex_unlock(&self->lock);
             GST_TRACE_OBJECT (self, "Returning volume=%lf",
                               g_value_get_double(value));
             break;
@@ -616,11 +1163,14 @@ static void player_get_property(GObject *object, guint prop_id,
             g_mutex_unlock(&self->lock);
             break;
         case PROP_MUTE:
-            g_object_get_property(G_OBJECT (self->playbin), "mute", value);
+            g_mutex_lock(&self->lock);
+            g_value_set_boolean(value, self->mute);
+            g_mutex_unlock(&self->lock);
             GST_TRACE_OBJECT (self, "Returning mute=%d", g_value_get_boolean(value));
             break;
         case PROP_PIPELINE:
-            g_value_set_object(value, self->playbin);
+            player_ensure_pipeline(self);
+            g_value_take_object(value, player_ref_playbin(self));
             break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -628,37 +1178,6 @@ static void player_get_property(GObject *object, guint prop_id,
     }
 }
 
-static gboolean main_loop_running_cb(gpointer user_data) {
-    Player *self = GST_PLAYER (user_data);
-
-    GST_TRACE_OBJECT (self, "Main loop running now");
-
-    g_mutex_lock(&self->lock);
-    g_cond_signal(&self->cond);
-    g_mutex_unlock(&self->lock);
-
-    return G_SOURCE_REMOVE;
-}
-
-typedef struct {
-    Player *player;
-    PlayerState state;
-} StateChangedSignalData;
-
-static void state_changed_dispatch(gpointer user_data) {
-    StateChangedSignalData *data = user_data;
-
-    if (data->player->inhibit_sigs && data->state != PLAYER_STATE_STOPPED
-        && data->state != PLAYER_STATE_PAUSED)
-        return;
-
-    g_signal_emit(data->player, signals[SIGNAL_STATE_CHANGED], 0, data->state);
-}
-
-static void state_changed_signal_data_free(StateChangedSignalData *data) {
-    g_object_unref(data->player);
-    g_free(data);
-}
 
 static void change_state(Player *self, PlayerState state) {
     if (state == self->app_state)
@@ -669,40 +1188,62 @@ static void change_state(Player *self, PlayerState state) {
                       player_state_get_name(state));
     self->app_state = state;
 
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_STATE_CHANGED], 0, NULL, NULL, NULL) != 0) {
-        StateChangedSignalData *data = g_new (StateChangedSignalData, 1);
+    if (player_has_subscriber(self, SIGNAL_STATE_CHANGED)) {
+        PlayerEvent *event = player_event_new(self, PLAYER_EVENT_STATE_CHANGED);
 
-        data->player = g_object_ref(self);
-        data->state = state;
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          state_changed_dispatch, data,
-                                          (GDestroyNotify) state_changed_signal_data_free);
+        event->payload.state = state;
+        player_post_event(self, event);
     }
 }
 
-typedef struct {
-    Player *player;
-    GstClockTime position;
-} PositionUpdatedSignalData;
+static void offline_progress_start(Player *self) {
+    gint64 position = 0;
+
+    if (!self->offline || GST_CLOCK_TIME_IS_VALID (self->offline_start_time))
+        return;
 
-static void position_updated_dispatch(gpointer user_data) {
-    PositionUpdatedSignalData *data = user_data;
+    gst_element_query_position(self->playbin, GST_FORMAT_TIME, &position);
+    self->offline_start_time = gst_util_get_timestamp();
+    self->offline_start_position = position;
+}
+
+static void offline_progress_update(Player *self, GstClockTime position) {
+    GstClockTime elapsed;
 
-    if (data->player->inhibit_sigs)
+    if (!self->offline || !GST_CLOCK_TIME_IS_VALID (self->offline_start_time)
+        || position < self->offline_start_position)
         return;
 
-    if (data->player->target_state >= GST_STATE_PAUSED) {
-        g_signal_emit(data->player, signals[SIGNAL_POSITION_UPDATED], 0,
-                      data->position);
-        g_object_notify_by_pspec(G_OBJECT (data->player),
-                                 param_specs[PROP_POSITION]);
-    }
+    elapsed = gst_util_get_timestamp() - self->offline_start_time;
+    if (elapsed == 0)
+        return;
+
+    g_mutex_lock(&self->lock);
+    self->realtime_factor =
+            (gdouble) (position - self->offline_start_position) / (gdouble) elapsed;
+    g_mutex_unlock(&self->lock);
 }
 
-static void position_updated_signal_data_free(PositionUpdatedSignalData *data) {
-    g_object_unref(data->player);
-    g_free(data);
+static void offline_progress_reset(Player *self) {
+    self->offline_start_time = GST_CLOCK_TIME_NONE;
+    self->offline_start_position = GST_CLOCK_TIME_NONE;
+
+    g_mutex_lock(&self->lock);
+    self->realtime_factor = 0.0;
+    g_mutex_unlock(&self->lock);
+}
+
+/* The work of a position tick after the query, split out so the bench
+ * can time it without a pipeline */
+void player_announce_position(Player *self, GstClockTime position) {
+    offline_progress_update(self, position);
+
+    if (player_has_subscriber(self, SIGNAL_POSITION_UPDATED)) {
+        PlayerEvent *event = player_event_new(self, PLAYER_EVENT_POSITION_UPDATED);
+
+        event->payload.position = position;
+        player_post_event(self, event);
+    }
 }
 
 static gboolean tick_cb(gpointer user_data) {
@@ -715,16 +1256,7 @@ static gboolean tick_cb(gpointer user_data) {
         GST_LOG_OBJECT (self, "Position %" GST_TIME_FORMAT,
                         GST_TIME_ARGS(position));
 
-        if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                                  signals[SIGNAL_POSITION_UPDATED], 0, NULL, NULL, NULL) != 0) {
-            PositionUpdatedSignalData *data = g_new (PositionUpdatedSignalData, 1);
-
-            data->player = g_object_ref(self);
-            data->position = position;
-            player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                              position_updated_dispatch, data,
-                                              (GDestroyNotify) position_updated_signal_data_free);
-        }
+        player_announce_position(self, position);
     }
 
     return G_SOURCE_CONTINUE;
@@ -737,7 +1269,7 @@ static void add_tick_source(Player *self) {
         return;
 
     position_update_interval_ms =
-            player_config_get_position_update_interval(self->config);
+            self->compiled_config.position_update_interval;
     if (!position_update_interval_ms)
         return;
 
@@ -755,8 +1287,100 @@ static void remove_tick_source(Player *self) {
     self->tick_source = NULL;
 }
 
+/*
+ * Players idling in READY after a stop keep their devices open and restart
+ * quickly. Across all players they are kept in LRU order, least recently
+ * stopped first, and beyond the budget the oldest one is released to
+ * NULL, preferring players not hinted to stay warm. Entries are plain
+ * pointers, removed before their player is finalized; a reference for
+ * releasing one is taken through its weak self reference.
+ */
+typedef struct {
+    GMutex lock;
+    GQueue players;         /* Player */
+    guint max_warm;         /* 0 for no limit */
+
+    guint64 n_evictions;
+    guint64 n_expired;
+} WarmPool;
+
+static WarmPool *warm_pool_get(void) {
+    static gsize initialized = 0;
+    static WarmPool pool;
+
+    if (g_once_init_enter (&initialized)) {
+        g_mutex_init(&pool.lock);
+        g_queue_init(&pool.players);
+        g_once_init_leave (&initialized, 1);
+    }
+
+    return &pool;
+}
+
+static void warm_pool_remove(Player *self) {
+    WarmPool *pool = warm_pool_get();
+
+    g_mutex_lock(&pool->lock);
+    if (self->warm_link) {
+        g_queue_delete_link(&pool->players, self->warm_link);
+        self->warm_link = NULL;
+    }
+    g_mutex_unlock(&pool->lock);
+}
+
+/* Must be called with pool lock. Returns a reference to the player to
+ * release, or NULL. */
+static Player *warm_pool_evict_locked(WarmPool *pool) {
+    Player *victim = NULL, *ref;
+    GList *l;
+
+    while (pool->max_warm > 0 && pool->players.length > pool->max_warm) {
+        for (l = pool->players.head; l != NULL; l = l->next) {
+            if (g_atomic_int_get(&((Player *) l->data)->idle_hint) != PLAYER_IDLE_HINT_KEEP_WARM)
+                break;
+        }
+        if (!l)
+            l = pool->players.head;
+
+        victim = l->data;
+        g_queue_delete_link(&pool->players, l);
+        victim->warm_link = NULL;
+        pool->n_evictions++;
+
+        ref = g_weak_ref_get(&victim->self_ref);
+        if (ref)
+            return ref;
+    }
+
+    return NULL;
+}
+
+static gboolean player_release_idle(gpointer user_data);
+
+static void warm_pool_add(Player *self) {
+    WarmPool *pool = warm_pool_get();
+    Player *victim;
+
+    g_mutex_lock(&pool->lock);
+    if (self->warm_link)
+        g_queue_unlink(&pool->players, self->warm_link);
+    else
+        self->warm_link = g_list_alloc();
+    self->warm_link->data = self;
+    g_queue_push_tail_link(&pool->players, self->warm_link);
+    victim = warm_pool_evict_locked(pool);
+    g_mutex_unlock(&pool->lock);
+
+    if (victim) {
+        GST_DEBUG_OBJECT (self, "Warm budget exceeded, releasing %" GST_PTR_FORMAT, victim);
+        player_invoke(victim, player_release_idle);
+        gst_object_unref(victim);
+    }
+}
+
 static gboolean ready_timeout_cb(gpointer user_data) {
     Player *self = user_data;
+    WarmPool *pool = warm_pool_get();
 
     if (self->target_state <= GST_STATE_READY) {
         GST_DEBUG_OBJECT (self, "Setting pipeline to NULL state");
@@ -765,20 +1389,51 @@ static gboolean ready_timeout_cb(gpointer user_data) {
         gst_element_set_state(self->playbin, GST_STATE_NULL);
     }
 
+    g_mutex_lock(&pool->lock);
+    if (self->warm_link) {
+        pool->n_expired++;
+        g_queue_delete_link(&pool->players, self->warm_link);
+        self->warm_link = NULL;
+    }
+    g_mutex_unlock(&pool->lock);
+
     return G_SOURCE_REMOVE;
 }
 
+/* Starts idling in READY after a stop, for as long as the idle hint and
+ * timeout allow */
 static void add_ready_timeout_source(Player *self) {
+    guint timeout;
+
     if (self->ready_timeout_source)
         return;
 
-    self->ready_timeout_source = g_timeout_source_new_seconds(60);
+    switch (g_atomic_int_get(&self->idle_hint)) {
+        case PLAYER_IDLE_HINT_KEEP_WARM:
+            warm_pool_add(self);
+            return;
+        case PLAYER_IDLE_HINT_RELEASE:
+            timeout = 0;
+            break;
+        default:
+            timeout = self->compiled_config.idle_timeout;
+            warm_pool_add(self);
+            break;
+    }
+
+    /* Whole seconds let GLib coalesce the wakeups of many players */
+    if (timeout > 0 && timeout % 1000 == 0)
+        self->ready_timeout_source = g_timeout_source_new_seconds(timeout / 1000);
+    else
+        self->ready_timeout_source = g_timeout_source_new(timeout);
     g_source_set_callback(self->ready_timeout_source,
                           (GSourceFunc) ready_timeout_cb, self, NULL);
     g_source_attach(self->ready_timeout_source, self->context);
 }
 
 static void remove_ready_timeout_source(Player *self) {
+    warm_pool_remove(self);
+
     if (!self->ready_timeout_source)
         return;
 
@@ -787,38 +1442,40 @@ static void remove_ready_timeout_source(Player *self) {
     self->ready_timeout_source = NULL;
 }
 
-typedef struct {
-    Player *player;
-    GError *err;
-} ErrorSignalData;
-
-static void error_dispatch(gpointer user_data) {
-    ErrorSignalData *data = user_data;
+/* Releases the pipeline of an idle player right away, on its thread */
+static gboolean player_release_idle(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
 
-    if (data->player->inhibit_sigs)
-        return;
+    remove_ready_timeout_source(self);
+    if (self->playbin && self->current_state == GST_STATE_READY)
+        ready_timeout_cb(self);
 
-    g_signal_emit(data->player, signals[SIGNAL_ERROR], 0, data->err);
+    return G_SOURCE_REMOVE;
 }
 
-static void free_error_signal_data(ErrorSignalData *data) {
-    g_object_unref(data->player);
-    g_clear_error(&data->err);
-    g_free(data);
+/* Arms the idle timeout again after a hint or timeout change, if idle */
+static gboolean player_rearm_idle_timeout(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+
+    if (!self->playbin || self->current_state != GST_STATE_READY
+        || self->target_state > GST_STATE_READY)
+        return G_SOURCE_REMOVE;
+
+    remove_ready_timeout_source(self);
+    add_ready_timeout_source(self);
+
+    return G_SOURCE_REMOVE;
 }
 
 static void emit_error(Player *self, GError *err) {
     GST_ERROR_OBJECT (self, "Error: %s (%s, %d)", err->message,
                       g_quark_to_string(err->domain), err->code);
 
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_ERROR], 0, NULL, NULL, NULL) != 0) {
-        ErrorSignalData *data = g_new (ErrorSignalData, 1);
+    if (player_has_subscriber(self, SIGNAL_ERROR)) {
+        PlayerEvent *event = player_event_new(self, PLAYER_EVENT_ERROR);
 
-        data->player = g_object_ref(self);
-        data->err = g_error_copy(err);
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          error_dispatch, data, (GDestroyNotify) free_error_signal_data);
+        event->payload.error = g_error_copy(err);
+        player_post_event(self, event);
     }
 
     g_error_free(err);
@@ -844,11 +1501,14 @@ static void emit_error(Player *self, GError *err) {
         gst_tag_list_unref(self->global_tags);
         self->global_tags = NULL;
     }
+    g_clear_pointer(&self->artwork, player_artwork_free);
+    g_clear_object(&self->published_info);
 
     self->seek_pending = FALSE;
     remove_seek_source(self);
     self->seek_position = GST_CLOCK_TIME_NONE;
     self->last_seek_time = GST_CLOCK_TIME_NONE;
+    player_reset_mirrors_locked(self);
     g_mutex_unlock(&self->lock);
 }
 
@@ -863,41 +1523,350 @@ static void dump_dot_file(Player *self, const gchar *name) {
     g_free(full_name);
 }
 
-typedef struct {
-    Player *player;
-    GError *err;
-} WarningSignalData;
+static void emit_warning(Player *self, GError *err) {
+    GST_ERROR_OBJECT (self, "Warning: %s (%s, %d)", err->message,
+                      g_quark_to_string(err->domain), err->code);
 
-static void warning_dispatch(gpointer user_data) {
-    WarningSignalData *data = user_data;
+    if (player_has_subscriber(self, SIGNAL_WARNING)) {
+        PlayerEvent *event = player_event_new(self, PLAYER_EVENT_WARNING);
 
-    if (data->player->inhibit_sigs)
-        return;
+        event->payload.error = g_error_copy(err);
+        player_post_event(self, event);
+    }
+
+    g_error_free(err);
+}
+
+/* Switches to @location, taking ownership, without a full stop: the
+ * pipeline only drops to READY for the new source, and position, rate
+ * and the selected audio track carry over. */
+static void player_switch_location(Player *self, gchar *location) {
+    GstState target_state = self->target_state;
+    GstClockTime position = GST_CLOCK_TIME_NONE;
+    PlayerAudioInfo *audio;
+    gint audio_track = -1;
+
+    if (!self->is_live && self->current_state >= GST_STATE_PAUSED)
+        position = player_get_position(self);
+    audio = player_get_current_audio_track(self);
+    if (audio) {
+        audio_track = player_stream_info_get_index(GST_PLAYER_STREAM_INFO (audio));
+        g_object_unref(audio);
+    }
+
+    tick_cb(self);
+    remove_tick_source(self);
+
+    self->current_state = GST_STATE_READY;
+    self->is_eos = FALSE;
+    gst_bus_set_flushing(self->bus, TRUE);
+    gst_element_set_state(self->playbin, GST_STATE_READY);
+    gst_bus_set_flushing(self->bus, FALSE);
+    buffering_policy_reset(&self->buffering_policy);
+
+    g_mutex_lock(&self->lock);
+    g_free(self->redirect_uri);
+    self->redirect_uri = location;
+    self->redirect_audio_track = audio_track;
+    self->seek_pending = FALSE;
+    remove_seek_source(self);
+    /* Seeking after preroll also applies the rate */
+    if (GST_CLOCK_TIME_IS_VALID (position) && (position > 0 || self->rate != 1.0))
+        self->seek_position = position;
+    g_mutex_unlock(&self->lock);
+
+    /* The URI is set by player_apply_source_config() */
+    if (target_state == GST_STATE_PAUSED)
+        player_pause_internal(self);
+    else if (target_state == GST_STATE_PLAYING)
+        player_play_internal(self);
+}
+
+/* Must be called with lock. Forgets the mirror race outcome, probes
+ * still running are ignored when they complete. */
+static void player_reset_mirrors_locked(Player *self) {
+    if (self->mirrors)
+        mirror_list_reset(self->mirrors);
+    self->mirror_generation++;
+    self->mirror_probes = 0;
+    self->mirror_next = -1;
+}
+
+/* Must be called with lock */
+static void player_choose_mirror_locked(Player *self, gint index, const gchar *location) {
+    Mirror *mirror = &self->mirrors->mirrors[index];
+    gchar *cached = redirect_cache_lookup(location);
+
+    GST_DEBUG_OBJECT (self, "Using mirror %d '%s'", index, mirror->uri);
+
+    self->mirrors->current = index;
+    mirror->n_wins++;
+    g_free(self->redirect_uri);
+    self->redirect_uri = cached ? cached : g_strdup(location);
+    g_free(self->redirect_cache_key);
+    self->redirect_cache_key = cached ? g_strdup(location) : NULL;
+}
+
+typedef struct {
+    GWeakRef player;
+    guint generation;
+    gint index;
+} MirrorProbeData;
+
+static void mirror_probe_cb(GObject *source, GAsyncResult *result, gpointer user_data);
+
+/* Must be called with lock from the main context. Keeps up to
+ * MIRROR_RACE_WIDTH probes running. Returns TRUE if a mirror that can't
+ * be probed was chosen right away. */
+static gboolean player_probe_mirrors_locked(Player *self) {
+    gchar *user_agent = g_strdup(self->compiled_config.user_agent);
+    gboolean cached = self->compiled_config.http_cache;
+    GstContext *context = NULL;
+    gboolean chosen = FALSE;
+
+    g_mutex_lock(&http_context_lock);
+    if (http_context)
+        context = gst_context_ref(http_context);
+    g_mutex_unlock(&http_context_lock);
+
+    while (self->mirror_probes < MIRROR_RACE_WIDTH) {
+        gint next = mirror_list_next_candidate(self->mirrors, self->mirror_next);
+        MirrorProbeData *data;
+        Mirror *mirror;
+
+        if (next < 0)
+            break;
+        mirror = &self->mirrors->mirrors[next];
+
+        /* Local files and streaming protocols win once the probes of the
+         * mirrors preferred over them failed */
+        if (!uri_is_http(mirror->uri)) {
+            if (self->mirror_probes == 0) {
+                self->mirror_next = next;
+                player_choose_mirror_locked(self, next, mirror->uri);
+                chosen = TRUE;
+            }
+            break;
+        }
+
+        data = g_new0 (MirrorProbeData, 1);
+        g_weak_ref_init(&data->player, self);
+        data->generation = self->mirror_generation;
+        data->index = next;
+
+        self->mirror_next = next;
+        self->mirror_probes++;
+        mirror_probe_async(NULL, mirror->uri, user_agent, cached, context, NULL,
+                           mirror_probe_cb, data);
+    }
 
-    g_signal_emit(data->player, signals[SIGNAL_WARNING], 0, data->err);
+    if (context)
+        gst_context_unref(context);
+    g_free(user_agent);
+
+    return chosen;
+}
+
+static void player_resume_target_state(Player *self) {
+    if (self->target_state == GST_STATE_PAUSED)
+        player_pause_internal(self);
+    else if (self->target_state == GST_STATE_PLAYING)
+        player_play_internal(self);
 }
 
-static void free_warning_signal_data(WarningSignalData *data) {
-    g_object_unref(data->player);
-    g_clear_error(&data->err);
+static void mirror_probe_cb(G_GNUC_UNUSED GObject *source, GAsyncResult *result,
+                            gpointer user_data) {
+    MirrorProbeData *data = user_data;
+    Player *self = g_weak_ref_get(&data->player);
+    gchar *final_uri = NULL;
+    GstContext *context = NULL;
+    GError *err = NULL;
+    GstClockTime ttfb;
+    gboolean chosen = FALSE, exhausted = FALSE;
+
+    ttfb = mirror_probe_finish(result, &final_uri, &context, &err);
+    if (context) {
+        share_http_context(context);
+        gst_context_unref(context);
+    }
+    if (!self)
+        goto done;
+
+    g_mutex_lock(&self->lock);
+    if (data->generation != self->mirror_generation || !self->mirrors) {
+        g_mutex_unlock(&self->lock);
+        goto done;
+    }
+
+    self->mirror_probes--;
+    if (GST_CLOCK_TIME_IS_VALID (ttfb)) {
+        GST_DEBUG_OBJECT (self, "Mirror %d first byte after %" GST_TIME_FORMAT,
+                          data->index, GST_TIME_ARGS (ttfb));
+        self->mirrors->mirrors[data->index].ttfb = ttfb;
+        if (self->mirrors->current < 0) {
+            player_choose_mirror_locked(self, data->index, final_uri);
+            chosen = TRUE;
+        }
+    } else {
+        GST_DEBUG_OBJECT (self, "Mirror %d failed: %s", data->index, err->message);
+        self->mirrors->mirrors[data->index].failed = TRUE;
+        self->mirrors->mirrors[data->index].n_failures++;
+        if (self->mirrors->current < 0) {
+            chosen = player_probe_mirrors_locked(self);
+            exhausted = !chosen && self->mirror_probes == 0;
+        }
+    }
+    g_mutex_unlock(&self->lock);
+
+    if (chosen)
+        player_resume_target_state(self);
+    else if (exhausted)
+        emit_error(self, g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                                     "All mirrors failed, last error: %s", err->message));
+
+done:
+    g_clear_error(&err);
+    g_free(final_uri);
+    if (self)
+        g_object_unref(self);
+    g_weak_ref_clear(&data->player);
     g_free(data);
 }
 
-static void emit_warning(Player *self, GError *err) {
-    GST_ERROR_OBJECT (self, "Warning: %s (%s, %d)", err->message,
-                      g_quark_to_string(err->domain), err->code);
+/* Races the mirrors of the current item before its first state change.
+ * Returns TRUE if the state change has to wait for the outcome. */
+static gboolean player_wait_for_mirror(Player *self, GstState target_state) {
+    gboolean wait = FALSE, exhausted = FALSE;
+
+    if (self->current_state >= GST_STATE_PAUSED)
+        return FALSE;
 
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_WARNING], 0, NULL, NULL, NULL) != 0) {
-        WarningSignalData *data = g_new (WarningSignalData, 1);
+    g_mutex_lock(&self->lock);
+    if (self->mirrors && self->mirrors->current < 0) {
+        wait = !player_probe_mirrors_locked(self);
+        exhausted = wait && self->mirror_probes == 0;
+    }
+    g_mutex_unlock(&self->lock);
 
-        data->player = g_object_ref(self);
-        data->err = g_error_copy(err);
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          warning_dispatch, data, (GDestroyNotify) free_warning_signal_data);
+    if (exhausted) {
+        emit_error(self, g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED, "All mirrors failed"));
+    } else if (wait) {
+        remove_ready_timeout_source(self);
+        self->target_state = target_state;
+        change_state(self, PLAYER_STATE_BUFFERING);
     }
 
-    g_error_free(err);
+    return wait;
+}
+
+/* Whether @msg is a resource error of the source, i.e. the mirror could
+ * not be read rather than its media not be played */
+static gboolean error_is_from_source(Player *self, GstMessage *msg, const GError *err) {
+    GstElement *source = NULL;
+    gboolean ret;
+
+    if (err->domain != GST_RESOURCE_ERROR)
+        return FALSE;
+
+    g_object_get(self->playbin, "source", &source, NULL);
+    if (!source)
+        return FALSE;
+    ret = GST_MESSAGE_SRC (msg) == GST_OBJECT (source)
+          || gst_object_has_as_ancestor(GST_MESSAGE_SRC (msg), GST_OBJECT (source));
+    gst_object_unref(source);
+
+    return ret;
+}
+
+/* Switches to the preferred mirror that did not fail yet after a
+ * resource error of the source. Returns FALSE if none is left. */
+static gboolean player_fall_back_to_mirror(Player *self, GstMessage *msg, const GError *err) {
+    gchar *location = NULL;
+
+    if (!error_is_from_source(self, msg, err))
+        return FALSE;
+
+    g_mutex_lock(&self->lock);
+    if (self->mirrors && self->mirrors->current >= 0) {
+        gint next;
+
+        self->mirrors->mirrors[self->mirrors->current].failed = TRUE;
+        self->mirrors->mirrors[self->mirrors->current].n_failures++;
+        next = mirror_list_next_candidate(self->mirrors, -1);
+        if (next >= 0) {
+            GST_DEBUG_OBJECT (self, "Falling back to mirror %d '%s'", next,
+                              self->mirrors->mirrors[next].uri);
+            self->mirrors->current = next;
+            self->http_cache_bypass = FALSE;
+            location = redirect_cache_lookup(self->mirrors->mirrors[next].uri);
+            g_free(self->redirect_cache_key);
+            self->redirect_cache_key = location ? g_strdup(self->mirrors->mirrors[next].uri) : NULL;
+            if (!location)
+                location = g_strdup(self->mirrors->mirrors[next].uri);
+        }
+    }
+    g_mutex_unlock(&self->lock);
+
+    if (!location)
+        return FALSE;
+
+    player_switch_location(self, location);
+
+    return TRUE;
+}
+
+/* Reads the current item without the HTTP cache after playercachesrc
+ * failed on it, e.g. because the server does not support range requests.
+ * Returns FALSE if the error did not come from the cache. */
+static gboolean player_bypass_http_cache(Player *self, GstMessage *msg, const GError *err) {
+    GstElementFactory *factory;
+    gchar *location = NULL;
+
+    if (err->domain != GST_RESOURCE_ERROR || !GST_IS_ELEMENT (GST_MESSAGE_SRC (msg)))
+        return FALSE;
+    factory = gst_element_get_factory(GST_ELEMENT (GST_MESSAGE_SRC (msg)));
+    if (!factory || !g_str_equal(GST_OBJECT_NAME (factory), "playercachesrc"))
+        return FALSE;
+
+    g_mutex_lock(&self->lock);
+    if (!self->http_cache_bypass) {
+        self->http_cache_bypass = TRUE;
+        location = g_strdup(self->redirect_uri ? self->redirect_uri : self->uri);
+    }
+    g_mutex_unlock(&self->lock);
+
+    if (!location)
+        return FALSE;
+
+    GST_INFO_OBJECT (self, "Reading '%s' without the HTTP cache", location);
+    player_switch_location(self, location);
+
+    return TRUE;
+}
+
+/* A remembered redirect may go stale, e.g. a signed CDN URL expires. On
+ * a resource error of the source while playing such a location, the
+ * redirect is forgotten and the URI it was remembered for is played once
+ * more, redirecting afresh. Returns FALSE if there was nothing to retry. */
+static gboolean player_drop_cached_redirect(Player *self, GstMessage *msg, const GError *err) {
+    gchar *key;
+
+    if (!error_is_from_source(self, msg, err))
+        return FALSE;
+
+    g_mutex_lock(&self->lock);
+    key = self->redirect_cache_key;
+    self->redirect_cache_key = NULL;
+    g_mutex_unlock(&self->lock);
+
+    if (!key)
+        return FALSE;
+
+    GST_INFO_OBJECT (self, "Remembered redirect of '%s' failed, retrying it", key);
+    redirect_cache_remove(key);
+    player_switch_location(self, key);
+
+    return TRUE;
 }
 
 static void error_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_data) {
@@ -925,6 +1894,16 @@ static void error_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_d
     if (debug != NULL)
         GST_ERROR_OBJECT (self, "Additional debug info: %s", debug);
 
+    if (player_bypass_http_cache(self, msg, err) || player_drop_cached_redirect(self, msg, err)
+        || player_fall_back_to_mirror(self, msg, err)) {
+        g_clear_error(&err);
+        g_free(debug);
+        g_free(name);
+        g_free(full_message);
+        g_free(message);
+        return;
+    }
+
     player_err =
             g_error_new_literal(PLAYER_ERROR, PLAYER_ERROR_FAILED,
                                 full_message);
@@ -974,15 +1953,6 @@ static void warning_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user
     g_free(message);
 }
 
-static void eos_dispatch(gpointer user_data) {
-    Player *player = user_data;
-
-    if (player->inhibit_sigs)
-        return;
-
-    g_signal_emit(player, signals[SIGNAL_END_OF_STREAM], 0);
-}
-
 static void eos_cb(G_GNUC_UNUSED GstBus *bus, G_GNUC_UNUSED GstMessage *msg,
                    gpointer user_data) {
     Player *self = GST_PLAYER (user_data);
@@ -992,53 +1962,55 @@ static void eos_cb(G_GNUC_UNUSED GstBus *bus, G_GNUC_UNUSED GstMessage *msg,
     tick_cb(self);
     remove_tick_source(self);
 
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_END_OF_STREAM], 0, NULL, NULL, NULL) != 0) {
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          eos_dispatch, g_object_ref(self), (GDestroyNotify) g_object_unref);
-    }
-    change_state(self, PLAYER_STATE_STOPPED);
-    self->buffering = 100;
-    self->is_eos = TRUE;
-}
-
-typedef struct {
-    Player *player;
-    gint percent;
-} BufferingSignalData;
+    if (self->fingerprinter) {
+        PlayerFingerprint *fingerprint = player_fingerprinter_finish(self->fingerprinter);
 
-static void buffering_dispatch(gpointer user_data) {
-    BufferingSignalData *data = user_data;
-
-    if (data->player->inhibit_sigs)
-        return;
+        g_mutex_lock(&self->lock);
+        if (self->media_info) {
+            if (self->media_info->fingerprint)
+                player_fingerprint_unref(self->media_info->fingerprint);
+            self->media_info->fingerprint = fingerprint;
+            fingerprint = NULL;
+        }
+        g_mutex_unlock(&self->lock);
 
-    if (data->player->target_state >= GST_STATE_PAUSED) {
-        g_signal_emit(data->player, signals[SIGNAL_BUFFERING], 0, data->percent);
+        if (fingerprint)
+            player_fingerprint_unref(fingerprint);
+        else
+            emit_media_info_updated_signal(self);
     }
-}
 
-static void buffering_signal_data_free(BufferingSignalData *data) {
-    g_object_unref(data->player);
-    g_free(data);
+    if (player_has_subscriber(self, SIGNAL_END_OF_STREAM))
+        player_post_event(self, player_event_new(self, PLAYER_EVENT_END_OF_STREAM));
+    change_state(self, PLAYER_STATE_STOPPED);
+    self->buffering = 100;
+    self->is_eos = TRUE;
 }
 
 static void buffering_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_data) {
     Player *self = GST_PLAYER (user_data);
+    BufferingAction action;
+    GstClockTime refill_time;
     gint percent;
 
     if (self->target_state < GST_STATE_PAUSED)
         return;
-    if (self->is_live)
+    if (self->is_live || self->low_latency)
         return;
 
-    gst_message_parse_buffering(msg, &percent);
-    GST_LOG_OBJECT (self, "Buffering %d%%", percent);
+    g_mutex_lock(&self->lock);
+    action = buffering_policy_update(&self->buffering_policy, msg);
+    percent = self->buffering_policy.percent;
+    refill_time = self->buffering_policy.refill_time;
+    g_mutex_unlock(&self->lock);
+
+    GST_LOG_OBJECT (self, "Buffering %d%%, refilled in %" GST_TIME_FORMAT,
+                    percent, GST_TIME_ARGS (refill_time));
 
-    if (percent < 100 && self->target_state >= GST_STATE_PAUSED) {
+    if (action == BUFFERING_ACTION_PAUSE && self->target_state >= GST_STATE_PAUSED) {
         GstStateChangeReturn state_ret;
 
-        GST_DEBUG_OBJECT (self, "Waiting for buffering to finish");
+        GST_DEBUG_OBJECT (self, "Waiting for buffering to reach the high watermark");
         state_ret = gst_element_set_state(self->playbin, GST_STATE_PAUSED);
 
         if (state_ret == GST_STATE_CHANGE_FAILURE) {
@@ -1051,28 +2023,25 @@ static void buffering_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer us
     }
 
     if (self->buffering != percent) {
-        if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                                  signals[SIGNAL_BUFFERING], 0, NULL, NULL, NULL) != 0) {
-            BufferingSignalData *data = g_new (BufferingSignalData, 1);
-
-            data->player = g_object_ref(self);
-            data->percent = percent;
-            player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                              buffering_dispatch, data,
-                                              (GDestroyNotify) buffering_signal_data_free);
+        if (player_has_subscriber(self, SIGNAL_BUFFERING)) {
+            PlayerEvent *event = player_event_new(self, PLAYER_EVENT_BUFFERING);
+
+            event->payload.percent = percent;
+            player_post_event(self, event);
         }
 
         self->buffering = percent;
     }
 
+    if (action != BUFFERING_ACTION_RESUME)
+        return;
 
     g_mutex_lock(&self->lock);
-    if (percent == 100 && (self->seek_position != GST_CLOCK_TIME_NONE ||
-                           self->seek_pending)) {
+    if (self->seek_position != GST_CLOCK_TIME_NONE || self->seek_pending) {
         g_mutex_unlock(&self->lock);
 
         GST_DEBUG_OBJECT (self, "Buffering finished - seek pending");
-    } else if (percent == 100 && self->target_state >= GST_STATE_PLAYING
+    } else if (self->target_state >= GST_STATE_PLAYING
                && self->current_state >= GST_STATE_PAUSED) {
         GstStateChangeReturn state_ret;
 
@@ -1084,7 +2053,7 @@ static void buffering_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer us
         if (state_ret == GST_STATE_CHANGE_FAILURE)
             emit_error(self, g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
                                          "Failed to handle buffering"));
-    } else if (percent == 100 && self->target_state >= GST_STATE_PAUSED) {
+    } else if (self->target_state >= GST_STATE_PAUSED) {
         g_mutex_unlock(&self->lock);
 
         GST_DEBUG_OBJECT (self, "Buffering finished - staying PAUSED");
@@ -1117,30 +2086,6 @@ static void notify_caps_cb(G_GNUC_UNUSED GObject *object,
 
 }
 
-typedef struct {
-    Player *player;
-    GstClockTime duration;
-} DurationChangedSignalData;
-
-static void duration_changed_dispatch(gpointer user_data) {
-    DurationChangedSignalData *data = user_data;
-
-    if (data->player->inhibit_sigs)
-        return;
-
-    if (data->player->target_state >= GST_STATE_PAUSED) {
-        g_signal_emit(data->player, signals[SIGNAL_DURATION_CHANGED], 0,
-                      data->duration);
-        g_object_notify_by_pspec(G_OBJECT (data->player),
-                                 param_specs[PROP_DURATION]);
-    }
-}
-
-static void duration_changed_signal_data_free(DurationChangedSignalData *data) {
-    g_object_unref(data->player);
-    g_free(data);
-}
-
 static void emit_duration_changed(Player *self, GstClockTime duration) {
     gboolean updated = FALSE;
 
@@ -1161,46 +2106,20 @@ static void emit_duration_changed(Player *self, GstClockTime duration) {
         emit_media_info_updated_signal(self);
     }
 
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_DURATION_CHANGED], 0, NULL, NULL, NULL) != 0) {
-        DurationChangedSignalData *data = g_new (DurationChangedSignalData, 1);
+    if (player_has_subscriber(self, SIGNAL_DURATION_CHANGED)) {
+        PlayerEvent *event = player_event_new(self, PLAYER_EVENT_DURATION_CHANGED);
 
-        data->player = g_object_ref(self);
-        data->duration = duration;
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          duration_changed_dispatch, data,
-                                          (GDestroyNotify) duration_changed_signal_data_free);
+        event->payload.duration = duration;
+        player_post_event(self, event);
     }
 }
 
-typedef struct {
-    Player *player;
-    GstClockTime position;
-} SeekDoneSignalData;
-
-static void seek_done_dispatch(gpointer user_data) {
-    SeekDoneSignalData *data = user_data;
-
-    if (data->player->inhibit_sigs)
-        return;
-
-    g_signal_emit(data->player, signals[SIGNAL_SEEK_DONE], 0, data->position);
-}
-
-static void seek_done_signal_data_free(SeekDoneSignalData *data) {
-    g_object_unref(data->player);
-    g_free(data);
-}
-
 static void emit_seek_done(Player *self) {
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_SEEK_DONE], 0, NULL, NULL, NULL) != 0) {
-        SeekDoneSignalData *data = g_new (SeekDoneSignalData, 1);
+    if (player_has_subscriber(self, SIGNAL_SEEK_DONE)) {
+        PlayerEvent *event = player_event_new(self, PLAYER_EVENT_SEEK_DONE);
 
-        data->player = g_object_ref(self);
-        data->position = player_get_position(self);
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          seek_done_dispatch, data, (GDestroyNotify) seek_done_signal_data_free);
+        event->payload.position = player_get_position(self);
+        player_post_event(self, event);
     }
 }
 
@@ -1242,6 +2161,14 @@ static void state_changed_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg,
             g_mutex_unlock(&self->lock);
             emit_media_info_updated_signal(self);
 
+            if (self->redirect_audio_track >= 0) {
+                gint audio_track = self->redirect_audio_track;
+
+                self->redirect_audio_track = -1;
+                if (!player_set_audio_track(self, audio_track))
+                    GST_DEBUG_OBJECT (self, "Audio track %d gone after redirect", audio_track);
+            }
+
             g_object_get(self->playbin, "video-sink", &video_sink, NULL);
 
             if (video_sink) {
@@ -1265,6 +2192,8 @@ static void state_changed_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg,
 
         if (new_state == GST_STATE_PAUSED
             && pending_state == GST_STATE_VOID_PENDING) {
+            gboolean seek_done = FALSE;
+
             remove_tick_source(self);
 
             g_mutex_lock(&self->lock);
@@ -1281,31 +2210,38 @@ static void state_changed_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg,
                     player_seek_internal_locked(self);
                 } else {
                     GST_DEBUG_OBJECT (self, "Seek finished");
-                    emit_seek_done(self);
+                    seek_done = TRUE;
                 }
             }
 
+            /* Emitted once unlocked, handlers may call back into the player */
             if (self->seek_position != GST_CLOCK_TIME_NONE) {
                 GST_DEBUG_OBJECT (self, "Seeking now that we reached PAUSED state");
                 player_seek_internal_locked(self);
                 g_mutex_unlock(&self->lock);
+                if (seek_done)
+                    emit_seek_done(self);
             } else if (!self->seek_pending) {
                 g_mutex_unlock(&self->lock);
+                if (seek_done)
+                    emit_seek_done(self);
 
                 tick_cb(self);
 
-                if (self->target_state >= GST_STATE_PLAYING && self->buffering == 100) {
+                if (self->target_state >= GST_STATE_PLAYING && !self->buffering_policy.holding) {
                     GstStateChangeReturn state_ret;
 
                     state_ret = gst_element_set_state(self->playbin, GST_STATE_PLAYING);
                     if (state_ret == GST_STATE_CHANGE_FAILURE)
                         emit_error(self, g_error_new(PLAYER_ERROR,
                                                      PLAYER_ERROR_FAILED, "Failed to play"));
-                } else if (self->buffering == 100) {
+                } else if (!self->buffering_policy.holding) {
                     change_state(self, PLAYER_STATE_PAUSED);
                 }
             } else {
                 g_mutex_unlock(&self->lock);
+                if (seek_done)
+                    emit_seek_done(self);
             }
         } else if (new_state == GST_STATE_PLAYING
                    && pending_state == GST_STATE_VOID_PENDING) {
@@ -1314,6 +2250,7 @@ static void state_changed_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg,
        * if we seeked already but the state-change message was still queued up */
             if (!self->seek_pending) {
                 add_tick_source(self);
+                offline_progress_start(self);
                 change_state(self, PLAYER_STATE_PLAYING);
             }
         } else if (new_state == GST_STATE_READY && old_state > GST_STATE_READY) {
@@ -1386,11 +2323,14 @@ static void tags_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_da
 
     if (gst_tag_list_get_scope(tags) == GST_TAG_SCOPE_GLOBAL) {
         g_mutex_lock(&self->lock);
+        tags = player_take_artwork(self, tags);
         if (self->media_info) {
             media_info_update(self, self->media_info);
             g_mutex_unlock(&self->lock);
             emit_media_info_updated_signal(self);
         } else {
+            /* Only a list that is kept is worth interning */
+            tags = tag_store_intern_tag_list(tags);
             if (self->global_tags)
                 gst_tag_list_unref(self->global_tags);
             self->global_tags = gst_tag_list_ref(tags);
@@ -1401,12 +2341,71 @@ static void tags_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_da
     gst_tag_list_unref(tags);
 }
 
+static void meter_message(Player *self, const GstStructure *s) {
+    gboolean is_level, updated, dispatch = FALSE;
+
+    is_level = gst_structure_has_name(s, "level");
+
+    g_mutex_lock(&self->lock);
+    if (!self->meter)
+        self->meter = player_meter_new();
+    if (is_level)
+        updated = player_meter_update_level(self->meter, s);
+    else
+        updated = player_meter_update_spectrum(self->meter, s);
+
+    /* The last element in the chain completes a reading. It is always
+     * kept for player_get_meter(), but only announced to subscribers. */
+    if (updated && is_level == (self->meter_bands == 0) && !self->meter_dispatch_pending
+        && player_has_subscriber(self, SIGNAL_METER_UPDATED)) {
+        self->meter_dispatch_pending = TRUE;
+        dispatch = TRUE;
+    }
+    g_mutex_unlock(&self->lock);
+
+    /* The reading is taken on delivery, see player_event_resolve() */
+    if (dispatch)
+        player_post_event(self, player_event_new(self, PLAYER_EVENT_METER_UPDATED));
+}
+
+/* Follows a redirect message. The hop is remembered so the next play of
+ * the URI skips it. */
+static void player_redirect(Player *self, const gchar *location) {
+    gchar *from, *resolved;
+
+    g_mutex_lock(&self->lock);
+    from = g_strdup(self->redirect_uri ? self->redirect_uri : self->uri);
+    g_clear_pointer(&self->redirect_cache_key, g_free);
+    g_mutex_unlock(&self->lock);
+
+    /* Reference movies and playlists may point to relative locations */
+    if (gst_uri_is_valid(location))
+        resolved = g_strdup(location);
+    else
+        resolved = g_uri_resolve_relative(from, location, G_URI_FLAGS_NONE, NULL);
+
+    if (!resolved) {
+        GST_WARNING_OBJECT (self, "Can't resolve redirect to '%s'", location);
+        g_free(from);
+        return;
+    }
+
+    GST_DEBUG_OBJECT (self, "Redirect to '%s'", resolved);
+    redirect_cache_insert(from, resolved);
+    g_free(from);
+
+    player_switch_location(self, resolved);
+}
+
 static void element_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_data) {
     Player *self = GST_PLAYER (user_data);
     const GstStructure *s;
 
     s = gst_message_get_structure(msg);
-    if (gst_structure_has_name(s, "redirect")) {
+    if (self->meter_interval > 0
+        && (gst_structure_has_name(s, "level") || gst_structure_has_name(s, "spectrum"))) {
+        meter_message(self, s);
+    } else if (gst_structure_has_name(s, "redirect")) {
         const gchar *new_location;
 
         new_location = gst_structure_get_string(s, "new-location");
@@ -1433,27 +2432,8 @@ static void element_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user
             }
         }
 
-        if (new_location) {
-            GstState target_state;
-
-            GST_DEBUG_OBJECT (self, "Redirect to '%s'", new_location);
-
-            /* Remember target state and restore after setting the URI */
-            target_state = self->target_state;
-
-            player_stop_internal(self, TRUE);
-
-            g_mutex_lock(&self->lock);
-            g_free(self->redirect_uri);
-            self->redirect_uri = g_strdup(new_location);
-            g_object_set(self->playbin, "uri", self->redirect_uri, NULL);
-            g_mutex_unlock(&self->lock);
-
-            if (target_state == GST_STATE_PAUSED)
-                player_pause_internal(self);
-            else if (target_state == GST_STATE_PLAYING)
-                player_play_internal(self);
-        }
+        if (new_location)
+            player_redirect(self, new_location);
     }
 }
 
@@ -1578,46 +2558,53 @@ static void player_clear_flag(Player *self, gint pos) {
     GST_DEBUG_OBJECT (self, "setting flags=%#x", flags);
 }
 
-typedef struct {
-    Player *player;
-    PlayerMediaInfo *info;
-} MediaInfoUpdatedSignalData;
-
-static void media_info_updated_dispatch(gpointer user_data) {
-    MediaInfoUpdatedSignalData *data = user_data;
-
-    if (data->player->inhibit_sigs)
-        return;
-
-    if (data->player->target_state >= GST_STATE_PAUSED) {
-        g_signal_emit(data->player, signals[SIGNAL_MEDIA_INFO_UPDATED], 0,
-                      data->info);
-    }
-}
-
-static void free_media_info_updated_signal_data(MediaInfoUpdatedSignalData *data) {
-    g_object_unref(data->player);
-    g_object_unref(data->info);
-    g_free(data);
-}
-
 /*
  * emit_media_info_updated_signal:
  *
  * create a new copy of self->media_info object and emits the newly created
  * copy to user application. The newly created media_info will be unref'ed
- * as part of signal finalize method.
+ * as part of signal finalize method. Listeners of media-info-changed get
+ * the changes since the previous emission instead, each side is only
+ * computed if somebody listens.
  */
 static void emit_media_info_updated_signal(Player *self) {
-    MediaInfoUpdatedSignalData *data = g_new (MediaInfoUpdatedSignalData, 1);
-    data->player = g_object_ref(self);
+    PlayerEvent *updated = NULL, *changed = NULL;
+    gboolean want_snapshot, want_diff;
+
+    want_snapshot = player_has_subscriber(self, SIGNAL_MEDIA_INFO_UPDATED);
+    want_diff = player_has_subscriber(self, SIGNAL_MEDIA_INFO_CHANGED);
+
     g_mutex_lock(&self->lock);
-    data->info = player_media_info_copy(self->media_info);
+    if (self->media_info)
+        self->media_info->version = ++self->media_info_version;
+
+    if (want_diff && self->media_info) {
+        PlayerMediaInfoDiff *diff = player_media_info_diff_new(self->published_info,
+                                                               self->media_info);
+
+        if (diff) {
+            changed = player_event_new(self, PLAYER_EVENT_MEDIA_INFO_CHANGED);
+            changed->payload.diff = diff;
+            if (self->published_info)
+                g_object_unref(self->published_info);
+            self->published_info = player_media_info_copy(self->media_info);
+        }
+    } else if (!want_diff && self->published_info) {
+        /* Whoever connects next starts from a complete diff */
+        g_object_unref(self->published_info);
+        self->published_info = NULL;
+    }
+
+    if (want_snapshot) {
+        updated = player_event_new(self, PLAYER_EVENT_MEDIA_INFO_UPDATED);
+        updated->payload.media_info = player_media_info_copy(self->media_info);
+    }
     g_mutex_unlock(&self->lock);
 
-    player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                      media_info_updated_dispatch, data,
-                                      (GDestroyNotify) free_media_info_updated_signal_data);
+    if (updated)
+        player_post_event(self, updated);
+    if (changed)
+        player_post_event(self, changed);
 }
 
 static GstCaps *get_caps(Player *self, gint stream_index, GType type) {
@@ -1748,9 +2735,15 @@ static PlayerStreamInfo *player_stream_info_find_from_stream_id(PlayerMediaInfo
 }
 
 static gboolean is_track_enabled(Player *self, gint pos) {
+    GstElement *playbin;
     gint flags;
 
-    g_object_get(G_OBJECT (self->playbin), "flags", &flags, NULL);
+    playbin = player_ref_playbin(self);
+    if (!playbin)
+        return FALSE;
+
+    g_object_get(G_OBJECT (playbin), "flags", &flags, NULL);
+    gst_object_unref(playbin);
 
     if ((flags & pos))
         return TRUE;
@@ -1760,13 +2753,16 @@ static gboolean is_track_enabled(Player *self, gint pos) {
 
 static PlayerStreamInfo *player_stream_info_get_current(Player *self, const gchar *prop,
                                                         GType type) {
+    GstElement *playbin;
     gint current;
     PlayerStreamInfo *info;
 
-    if (!self->media_info)
+    playbin = player_ref_playbin(self);
+    if (!playbin)
         return NULL;
 
-    g_object_get(G_OBJECT (self->playbin), prop, &current, NULL);
+    g_object_get(G_OBJECT (playbin), prop, &current, NULL);
+    gst_object_unref(playbin);
     g_mutex_lock(&self->lock);
     info = player_stream_info_find(self->media_info, type, current);
     if (info)
@@ -1868,11 +2864,11 @@ static void player_stream_info_update_tags_and_caps(Player *self,
                               stream_index, &tags);
     if (s->tags)
         gst_tag_list_unref(s->tags);
-    s->tags = tags;
+    s->tags = tag_store_intern_tag_list(player_take_artwork(self, tags));
 
     if (s->caps)
         gst_caps_unref(s->caps);
-    s->caps = get_caps(self, stream_index, G_OBJECT_TYPE (s));
+    s->caps = tag_store_intern_caps(get_caps(self, stream_index, G_OBJECT_TYPE (s)));
 
     //g_free(s->codec);
     //s->codec = stream_info_get_codec(s);
@@ -1926,11 +2922,11 @@ static void player_stream_info_update_from_stream(Player *self,
                                                   PlayerStreamInfo *s, GstStream *stream) {
     if (s->tags)
         gst_tag_list_unref(s->tags);
-    s->tags = gst_stream_get_tags(stream);
+    s->tags = tag_store_intern_tag_list(player_take_artwork(self, gst_stream_get_tags(stream)));
 
     if (s->caps)
         gst_caps_unref(s->caps);
-    s->caps = gst_stream_get_caps(stream);
+    s->caps = tag_store_intern_caps(gst_stream_get_caps(stream));
 
     //g_free(s->codec);
     //s->codec = stream_info_get_codec(s);
@@ -2041,14 +3037,41 @@ static void *get_from_tags(Player *self, PlayerMediaInfo *media_info,
     return NULL;
 }
 
-static void *get_cover_sample(GstTagList *tags) {
+/* Must be called with lock. Takes @tags and returns them without the
+ * embedded images, unless configured to keep them. The first image seen
+ * becomes the artwork of the current media. */
+static GstTagList *player_take_artwork(Player *self, GstTagList *tags) {
     GstSample *cover_sample = NULL;
 
-    gst_tag_list_get_sample(tags, GST_TAG_IMAGE, &cover_sample);
-    if (!cover_sample)
-        gst_tag_list_get_sample(tags, GST_TAG_PREVIEW_IMAGE, &cover_sample);
+    if (!tags)
+        return NULL;
+
+    if (!self->artwork) {
+        gst_tag_list_get_sample(tags, GST_TAG_IMAGE, &cover_sample);
+        if (!cover_sample)
+            gst_tag_list_get_sample(tags, GST_TAG_PREVIEW_IMAGE, &cover_sample);
+        if (cover_sample) {
+            self->artwork = player_artwork_new(self->uri, cover_sample);
+            gst_sample_unref(cover_sample);
+            GST_DEBUG_OBJECT (self, "artwork %s",
+                              self->artwork ? player_artwork_get_hash(self->artwork) : "unreadable");
+        }
+    }
+
+    if (self->media_info && self->artwork && !self->media_info->artwork)
+        self->media_info->artwork = player_artwork_copy(self->artwork);
+
+    if (self->compiled_config.artwork_in_tags)
+        return tags;
+
+    if (gst_tag_list_get_tag_size(tags, GST_TAG_IMAGE) > 0 ||
+        gst_tag_list_get_tag_size(tags, GST_TAG_PREVIEW_IMAGE) > 0) {
+        tags = gst_tag_list_make_writable(tags);
+        gst_tag_list_remove_tag(tags, GST_TAG_IMAGE);
+        gst_tag_list_remove_tag(tags, GST_TAG_PREVIEW_IMAGE);
+    }
 
-    return cover_sample;
+    return tags;
 }
 
 static PlayerMediaInfo *player_media_info_create(Player *self) {
@@ -2078,6 +3101,8 @@ static PlayerMediaInfo *player_media_info_create(Player *self) {
     media_info->title = get_from_tags(self, media_info, get_title);
     media_info->container =
             get_from_tags(self, media_info, get_container_format);
+    if (self->artwork && !media_info->artwork)
+        media_info->artwork = player_artwork_copy(self->artwork);
 
     GST_DEBUG_OBJECT (self, "uri: %s title: %s duration: %" GST_TIME_FORMAT
             " seekable: %s live: %s container: %s",
@@ -2110,80 +3135,387 @@ static void audio_tags_changed_cb(G_GNUC_UNUSED GstElement *playbin, gint stream
                     GST_TYPE_PLAYER_AUDIO_INFO);
 }
 
-static void volume_changed_dispatch(gpointer user_data) {
-    Player *player = user_data;
+static gboolean volume_changed_cb(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    PlayerEvent *event;
 
-    if (player->inhibit_sigs)
-        return;
+    /* The pipeline may be gone by the time this runs */
+    if (!self->playbin)
+        return G_SOURCE_REMOVE;
+
+    event = player_event_new(self, PLAYER_EVENT_VOLUME_CHANGED);
+    g_object_get(self->playbin, "volume", &event->payload.volume, NULL);
+    player_post_event(self, event);
 
-    g_signal_emit(player, signals[SIGNAL_VOLUME_CHANGED], 0);
-    g_object_notify_by_pspec(G_OBJECT (player), param_specs[PROP_VOLUME]);
+    return G_SOURCE_REMOVE;
 }
 
-static void volume_notify_cb(G_GNUC_UNUSED GObject *obj, G_GNUC_UNUSED GParamSpec *pspec,
+/* playbin notifies volume and mute from whichever thread changed them,
+ * the application's or a streaming thread of the sink. The signals still
+ * go out from the player thread, as all others, so that handlers of the
+ * sync dispatcher run there too. */
+static void volume_notify_cb(GObject *obj, G_GNUC_UNUSED GParamSpec *pspec,
                              Player *self) {
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_VOLUME_CHANGED], 0, NULL, NULL, NULL) != 0) {
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          volume_changed_dispatch, g_object_ref(self),
-                                          (GDestroyNotify) g_object_unref);
-    }
-}
+    gdouble volume;
 
-static void mute_changed_dispatch(gpointer user_data) {
-    Player *player = user_data;
+    /* The sink may change it too, e.g. a sound server's stream volume */
+    g_object_get(obj, "volume", &volume, NULL);
+    g_mutex_lock(&self->lock);
+    self->volume = volume;
+    g_mutex_unlock(&self->lock);
 
-    if (player->inhibit_sigs)
+    if (!player_has_subscriber(self, SIGNAL_VOLUME_CHANGED))
         return;
 
-    g_signal_emit(player, signals[SIGNAL_MUTE_CHANGED], 0);
-    g_object_notify_by_pspec(G_OBJECT (player), param_specs[PROP_MUTE]);
+    if (g_main_context_is_owner(self->context))
+        volume_changed_cb(self);
+    else
+        player_invoke(self, volume_changed_cb);
 }
 
-static void mute_notify_cb(G_GNUC_UNUSED GObject *obj, G_GNUC_UNUSED GParamSpec *pspec,
-                           Player *self) {
-    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
-                              signals[SIGNAL_MUTE_CHANGED], 0, NULL, NULL, NULL) != 0) {
-        player_signal_dispatcher_dispatch(self->signal_dispatcher, self,
-                                          mute_changed_dispatch, g_object_ref(self),
-                                          (GDestroyNotify) g_object_unref);
-    }
+static gboolean mute_changed_cb(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    PlayerEvent *event;
+
+    if (!self->playbin)
+        return G_SOURCE_REMOVE;
+
+    event = player_event_new(self, PLAYER_EVENT_MUTE_CHANGED);
+    g_object_get(self->playbin, "mute", &event->payload.mute, NULL);
+    player_post_event(self, event);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void mute_notify_cb(GObject *obj, G_GNUC_UNUSED GParamSpec *pspec,
+                           Player *self) {
+    gboolean mute;
+
+    g_object_get(obj, "mute", &mute, NULL);
+    g_mutex_lock(&self->lock);
+    self->mute = mute;
+    g_mutex_unlock(&self->lock);
+
+    if (!player_has_subscriber(self, SIGNAL_MUTE_CHANGED))
+        return;
+
+    if (g_main_context_is_owner(self->context))
+        mute_changed_cb(self);
+    else
+        player_invoke(self, mute_changed_cb);
 }
 
-static void source_setup_cb(GstElement *playbin, GstElement *source, Player *self) {
+static void have_context_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg,
+                            G_GNUC_UNUSED gpointer user_data) {
+    GstContext *context;
+
+    gst_message_parse_have_context(msg, &context);
+    GST_DEBUG ("HTTP session of %" GST_PTR_FORMAT, GST_MESSAGE_SRC (msg));
+    share_http_context(context);
+    gst_context_unref(context);
+}
+
+static gboolean source_has_property(GstElement *source, const gchar *name, GType type) {
+    GParamSpec *prop = g_object_class_find_property(G_OBJECT_GET_CLASS (source), name);
+
+    return prop && prop->value_type == type;
+}
+
+/* Pushes the player configuration onto a new source element. Called from
+ * the streaming thread that creates the source. */
+static void player_configure_source(Player *self, GstElement *source) {
     gchar *user_agent;
-    user_agent = player_config_get_user_agent(self->config);
-    if (user_agent) {
-        GParamSpec *prop;
+    guint prefetch;
+
+    g_mutex_lock(&self->lock);
+    user_agent = g_strdup(self->compiled_config.user_agent);
+    prefetch = self->compiled_config.http_prefetch;
+    g_mutex_unlock(&self->lock);
 
-        prop = g_object_class_find_property(G_OBJECT_GET_CLASS (source),
-                                            "user-agent");
-        if (prop && prop->value_type == G_TYPE_STRING) {
+    if (user_agent) {
+        if (source_has_property(source, "user-agent", G_TYPE_STRING)) {
             GST_INFO_OBJECT (self, "Setting source user-agent: %s", user_agent);
             g_object_set(source, "user-agent", user_agent, NULL);
         }
 
         g_free(user_agent);
     }
+
+    /* souphttpsrc: reuse connections across playlist items and players */
+    if (source_has_property(source, "keep-alive", G_TYPE_BOOLEAN)) {
+        g_object_set(source, "keep-alive", TRUE, NULL);
+
+        g_mutex_lock(&http_context_lock);
+        if (http_context)
+            gst_element_set_context(source, http_context);
+        g_mutex_unlock(&http_context_lock);
+    }
+
+    /* playercachesrc */
+    if (source_has_property(source, "prefetch-blocks", G_TYPE_UINT)) {
+        GST_INFO_OBJECT (self, "Prefetching %u blocks", prefetch);
+        g_object_set(source, "prefetch-blocks", prefetch, NULL);
+    }
+
+    if (self->low_latency) {
+        /* rtspsrc and friends default to a 2 second jitterbuffer */
+        if (source_has_property(source, "latency", G_TYPE_UINT)) {
+            guint latency_ms = self->sink_buffer_time / 1000;
+
+            GST_INFO_OBJECT (self, "Setting source latency: %u ms", latency_ms);
+            g_object_set(source, "latency", latency_ms, NULL);
+        }
+    }
 }
 
-static gpointer player_main(gpointer data) {
-    Player *self = GST_PLAYER (data);
-    GstBus *bus;
-    GSource *source;
-    GSource *bus_source;
-    GstElement *scale_tempo;
-    const gchar *env;
+static void source_setup_cb(G_GNUC_UNUSED GstElement *playbin, GstElement *source, Player *self) {
+    player_configure_source(self, source);
+}
 
-    GST_TRACE_OBJECT (self, "Starting main thread");
+static gboolean element_is_network_queue(GstElement *element) {
+    GstElementFactory *factory = gst_element_get_factory(element);
 
-    g_main_context_push_thread_default(self->context);
+    return factory && g_str_equal(GST_OBJECT_NAME (factory), "queue2");
+}
 
-    source = g_idle_source_new();
-    g_source_set_callback(source, (GSourceFunc) main_loop_running_cb, self,
-                          NULL);
-    g_source_attach(source, self->context);
-    g_source_unref(source);
+static gboolean element_is_multiqueue(GstElement *element) {
+    GstElementFactory *factory = gst_element_get_factory(element);
+
+    return factory && g_str_equal(GST_OBJECT_NAME (factory), "multiqueue");
+}
+
+static gboolean element_is_buffer_queue(GstElement *element) {
+    GstElementFactory *factory = gst_element_get_factory(element);
+
+    return factory && (g_str_equal(GST_OBJECT_NAME (factory), "queue")
+                       || g_str_equal(GST_OBJECT_NAME (factory), "multiqueue"));
+}
+
+/* Lowers max-size-bytes of @queue to its share of the memory budget, per
+ * stream for multiqueue. Called from whichever thread adds or reconfigures
+ * the queue. */
+static void queue_apply_memory_budget(GstElement *queue, Player *self) {
+    guint limit, max_bytes;
+
+    g_mutex_lock(&self->lock);
+    if (self->memory_budget == 0) {
+        g_mutex_unlock(&self->lock);
+        return;
+    }
+    limit = element_is_network_queue(queue) ? self->network_queue_limit : self->buffer_queue_limit;
+    g_mutex_unlock(&self->lock);
+
+    g_object_get(queue, "max-size-bytes", &max_bytes, NULL);
+    if (max_bytes == 0 || max_bytes > limit) {
+        GST_DEBUG_OBJECT (self, "Limiting %s to %u bytes", GST_ELEMENT_NAME (queue), limit);
+        g_object_set(queue, "max-size-bytes", limit, NULL);
+    }
+}
+
+/* Must be called with lock. Splits the memory budget between the queues
+ * currently in the pipeline, counting every stream of a multiqueue. */
+static void player_split_memory_budget_locked(Player *self) {
+    guint64 network;
+    guint i, n_network, n_buffer = 0;
+
+    if (self->memory_budget == 0)
+        return;
+
+    for (i = 0; i < self->buffer_queues->len; i++) {
+        GstElement *queue = g_ptr_array_index (self->buffer_queues, i);
+        guint n_streams = 1;
+
+        if (element_is_multiqueue(queue)) {
+            GST_OBJECT_LOCK (queue);
+            n_streams = MAX (queue->numsrcpads, 1);
+            GST_OBJECT_UNLOCK (queue);
+        }
+        n_buffer += n_streams;
+    }
+    n_network = MAX (self->network_queues->len, 1);
+    n_buffer = MAX (n_buffer, 1);
+
+    network = self->memory_budget / MEMORY_BUDGET_NETWORK_SHARE;
+    self->network_queue_limit = (guint) MIN (network / n_network, G_MAXUINT);
+    self->buffer_queue_limit = (guint) MIN ((self->memory_budget - network) / n_buffer, G_MAXUINT);
+}
+
+/* Splits the budget again after a queue or multiqueue stream came or
+ * went, and lowers the limits of all queues to their new share */
+static void player_apply_memory_budget(Player *self) {
+    GPtrArray *queues;
+    guint i;
+
+    queues = g_ptr_array_new_with_free_func(gst_object_unref);
+
+    g_mutex_lock(&self->lock);
+    player_split_memory_budget_locked(self);
+    if (self->memory_budget > 0) {
+        for (i = 0; i < self->network_queues->len; i++)
+            g_ptr_array_add(queues, gst_object_ref(g_ptr_array_index (self->network_queues, i)));
+        for (i = 0; i < self->buffer_queues->len; i++)
+            g_ptr_array_add(queues, gst_object_ref(g_ptr_array_index (self->buffer_queues, i)));
+    }
+    g_mutex_unlock(&self->lock);
+
+    for (i = 0; i < queues->len; i++)
+        queue_apply_memory_budget(g_ptr_array_index (queues, i), self);
+    g_ptr_array_unref(queues);
+}
+
+/* decodebin and urisourcebin raise queue limits as they see fit, the
+ * budget is enforced again whenever they do */
+static void queue_max_size_bytes_notify_cb(GObject *queue, G_GNUC_UNUSED GParamSpec *pspec,
+                                           Player *self) {
+    queue_apply_memory_budget(GST_ELEMENT (queue), self);
+}
+
+/* Every multiqueue stream is limited on its own */
+static void multiqueue_pad_added_cb(G_GNUC_UNUSED GstElement *multiqueue, GstPad *pad, Player *self) {
+    if (GST_PAD_IS_SRC (pad))
+        player_apply_memory_budget(self);
+}
+
+static void deep_element_added_cb(GstBin *playbin, GstBin *sub_bin,
+                                  GstElement *element, Player *self) {
+    GPtrArray *queues;
+
+    if (element_is_network_queue(element))
+        queues = self->network_queues;
+    else if (element_is_buffer_queue(element))
+        queues = self->buffer_queues;
+    else
+        return;
+
+    g_mutex_lock(&self->lock);
+    g_ptr_array_add(queues, gst_object_ref(element));
+    g_mutex_unlock(&self->lock);
+
+    g_signal_connect (element, "notify::max-size-bytes",
+                      G_CALLBACK(queue_max_size_bytes_notify_cb), self);
+    if (element_is_multiqueue(element))
+        g_signal_connect (element, "pad-added", G_CALLBACK(multiqueue_pad_added_cb), self);
+    player_apply_memory_budget(self);
+}
+
+static void deep_element_removed_cb(GstBin *playbin, GstBin *sub_bin,
+                                    GstElement *element, Player *self) {
+    GPtrArray *queues;
+
+    if (element_is_network_queue(element))
+        queues = self->network_queues;
+    else if (element_is_buffer_queue(element))
+        queues = self->buffer_queues;
+    else
+        return;
+
+    g_signal_handlers_disconnect_by_func(element, queue_max_size_bytes_notify_cb, self);
+    g_signal_handlers_disconnect_by_func(element, multiqueue_pad_added_cb, self);
+
+    g_mutex_lock(&self->lock);
+    g_ptr_array_remove_fast(queues, element);
+    player_split_memory_budget_locked(self);
+    g_mutex_unlock(&self->lock);
+}
+
+/* Called from the thread posting @msg. Streaming tasks announce
+ * themselves before they start, which is the only point where their
+ * thread pool can still be replaced. */
+static GstBusSyncReply bus_sync_handler(G_GNUC_UNUSED GstBus *bus, GstMessage *msg,
+                                        gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+
+    switch (GST_MESSAGE_TYPE (msg)) {
+        case GST_MESSAGE_STREAM_STATUS: {
+            GstStreamStatusType type;
+            const GValue *val;
+
+            gst_message_parse_stream_status(msg, &type, NULL);
+            val = gst_message_get_stream_status_object(msg);
+            if (type == GST_STREAM_STATUS_TYPE_CREATE && val && G_VALUE_HOLDS_OBJECT (val)
+                && GST_IS_TASK (g_value_get_object(val)))
+                gst_task_set_pool(GST_TASK (g_value_get_object(val)),
+                                  player_task_pool_get_default());
+            break;
+        }
+        case GST_MESSAGE_STATE_CHANGED:
+            /* Only those of the playbin itself are handled */
+            if (GST_MESSAGE_SRC (msg) != GST_OBJECT (self->playbin))
+                break;
+            return GST_BUS_PASS;
+        default:
+            return GST_BUS_PASS;
+    }
+
+    g_atomic_int_inc(&self->bus_n_dropped);
+    gst_message_unref(msg);
+
+    return GST_BUS_DROP;
+}
+
+static gboolean bus_watch_cb(GstBus *bus, GstMessage *msg, gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    GstClockTime start = gst_util_get_timestamp();
+
+    switch (GST_MESSAGE_TYPE (msg)) {
+        case GST_MESSAGE_ERROR:
+            error_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_WARNING:
+            warning_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_EOS:
+            eos_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_STATE_CHANGED:
+            state_changed_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_BUFFERING:
+            buffering_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_CLOCK_LOST:
+            clock_lost_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_DURATION_CHANGED:
+            duration_changed_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_LATENCY:
+            latency_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_REQUEST_STATE:
+            request_state_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_ELEMENT:
+            element_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_TAG:
+            tags_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_HAVE_CONTEXT:
+            have_context_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_STREAM_COLLECTION:
+            if (self->use_playbin3)
+                stream_collection_cb(bus, msg, self);
+            break;
+        case GST_MESSAGE_STREAMS_SELECTED:
+            if (self->use_playbin3)
+                streams_selected_cb(bus, msg, self);
+            break;
+        default:
+            break;
+    }
+
+    g_atomic_pointer_add(&self->bus_n_messages, 1);
+    g_atomic_pointer_add(&self->bus_handling_time, (gssize) (gst_util_get_timestamp() - start));
+
+    return G_SOURCE_CONTINUE;
+}
+
+/* Must be called with lock */
+static void player_create_pipeline_locked(Player *self) {
+    GstElement *audio_filter;
+    const gchar *env;
 
     env = g_getenv("GST_PLAYER_USE_PLAYBIN3");
     if (env && g_str_has_prefix(env, "1"))
@@ -2201,47 +3533,21 @@ static gpointer player_main(gpointer data) {
         g_assert_not_reached ();
     }
 
-    scale_tempo = gst_element_factory_make("scaletempo", NULL);
-    if (scale_tempo) {
-        g_object_set(self->playbin, "audio-filter", scale_tempo, NULL);
-    } else {
-        g_warning ("Player: scale_tempo element not available. Audio pitch "
-                   "will not be preserved during trick modes");
-    }
+    audio_filter = player_create_audio_filter(0, 0);
+    if (audio_filter)
+        g_object_set(self->playbin, "audio-filter", audio_filter, NULL);
 
-    self->bus = bus = gst_element_get_bus(self->playbin);
-    bus_source = gst_bus_create_watch(bus);
-    g_source_set_callback(bus_source, (GSourceFunc) gst_bus_async_signal_func,
-                          NULL, NULL);
-    g_source_attach(bus_source, self->context);
-
-    g_signal_connect (G_OBJECT(bus), "message::error", G_CALLBACK(error_cb),
-                      self);
-    g_signal_connect (G_OBJECT(bus), "message::warning", G_CALLBACK(warning_cb),
-                      self);
-    g_signal_connect (G_OBJECT(bus), "message::eos", G_CALLBACK(eos_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::state-changed",
-                      G_CALLBACK(state_changed_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::buffering",
-                      G_CALLBACK(buffering_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::clock-lost",
-                      G_CALLBACK(clock_lost_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::duration-changed",
-                      G_CALLBACK(duration_changed_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::latency",
-                      G_CALLBACK(latency_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::request-state",
-                      G_CALLBACK(request_state_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::element",
-                      G_CALLBACK(element_cb), self);
-    g_signal_connect (G_OBJECT(bus), "message::tag", G_CALLBACK(tags_cb), self);
+    /* Before connecting the notify handlers, which take the lock */
+    g_object_set(self->playbin, "volume", self->volume, "mute", self->mute, NULL);
 
-    if (self->use_playbin3) {
-        g_signal_connect (G_OBJECT(bus), "message::stream-collection",
-                          G_CALLBACK(stream_collection_cb), self);
-        g_signal_connect (G_OBJECT(bus), "message::streams-selected",
-                          G_CALLBACK(streams_selected_cb), self);
-    } else {
+    /* Bus messages are handled on the player thread, whenever it runs */
+    self->bus = gst_element_get_bus(self->playbin);
+    gst_bus_set_sync_handler(self->bus, bus_sync_handler, self, NULL);
+    self->bus_source = gst_bus_create_watch(self->bus);
+    g_source_set_callback(self->bus_source, (GSourceFunc) bus_watch_cb, self, NULL);
+    g_source_attach(self->bus_source, self->context);
+
+    if (!self->use_playbin3) {
         g_signal_connect (self->playbin, "audio-changed",
                           G_CALLBACK(audio_changed_cb), self);
         g_signal_connect (self->playbin, "audio-tags-changed",
@@ -2254,22 +3560,60 @@ static gpointer player_main(gpointer data) {
                       G_CALLBACK(mute_notify_cb), self);
     g_signal_connect (self->playbin, "source-setup",
                       G_CALLBACK(source_setup_cb), self);
+    g_signal_connect (self->playbin, "deep-element-added",
+                      G_CALLBACK(deep_element_added_cb), self);
+    g_signal_connect (self->playbin, "deep-element-removed",
+                      G_CALLBACK(deep_element_removed_cb), self);
+}
 
-    self->target_state = GST_STATE_NULL;
-    self->current_state = GST_STATE_NULL;
-    change_state(self, PLAYER_STATE_STOPPED);
-    self->buffering = 100;
-    self->is_eos = FALSE;
-    self->is_live = FALSE;
-    self->rate = 1.0;
+/* Creates the pipeline and starts the thread on first use, so that
+ * players which never get anything to play cost neither. */
+static void player_ensure_pipeline(Player *self) {
+    g_mutex_lock(&self->lock);
+    if (!self->shutting_down && !self->shut_down) {
+        if (!self->playbin)
+            player_create_pipeline_locked(self);
+        player_ensure_thread_locked(self);
+    }
+    g_mutex_unlock(&self->lock);
+}
+
+/* For use outside the player thread, which clears the pipeline on
+ * shutdown. Returns a new reference, or NULL if there is none. */
+static GstElement *player_ref_playbin(Player *self) {
+    GstElement *playbin = NULL;
+
+    g_mutex_lock(&self->lock);
+    if (self->playbin)
+        playbin = gst_object_ref(self->playbin);
+    g_mutex_unlock(&self->lock);
+
+    return playbin;
+}
+
+static gpointer player_main(gpointer data) {
+    Player *self = GST_PLAYER (data);
+    GstElement *playbin;
+    GList *tasks, *l;
 
     GST_TRACE_OBJECT (self, "Starting main loop");
+
+    g_main_context_push_thread_default(self->context);
     g_main_loop_run(self->loop);
+
     GST_TRACE_OBJECT (self, "Stopped main loop");
 
-    g_source_destroy(bus_source);
-    g_source_unref(bus_source);
-    gst_object_unref(bus);
+    g_mutex_lock(&self->lock);
+    if (self->bus_source) {
+        g_source_destroy(self->bus_source);
+        g_source_unref(self->bus_source);
+        self->bus_source = NULL;
+    }
+    if (self->bus) {
+        gst_object_unref(self->bus);
+        self->bus = NULL;
+    }
+    g_mutex_unlock(&self->lock);
 
     remove_tick_source(self);
     remove_ready_timeout_source(self);
@@ -2289,9 +3633,24 @@ static gpointer player_main(gpointer data) {
     self->current_state = GST_STATE_NULL;
     if (self->playbin) {
         gst_element_set_state(self->playbin, GST_STATE_NULL);
-        gst_object_unref(self->playbin);
+        g_mutex_lock(&self->lock);
+        playbin = self->playbin;
         self->playbin = NULL;
+        g_mutex_unlock(&self->lock);
+        gst_object_unref(playbin);
+    }
+
+    g_mutex_lock(&self->lock);
+    self->shut_down = TRUE;
+    tasks = self->shutdown_tasks;
+    self->shutdown_tasks = NULL;
+    g_mutex_unlock(&self->lock);
+
+    for (l = tasks; l != NULL; l = l->next) {
+        g_task_return_boolean(l->data, TRUE);
+        g_object_unref(l->data);
     }
+    g_list_free(tasks);
 
     GST_TRACE_OBJECT (self, "Stopped main thread");
 
@@ -2304,6 +3663,8 @@ static gpointer player_init_once(G_GNUC_UNUSED gpointer user_data) {
     GST_DEBUG_CATEGORY_INIT (player_debug, "player", 0, "Player");
     player_error_quark();
 
+    gst_element_register(NULL, "playercachesrc", GST_RANK_PRIMARY, GST_TYPE_PLAYER_CACHE_SRC);
+
     return NULL;
 }
 
@@ -2322,73 +3683,419 @@ Player *player_new(PlayerSignalDispatcher *signal_dispatcher) {
     return self;
 }
 
-static gboolean player_play_internal(gpointer user_data) {
-    Player *self = GST_PLAYER (user_data);
-    GstStateChangeReturn state_ret;
+static void handler_closure_invalidated(gpointer data, G_GNUC_UNUSED GClosure *closure) {
+    g_atomic_int_add((gint *) data, -1);
+}
 
-    GST_DEBUG_OBJECT (self, "Play");
+/**
+ * player_signal_connect:
+ * @player: #Player instance
+ * @detailed_signal: a signal name of #Player, with optional detail
+ * @c_handler: (scope notified): the handler
+ * @data: user data for @c_handler
+ *
+ * Connects @c_handler like g_signal_connect() and counts it, so the
+ * player knows without asking GObject that the signal has handlers.
+ * Optional: handlers from g_signal_connect() are found as well, only
+ * with a lookup on every emission while no counted handler is connected.
+ * The handler stays counted until it is disconnected by any means.
+ *
+ * Returns: the handler ID, 0 for an unknown signal
+ */
+gulong player_signal_connect(Player *player, const gchar *detailed_signal,
+                             GCallback c_handler, gpointer data) {
+    GClosure *closure;
+    guint signal_id, i;
+    GQuark detail;
+
+    g_return_val_if_fail (GST_IS_PLAYER(player), 0);
+    g_return_val_if_fail (c_handler != NULL, 0);
+
+    if (!g_signal_parse_name(detailed_signal, GST_TYPE_PLAYER, &signal_id, &detail, FALSE)) {
+        g_critical ("%s: signal '%s' is invalid for a Player", G_STRFUNC, detailed_signal);
+        return 0;
+    }
 
-    g_mutex_lock(&self->lock);
-    if (!self->uri) {
-        g_mutex_unlock(&self->lock);
-        return G_SOURCE_REMOVE;
+    closure = g_cclosure_new(c_handler, data, NULL);
+    for (i = 0; i < SIGNAL_LAST; i++) {
+        if (signals[i] != signal_id)
+            continue;
+        g_atomic_int_inc(&player->n_handlers[i]);
+        g_closure_add_invalidate_notifier(closure, &player->n_handlers[i],
+                                          handler_closure_invalidated);
+        break;
     }
-    g_mutex_unlock(&self->lock);
 
-    remove_ready_timeout_source(self);
-    self->target_state = GST_STATE_PLAYING;
+    return g_signal_connect_closure_by_id(player, signal_id, detail, closure, FALSE);
+}
 
-    if (self->current_state < GST_STATE_PAUSED)
-        change_state(self, PLAYER_STATE_BUFFERING);
+/**
+ * player_signal_disconnect:
+ * @player: #Player instance
+ * @handler_id: the ID returned by player_signal_connect()
+ *
+ * Disconnects a handler, same as g_signal_handler_disconnect().
+ */
+void player_signal_disconnect(Player *player, gulong handler_id) {
+    g_return_if_fail (GST_IS_PLAYER(player));
 
-    if (self->current_state >= GST_STATE_PAUSED && !self->is_eos
-        && self->buffering >= 100 && !(self->seek_position != GST_CLOCK_TIME_NONE
-                                       || self->seek_pending)) {
-        state_ret = gst_element_set_state(self->playbin, GST_STATE_PLAYING);
-    } else {
-        state_ret = gst_element_set_state(self->playbin, GST_STATE_PAUSED);
-    }
+    g_signal_handler_disconnect(player, handler_id);
+}
 
-    if (state_ret == GST_STATE_CHANGE_FAILURE) {
-        emit_error(self, g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
-                                     "Failed to play"));
-        return G_SOURCE_REMOVE;
-    } else if (state_ret == GST_STATE_CHANGE_NO_PREROLL) {
-        self->is_live = TRUE;
-        GST_DEBUG_OBJECT (self, "Pipeline is live");
-    }
+/* Must be called from the main context while the pipeline is at most READY */
+static GstElement *player_create_low_latency_audio_sink(guint buffer_time, guint latency_time) {
+    static const gchar *factories[] = {"pulsesink", "alsasink"};
+    GstElement *sink = NULL;
+    guint i;
 
-    if (self->is_eos) {
-        gboolean ret;
+    /* Direct sinks instead of autoaudiosink, so the ring buffer size of
+     * the sink that is actually used can be set */
+    for (i = 0; i < G_N_ELEMENTS (factories) && !sink; i++)
+        sink = gst_element_factory_make(factories[i], "low-latency-audio-sink");
 
-        GST_DEBUG_OBJECT (self, "Was EOS, seeking to beginning");
-        self->is_eos = FALSE;
-        ret =
-                gst_element_seek_simple(self->playbin, GST_FORMAT_TIME,
-                                        GST_SEEK_FLAG_FLUSH, 0);
-        if (!ret) {
-            GST_ERROR_OBJECT (self, "Seek to beginning failed");
-            player_stop_internal(self, TRUE);
-            player_play_internal(self);
-        }
+    if (!sink) {
+        GST_WARNING ("Neither pulsesink nor alsasink available, using default audio sink");
+        return NULL;
     }
 
-    return G_SOURCE_REMOVE;
+    g_object_set(sink, "buffer-time", (gint64) buffer_time,
+                 "latency-time", (gint64) latency_time, NULL);
+
+    return sink;
 }
 
-void player_play(Player *player) {
-    g_return_if_fail (GST_IS_PLAYER(player));
+/* Must be called from the main context while the pipeline is at most READY */
+static void player_apply_sink_config(Player *self) {
+    gboolean offline, fingerprint, low_latency;
+    guint buffer_time, latency_time;
+    PlayerFingerprinter *fingerprinter = NULL;
+    GstElement *audio_sink = NULL;
+    GstElement *video_sink = NULL;
 
-    g_mutex_lock(&player->lock);
-    player->inhibit_sigs = FALSE;
-    g_mutex_unlock(&player->lock);
+    if (self->current_state >= GST_STATE_PAUSED)
+        return;
 
-    g_main_context_invoke_full(player->context, G_PRIORITY_DEFAULT,
-                               player_play_internal, player, NULL);
-}
+    g_mutex_lock(&self->lock);
+    offline = self->compiled_config.offline;
+    fingerprint = offline && self->compiled_config.fingerprint;
+    low_latency = !offline && self->compiled_config.low_latency;
+    buffer_time = self->compiled_config.sink_buffer_time;
+    latency_time = self->compiled_config.sink_latency_time;
+    g_mutex_unlock(&self->lock);
 
-static gboolean player_pause_internal(gpointer user_data) {
-    Player *self = GST_PLAYER (user_data);
+    if (offline == self->offline && fingerprint == (self->fingerprinter != NULL)
+        && low_latency == self->low_latency
+        && (!low_latency || (buffer_time == self->sink_buffer_time
+                             && latency_time == self->sink_latency_time)))
+        return;
+
+    if (offline) {
+        /* Unsynchronized sinks let the pipeline decode as fast as upstream
+         * and the decoders allow instead of following the clock */
+        if (fingerprint) {
+            fingerprinter = player_fingerprinter_new();
+            audio_sink = player_fingerprinter_create_sink(fingerprinter);
+        } else {
+            audio_sink = gst_element_factory_make("fakesink", "offline-audio-sink");
+        }
+        video_sink = gst_element_factory_make("fakesink", "offline-video-sink");
+        if (!audio_sink || !video_sink) {
+            GST_ERROR_OBJECT (self, "Offline sinks not available, staying in realtime mode");
+            if (audio_sink)
+                gst_object_unref(audio_sink);
+            if (video_sink)
+                gst_object_unref(video_sink);
+            if (fingerprinter)
+                player_fingerprinter_unref(fingerprinter);
+            return;
+        }
+        if (!fingerprint)
+            g_object_set(audio_sink, "sync", FALSE, NULL);
+        g_object_set(video_sink, "sync", FALSE, NULL);
+    } else if (low_latency) {
+        audio_sink = player_create_low_latency_audio_sink(buffer_time, latency_time);
+    }
+
+    GST_DEBUG_OBJECT (self, "Switching to %s mode%s",
+                      offline ? "offline" : low_latency ? "low-latency" : "realtime",
+                      fingerprint ? " with fingerprinting" : "");
+
+    /* NULL sinks make playbin fall back to its default auto sinks */
+    g_object_set(self->playbin, "audio-sink", audio_sink, "video-sink", video_sink, NULL);
+
+    /* Without the buffering flag the demuxed data is not buffered. The
+     * network queue2 is kept short by player_apply_buffering_config() and
+     * buffering_cb ignores buffering messages in low-latency mode. */
+    if (low_latency && !self->low_latency) {
+        gint flags;
+
+        g_object_get(self->playbin, "flags", &flags, NULL);
+        self->restore_buffering_flag = (flags & GST_PLAY_FLAG_BUFFERING) != 0;
+        player_clear_flag(self, GST_PLAY_FLAG_BUFFERING);
+    } else if (!low_latency && self->low_latency) {
+        if (self->restore_buffering_flag)
+            player_set_flag(self, GST_PLAY_FLAG_BUFFERING);
+    }
+
+    self->offline = offline;
+    self->low_latency = low_latency;
+    self->sink_buffer_time = buffer_time;
+    self->sink_latency_time = latency_time;
+    if (self->fingerprinter)
+        player_fingerprinter_unref(self->fingerprinter);
+    self->fingerprinter = fingerprinter;
+    offline_progress_reset(self);
+}
+
+static gboolean uri_is_http(const gchar *uri) {
+    return uri && (g_str_has_prefix(uri, "http://") || g_str_has_prefix(uri, "https://"));
+}
+
+/* Must be called from the main context. Goes straight to the final
+ * location of URIs redirected before and routes HTTP URIs through
+ * playercachesrc when the HTTP cache is enabled. */
+static void player_apply_source_config(Player *self) {
+    gchar *uri, *current = NULL;
+
+    if (self->current_state >= GST_STATE_PAUSED)
+        return;
+
+    g_mutex_lock(&self->lock);
+    if (!self->redirect_uri && self->uri) {
+        self->redirect_uri = redirect_cache_lookup(self->uri);
+        if (self->redirect_uri)
+            self->redirect_cache_key = g_strdup(self->uri);
+    }
+    uri = g_strdup(self->redirect_uri ? self->redirect_uri : self->uri);
+    if (self->compiled_config.http_cache && !self->http_cache_bypass && uri_is_http(uri)) {
+        gchar *cached = g_strconcat(PLAYER_CACHE_SRC_SCHEME_PREFIX, uri, NULL);
+
+        g_free(uri);
+        uri = cached;
+    }
+    g_mutex_unlock(&self->lock);
+
+    g_object_get(self->playbin, "uri", &current, NULL);
+    if (g_strcmp0(uri, current) != 0) {
+        GST_DEBUG_OBJECT (self, "Source URI '%s'", GST_STR_NULL(uri));
+        g_object_set(self->playbin, "uri", uri, NULL);
+    }
+
+    g_free(current);
+    g_free(uri);
+}
+
+/* Must be called from the main context after player_apply_sink_config() */
+static void player_apply_buffering_config(Player *self) {
+    gint low_percent, high_percent, buffer_size;
+    gint64 buffer_duration;
+    gboolean download;
+
+    if (self->current_state >= GST_STATE_PAUSED)
+        return;
+
+    g_mutex_lock(&self->lock);
+    low_percent = self->compiled_config.buffering_low_percent;
+    high_percent = self->compiled_config.buffering_high_percent;
+    buffer_size = self->compiled_config.buffer_size;
+    buffer_duration = self->compiled_config.buffer_duration;
+    download = self->compiled_config.progressive_download
+               && uri_is_http(self->redirect_uri ? self->redirect_uri : self->uri);
+    self->memory_budget = self->compiled_config.memory_budget;
+    player_split_memory_budget_locked(self);
+    if (self->memory_budget > 0) {
+        gint limit = (gint) MIN (self->memory_budget / MEMORY_BUDGET_NETWORK_SHARE, G_MAXINT);
+
+        if (buffer_size <= 0 || buffer_size > limit)
+            buffer_size = limit;
+    }
+    buffering_policy_init(&self->buffering_policy, low_percent, high_percent, buffer_size);
+    g_mutex_unlock(&self->lock);
+
+    if (self->low_latency)
+        buffer_duration = (gint64) self->sink_buffer_time * GST_USECOND;
+
+    g_object_set(self->playbin, "buffer-size", buffer_size,
+                 "buffer-duration", buffer_duration, NULL);
+
+    /* playbin only downloads to a temporary file for formats that can be
+     * played while downloading, so this is safe for any HTTP URI. Live
+     * and non-seekable streams keep using the in-memory queue. */
+    if (download && !self->low_latency)
+        player_set_flag(self, GST_PLAY_FLAG_DOWNLOAD);
+    else
+        player_clear_flag(self, GST_PLAY_FLAG_DOWNLOAD);
+
+    GST_DEBUG_OBJECT (self, "Buffering watermarks %d%%/%d%%, size %d, duration %" G_GINT64_FORMAT
+                      ", download %d", low_percent, high_percent, buffer_size,
+                      buffer_duration, download);
+}
+
+/* scaletempo, optionally followed by level and spectrum for metering.
+ * Metering runs inside the playback pipeline so the readings follow
+ * exactly the audio that is rendered. */
+static GstElement *player_create_audio_filter(guint meter_interval, guint meter_bands) {
+    GstElement *scale_tempo, *convert, *level, *spectrum = NULL;
+    GstElement *bin, *first, *last;
+    GstPad *pad;
+
+    scale_tempo = gst_element_factory_make("scaletempo", NULL);
+    if (!scale_tempo)
+        g_warning ("Player: scale_tempo element not available. Audio pitch "
+                   "will not be preserved during trick modes");
+
+    if (meter_interval == 0)
+        return scale_tempo;
+
+    convert = gst_element_factory_make("audioconvert", NULL);
+    level = gst_element_factory_make("level", NULL);
+    if (meter_bands > 0)
+        spectrum = gst_element_factory_make("spectrum", NULL);
+    if (!convert || !level || (meter_bands > 0 && !spectrum)) {
+        g_warning ("Player: level or spectrum element not available, "
+                   "metering disabled");
+        if (convert)
+            gst_object_unref(convert);
+        if (level)
+            gst_object_unref(level);
+        if (spectrum)
+            gst_object_unref(spectrum);
+        return scale_tempo;
+    }
+
+    g_object_set(level, "interval", (guint64) meter_interval * GST_MSECOND,
+                 "post-messages", TRUE, NULL);
+
+    bin = gst_bin_new("audio-filter");
+    first = scale_tempo ? scale_tempo : convert;
+    if (scale_tempo) {
+        gst_bin_add_many(GST_BIN (bin), scale_tempo, convert, NULL);
+        gst_element_link(scale_tempo, convert);
+    } else {
+        gst_bin_add(GST_BIN (bin), convert);
+    }
+    gst_bin_add(GST_BIN (bin), level);
+    gst_element_link(convert, level);
+    last = level;
+
+    if (spectrum) {
+        g_object_set(spectrum, "bands", meter_bands,
+                     "interval", (guint64) meter_interval * GST_MSECOND,
+                     "post-messages", TRUE, "message-magnitude", TRUE,
+                     "message-phase", FALSE, NULL);
+        gst_bin_add(GST_BIN (bin), spectrum);
+        gst_element_link(level, spectrum);
+        last = spectrum;
+    }
+
+    pad = gst_element_get_static_pad(first, "sink");
+    gst_element_add_pad(bin, gst_ghost_pad_new("sink", pad));
+    gst_object_unref(pad);
+    pad = gst_element_get_static_pad(last, "src");
+    gst_element_add_pad(bin, gst_ghost_pad_new("src", pad));
+    gst_object_unref(pad);
+
+    return bin;
+}
+
+/* Must be called from the main context while the pipeline is at most READY */
+static void player_apply_meter_config(Player *self) {
+    guint interval, bands;
+    GstElement *audio_filter;
+
+    if (self->current_state >= GST_STATE_PAUSED)
+        return;
+
+    g_mutex_lock(&self->lock);
+    interval = self->compiled_config.meter_interval;
+    bands = interval > 0 ? self->compiled_config.meter_bands : 0;
+    g_mutex_unlock(&self->lock);
+
+    if (interval == self->meter_interval && bands == self->meter_bands)
+        return;
+
+    GST_DEBUG_OBJECT (self, "Metering every %u ms with %u bands", interval, bands);
+
+    audio_filter = player_create_audio_filter(interval, bands);
+    g_object_set(self->playbin, "audio-filter", audio_filter, NULL);
+    self->meter_interval = interval;
+    self->meter_bands = bands;
+}
+
+static gboolean player_play_internal(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    GstStateChangeReturn state_ret;
+
+    GST_DEBUG_OBJECT (self, "Play");
+
+    g_mutex_lock(&self->lock);
+    if (!self->uri) {
+        g_mutex_unlock(&self->lock);
+        return G_SOURCE_REMOVE;
+    }
+    g_mutex_unlock(&self->lock);
+
+    if (player_wait_for_mirror(self, GST_STATE_PLAYING))
+        return G_SOURCE_REMOVE;
+
+    remove_ready_timeout_source(self);
+    player_apply_source_config(self);
+    player_apply_sink_config(self);
+    player_apply_buffering_config(self);
+    player_apply_meter_config(self);
+    self->target_state = GST_STATE_PLAYING;
+
+    if (self->current_state < GST_STATE_PAUSED)
+        change_state(self, PLAYER_STATE_BUFFERING);
+
+    if (self->current_state >= GST_STATE_PAUSED && !self->is_eos
+        && !self->buffering_policy.holding && !(self->seek_position != GST_CLOCK_TIME_NONE
+                                       || self->seek_pending)) {
+        state_ret = gst_element_set_state(self->playbin, GST_STATE_PLAYING);
+    } else {
+        state_ret = gst_element_set_state(self->playbin, GST_STATE_PAUSED);
+    }
+
+    if (state_ret == GST_STATE_CHANGE_FAILURE) {
+        emit_error(self, g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                                     "Failed to play"));
+        return G_SOURCE_REMOVE;
+    } else if (state_ret == GST_STATE_CHANGE_NO_PREROLL) {
+        self->is_live = TRUE;
+        GST_DEBUG_OBJECT (self, "Pipeline is live");
+    }
+
+    if (self->is_eos) {
+        gboolean ret;
+
+        GST_DEBUG_OBJECT (self, "Was EOS, seeking to beginning");
+        self->is_eos = FALSE;
+        ret =
+                gst_element_seek_simple(self->playbin, GST_FORMAT_TIME,
+                                        GST_SEEK_FLAG_FLUSH, 0);
+        if (!ret) {
+            GST_ERROR_OBJECT (self, "Seek to beginning failed");
+            player_stop_internal(self, TRUE);
+            player_play_internal(self);
+        }
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+void player_play(Player *player) {
+    g_return_if_fail (GST_IS_PLAYER(player));
+
+    g_mutex_lock(&player->lock);
+    player->inhibit_sigs = FALSE;
+    g_mutex_unlock(&player->lock);
+
+    player_ensure_pipeline(player);
+    player_invoke(player, player_play_internal);
+}
+
+static gboolean player_pause_internal(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
     GstStateChangeReturn state_ret;
 
     GST_DEBUG_OBJECT (self, "Pause");
@@ -2400,9 +4107,16 @@ static gboolean player_pause_internal(gpointer user_data) {
     }
     g_mutex_unlock(&self->lock);
 
+    if (player_wait_for_mirror(self, GST_STATE_PAUSED))
+        return G_SOURCE_REMOVE;
+
     tick_cb(self);
     remove_tick_source(self);
     remove_ready_timeout_source(self);
+    player_apply_source_config(self);
+    player_apply_sink_config(self);
+    player_apply_buffering_config(self);
+    player_apply_meter_config(self);
 
     self->target_state = GST_STATE_PAUSED;
 
@@ -2444,8 +4158,8 @@ void player_pause(Player *player) {
     player->inhibit_sigs = FALSE;
     g_mutex_unlock(&player->lock);
 
-    g_main_context_invoke_full(player->context, G_PRIORITY_DEFAULT,
-                               player_pause_internal, player, NULL);
+    player_ensure_pipeline(player);
+    player_invoke(player, player_pause_internal);
 }
 
 static void player_stop_internal(Player *self, gboolean transient) {
@@ -2474,20 +4188,32 @@ static void player_stop_internal(Player *self, gboolean transient) {
                        PLAYER_STATE_STOPPED);
     self->buffering = 100;
     self->cached_duration = GST_CLOCK_TIME_NONE;
+    offline_progress_reset(self);
+    if (self->fingerprinter)
+        player_fingerprint_unref(player_fingerprinter_finish(self->fingerprinter));
     g_mutex_lock(&self->lock);
     if (self->media_info) {
         g_object_unref(self->media_info);
         self->media_info = NULL;
     }
+    if (self->meter) {
+        player_meter_free(self->meter);
+        self->meter = NULL;
+    }
+    buffering_policy_reset(&self->buffering_policy);
     if (self->global_tags) {
         gst_tag_list_unref(self->global_tags);
         self->global_tags = NULL;
     }
+    g_clear_pointer(&self->artwork, player_artwork_free);
+    g_clear_object(&self->published_info);
     self->seek_pending = FALSE;
     remove_seek_source(self);
     self->seek_position = GST_CLOCK_TIME_NONE;
     self->last_seek_time = GST_CLOCK_TIME_NONE;
     self->rate = 1.0;
+    self->redirect_audio_track = -1;
+    player_reset_mirrors_locked(self);
     if (self->collection) {
         if (self->stream_notify_id)
             g_signal_handler_disconnect(self->collection, self->stream_notify_id);
@@ -2519,8 +4245,7 @@ void player_stop(Player *player) {
     player->inhibit_sigs = TRUE;
     g_mutex_unlock(&player->lock);
 
-    g_main_context_invoke_full(player->context, G_PRIORITY_DEFAULT,
-                               player_stop_internal_dispatch, player, NULL);
+    player_invoke(player, player_stop_internal_dispatch);
 }
 
 /* Must be called with lock from main context, releases lock! */
@@ -2563,7 +4288,7 @@ static void player_seek_internal_locked(Player *self) {
 
     flags |= GST_SEEK_FLAG_FLUSH;
 
-    accurate = player_config_get_seek_accurate(self->config);
+    accurate = self->compiled_config.seek_accurate;
 
     if (accurate) {
         flags |= GST_SEEK_FLAG_ACCURATE;
@@ -2699,6 +4424,87 @@ void player_set_uri(Player *player, const gchar *uri) {
     g_object_set(player, "uri", uri, NULL);
 }
 
+/**
+ * player_set_mirrors:
+ * @player: #Player instance
+ * @uris: (array zero-terminated=1): URIs of the same media, most preferred
+ * first
+ *
+ * Sets the media to play from a list of mirrors. On play or pause the
+ * first two HTTP mirrors are probed in parallel and playback starts from
+ * whichever answers first. A mirror that fails, during the race or with
+ * a resource error of the source while playing, is replaced by the next
+ * one and the error is only reported once all mirrors failed. Other
+ * errors, such as a missing decoder, are reported right away. Setting a
+ * single URI with player_set_uri() drops the list.
+ */
+void player_set_mirrors(Player *player, const gchar *const *uris) {
+    g_return_if_fail (GST_IS_PLAYER(player));
+    g_return_if_fail (uris != NULL && uris[0] != NULL);
+
+    g_mutex_lock(&player->lock);
+    g_free(player->uri);
+    g_free(player->redirect_uri);
+    player->redirect_uri = NULL;
+    g_clear_pointer(&player->redirect_cache_key, g_free);
+    player->http_cache_bypass = FALSE;
+    g_free(player->suburi);
+    player->suburi = NULL;
+    if (player->mirrors) {
+        player_reset_mirrors_locked(player);
+        mirror_list_free(player->mirrors);
+    }
+
+    player->uri = g_strdup(uris[0]);
+    player->mirrors = mirror_list_new(uris);
+    GST_DEBUG_OBJECT (player, "Set %u mirrors, first %s", player->mirrors->n_mirrors, player->uri);
+    g_mutex_unlock(&player->lock);
+
+    player_ensure_pipeline(player);
+    player_invoke(player, player_set_uri_internal);
+}
+
+static void mirror_stats_clear(PlayerMirrorStats *stats) {
+    g_free(stats->uri);
+}
+
+/**
+ * player_get_mirror_stats:
+ * @player: #Player instance
+ *
+ * Returns: (transfer full) (nullable): a #PlayerMirrorStats per mirror in
+ * the order given to player_set_mirrors(), or %NULL without a mirror list
+ */
+GArray *player_get_mirror_stats(Player *player) {
+    GArray *stats;
+    guint i;
+
+    g_return_val_if_fail (GST_IS_PLAYER(player), NULL);
+
+    g_mutex_lock(&player->lock);
+    if (!player->mirrors) {
+        g_mutex_unlock(&player->lock);
+        return NULL;
+    }
+
+    stats = g_array_sized_new(FALSE, FALSE, sizeof(PlayerMirrorStats), player->mirrors->n_mirrors);
+    g_array_set_clear_func(stats, (GDestroyNotify) mirror_stats_clear);
+    for (i = 0; i < player->mirrors->n_mirrors; i++) {
+        Mirror *mirror = &player->mirrors->mirrors[i];
+        PlayerMirrorStats entry;
+
+        entry.uri = g_strdup(mirror->uri);
+        entry.ttfb = mirror->ttfb;
+        entry.n_wins = mirror->n_wins;
+        entry.n_failures = mirror->n_failures;
+        entry.current = player->mirrors->current == (gint) i;
+        g_array_append_val(stats, entry);
+    }
+    g_mutex_unlock(&player->lock);
+
+    return stats;
+}
+
 GstClockTime player_get_position(Player *player) {
     GstClockTime val;
 
@@ -2719,87 +4525,309 @@ GstClockTime player_get_duration(Player *player) {
     return val;
 }
 
-gdouble player_get_volume(Player *self) {
+/**
+ * player_get_realtime_factor:
+ * @player: #Player instance
+ *
+ * Returns: in offline mode, the decode throughput since playback started
+ * as a multiple of realtime (e.g. 25.0 means 25x faster than realtime),
+ * or 0.0 if not known yet.
+ */
+gdouble player_get_realtime_factor(Player *player) {
     gdouble val;
 
-    g_return_val_if_fail (GST_IS_PLAYER(self), DEFAULT_VOLUME);
+    g_return_val_if_fail (GST_IS_PLAYER(player), 0.0);
 
-    g_object_get(self, "volume", &val, NULL);
+    g_mutex_lock(&player->lock);
+    val = player->realtime_factor;
+    g_mutex_unlock(&player->lock);
 
     return val;
 }
 
-void player_set_volume(Player *self, gdouble val) {
-    g_return_if_fail (GST_IS_PLAYER(self));
-
-    g_object_set(self, "volume", val, NULL);
-}
-
-gboolean player_get_mute(Player *self) {
-    gboolean val;
+/**
+ * player_get_buffering_time_left:
+ * @player: #Player instance
+ *
+ * Estimates how long it takes until the buffer is filled up to the high
+ * watermark again, from the measured download rate.
+ *
+ * Returns: the estimated time, 0 if the buffer is above the high
+ * watermark or %GST_CLOCK_TIME_NONE if unknown.
+ */
+GstClockTime player_get_buffering_time_left(Player *player) {
+    GstClockTime val;
 
-    g_return_val_if_fail (GST_IS_PLAYER(self), DEFAULT_MUTE);
+    g_return_val_if_fail (GST_IS_PLAYER(player), GST_CLOCK_TIME_NONE);
 
-    g_object_get(self, "mute", &val, NULL);
+    g_mutex_lock(&player->lock);
+    val = player->buffering_policy.refill_time;
+    g_mutex_unlock(&player->lock);
 
     return val;
 }
 
-void player_set_mute(Player *self, gboolean val) {
-    g_return_if_fail (GST_IS_PLAYER(self));
-
-    g_object_set(self, "mute", val, NULL);
-}
-
-GstElement *player_get_pipeline(Player *self) {
-    GstElement *val;
+/**
+ * player_get_buffering_stats:
+ * @player: #Player instance
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Fills @stats with the buffering statistics of the current stream. The
+ * rates and stall counters are aggregated from the buffering messages as
+ * they are handled; only the queue levels are read here.
+ */
+void player_get_buffering_stats(Player *player, PlayerBufferingStats *stats) {
+    const BufferingPolicy *policy;
+    GPtrArray *queues;
+    guint i;
 
-    g_return_val_if_fail (GST_IS_PLAYER(self), NULL);
+    g_return_if_fail (GST_IS_PLAYER(player));
+    g_return_if_fail (stats != NULL);
 
-    g_object_get(self, "pipeline", &val, NULL);
+    g_mutex_lock(&player->lock);
+    policy = &player->buffering_policy;
+    stats->mode = policy->mode;
+    stats->percent = policy->percent;
+    stats->avg_in_rate = policy->avg_in;
+    stats->avg_out_rate = policy->avg_out;
+    stats->buffering_left = policy->buffering_left >= 0
+                            ? (GstClockTime) policy->buffering_left * GST_MSECOND
+                            : GST_CLOCK_TIME_NONE;
+    stats->refill_time = policy->refill_time;
+    stats->n_buffering_messages = policy->n_messages;
+    stats->n_stalls = policy->n_stalls;
+    stats->stall_time = buffering_policy_get_stall_time(policy);
+
+    queues = g_ptr_array_new_with_free_func(gst_object_unref);
+    for (i = 0; i < player->network_queues->len; i++)
+        g_ptr_array_add(queues, gst_object_ref(g_ptr_array_index (player->network_queues, i)));
+    g_mutex_unlock(&player->lock);
 
-    return val;
+    /* Properties are read without the player lock, the queues take their
+     * own lock for them */
+    stats->queue_bytes = 0;
+    stats->queue_time = 0;
+    for (i = 0; i < queues->len; i++) {
+        guint bytes;
+        guint64 time;
+
+        g_object_get(g_ptr_array_index (queues, i), "current-level-bytes", &bytes,
+                     "current-level-time", &time, NULL);
+        stats->queue_bytes += bytes;
+        stats->queue_time += time;
+    }
+    g_ptr_array_unref(queues);
 }
 
-PlayerMediaInfo *player_get_media_info(Player *self) {
-    PlayerMediaInfo *info;
+static guint64 queue_get_level_bytes(GstElement *queue) {
+    guint64 total = 0;
+    GstIterator *it;
+    GValue item = G_VALUE_INIT;
+    guint bytes;
 
-    g_return_val_if_fail (GST_IS_PLAYER(self), NULL);
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS (queue), "current-level-bytes")) {
+        g_object_get(queue, "current-level-bytes", &bytes, NULL);
+        return bytes;
+    }
 
-    if (!self->media_info)
-        return NULL;
+    /* multiqueue reports its levels per sink pad */
+    it = gst_element_iterate_sink_pads(queue);
+    while (gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+        GstPad *pad = g_value_get_object(&item);
 
-    g_mutex_lock(&self->lock);
-    info = player_media_info_copy(self->media_info);
-    g_mutex_unlock(&self->lock);
+        if (g_object_class_find_property(G_OBJECT_GET_CLASS (pad), "current-level-bytes")) {
+            g_object_get(pad, "current-level-bytes", &bytes, NULL);
+            total += bytes;
+        }
+        g_value_reset(&item);
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
 
-    return info;
+    return total;
 }
 
-PlayerAudioInfo *player_get_current_audio_track(Player *self) {
-    PlayerAudioInfo *info;
+/**
+ * player_get_memory_stats:
+ * @player: #Player instance
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Fills @stats with the memory held by the player: data buffered in the
+ * queues of the pipeline and the tags, caps and samples kept for the
+ * current media. The Player-side figures are estimates of the referenced
+ * data, not allocator statistics. Decoder and sink internals are not
+ * covered.
+ */
+void player_get_memory_stats(Player *player, PlayerMemoryStats *stats) {
+    GPtrArray *queues;
+    guint i;
 
-    g_return_val_if_fail (GST_IS_PLAYER(self), NULL);
+    g_return_if_fail (GST_IS_PLAYER(player));
+    g_return_if_fail (stats != NULL);
 
-    if (!is_track_enabled(self, GST_PLAY_FLAG_AUDIO))
-        return NULL;
+    queues = g_ptr_array_new_with_free_func(gst_object_unref);
 
-    if (self->use_playbin3) {
-        info = (PlayerAudioInfo *)
-                player_stream_info_get_current_from_stream_id(self,
-                                                              self->audio_sid, GST_TYPE_PLAYER_AUDIO_INFO);
-    } else {
-        info = (PlayerAudioInfo *) player_stream_info_get_current(self,
-                                                                  "current-audio", GST_TYPE_PLAYER_AUDIO_INFO);
-    }
+    g_mutex_lock(&player->lock);
+    stats->media_info_bytes = player_media_info_estimate_size(player->media_info)
+                              + player_media_info_estimate_size(player->published_info);
+    stats->tag_bytes = player_tag_list_estimate_size(player->global_tags);
+    stats->budget = player->memory_budget;
+    for (i = 0; i < player->network_queues->len; i++)
+        g_ptr_array_add(queues, gst_object_ref(g_ptr_array_index (player->network_queues, i)));
+    for (i = 0; i < player->buffer_queues->len; i++)
+        g_ptr_array_add(queues, gst_object_ref(g_ptr_array_index (player->buffer_queues, i)));
+    g_mutex_unlock(&player->lock);
 
-    return info;
-}
+    stats->queue_bytes = 0;
+    stats->n_queues = queues->len;
+    for (i = 0; i < queues->len; i++)
+        stats->queue_bytes += queue_get_level_bytes(g_ptr_array_index (queues, i));
+    g_ptr_array_unref(queues);
 
-/* Must be called with lock */
-static gboolean player_select_streams(Player *self) {
-    GList *stream_list = NULL;
-    gboolean ret = FALSE;
+    stats->total_bytes = stats->queue_bytes + stats->media_info_bytes + stats->tag_bytes;
+}
+
+/**
+ * player_get_latency:
+ * @player: #Player instance
+ * @live: (out) (optional): whether the pipeline is live
+ *
+ * Queries the current end-to-end latency of the pipeline, as configured
+ * on the sinks from the latency reported by all elements.
+ *
+ * Returns: the minimum latency, or %GST_CLOCK_TIME_NONE if the pipeline
+ * is not prerolled yet.
+ */
+GstClockTime player_get_latency(Player *player, gboolean *live) {
+    GstElement *playbin;
+    GstQuery *query;
+    GstClockTime min_latency = GST_CLOCK_TIME_NONE;
+    gboolean is_live = FALSE;
+
+    g_return_val_if_fail (GST_IS_PLAYER(player), GST_CLOCK_TIME_NONE);
+
+    playbin = player_ref_playbin(player);
+    if (playbin) {
+        query = gst_query_new_latency();
+        if (gst_element_query(playbin, query))
+            gst_query_parse_latency(query, &is_live, &min_latency, NULL);
+        gst_query_unref(query);
+        gst_object_unref(playbin);
+    }
+
+    if (live)
+        *live = is_live;
+
+    return min_latency;
+}
+
+/**
+ * player_get_meter:
+ * @player: #Player instance
+ *
+ * Returns: (transfer full) (nullable): the latest meter reading, or %NULL
+ * if metering is disabled or nothing has been metered yet. Free with
+ * player_meter_free().
+ */
+PlayerMeter *player_get_meter(Player *player) {
+    PlayerMeter *meter = NULL;
+
+    g_return_val_if_fail (GST_IS_PLAYER(player), NULL);
+
+    g_mutex_lock(&player->lock);
+    if (player->meter)
+        meter = player_meter_copy(player->meter);
+    g_mutex_unlock(&player->lock);
+
+    return meter;
+}
+
+gdouble player_get_volume(Player *self) {
+    gdouble val;
+
+    g_return_val_if_fail (GST_IS_PLAYER(self), DEFAULT_VOLUME);
+
+    g_object_get(self, "volume", &val, NULL);
+
+    return val;
+}
+
+void player_set_volume(Player *self, gdouble val) {
+    g_return_if_fail (GST_IS_PLAYER(self));
+
+    g_object_set(self, "volume", val, NULL);
+}
+
+gboolean player_get_mute(Player *self) {
+    gboolean val;
+
+    g_return_val_if_fail (GST_IS_PLAYER(self), DEFAULT_MUTE);
+
+    g_object_get(self, "mute", &val, NULL);
+
+    return val;
+}
+
+void player_set_mute(Player *self, gboolean val) {
+    g_return_if_fail (GST_IS_PLAYER(self));
+
+    g_object_set(self, "mute", val, NULL);
+}
+
+GstElement *player_get_pipeline(Player *self) {
+    GstElement *val;
+
+    g_return_val_if_fail (GST_IS_PLAYER(self), NULL);
+
+    g_object_get(self, "pipeline", &val, NULL);
+
+    return val;
+}
+
+PlayerMediaInfo *player_get_media_info(Player *self) {
+    PlayerMediaInfo *info;
+
+    g_return_val_if_fail (GST_IS_PLAYER(self), NULL);
+
+    if (!self->media_info)
+        return NULL;
+
+    g_mutex_lock(&self->lock);
+    info = player_media_info_copy(self->media_info);
+    g_mutex_unlock(&self->lock);
+
+    return info;
+}
+
+PlayerAudioInfo *player_get_current_audio_track(Player *self) {
+    PlayerAudioInfo *info;
+
+    g_return_val_if_fail (GST_IS_PLAYER(self), NULL);
+
+    if (!is_track_enabled(self, GST_PLAY_FLAG_AUDIO))
+        return NULL;
+
+    if (self->use_playbin3) {
+        info = (PlayerAudioInfo *)
+                player_stream_info_get_current_from_stream_id(self,
+                                                              self->audio_sid, GST_TYPE_PLAYER_AUDIO_INFO);
+    } else {
+        info = (PlayerAudioInfo *) player_stream_info_get_current(self,
+                                                                  "current-audio", GST_TYPE_PLAYER_AUDIO_INFO);
+    }
+
+    return info;
+}
+
+/* Must be called with lock */
+static gboolean player_select_streams(Player *self) {
+    GstElement *playbin;
+    GList *stream_list = NULL;
+    gboolean ret = FALSE;
+
+    if (!self->playbin)
+        return FALSE;
+    playbin = gst_object_ref(self->playbin);
 
     if (self->audio_sid)
         stream_list = g_list_append(stream_list, g_strdup(self->audio_sid));
@@ -2810,12 +4838,13 @@ static gboolean player_select_streams(Player *self) {
 
     g_mutex_unlock(&self->lock);
     if (stream_list) {
-        ret = gst_element_send_event(self->playbin,
+        ret = gst_element_send_event(playbin,
                                      gst_event_new_select_streams(stream_list));
         g_list_free_full(stream_list, g_free);
     } else {
         GST_ERROR_OBJECT (self, "No available streams for select-streams");
     }
+    gst_object_unref(playbin);
     g_mutex_lock(&self->lock);
 
     return ret;
@@ -2843,45 +4872,55 @@ gboolean player_set_audio_track(Player *self, gint stream_index) {
         ret = player_select_streams(self);
         g_mutex_unlock(&self->lock);
     } else {
-        g_object_set(G_OBJECT (self->playbin), "current-audio", stream_index,
-                     NULL);
+        GstElement *playbin = player_ref_playbin(self);
+
+        if (!playbin)
+            return FALSE;
+        g_object_set(G_OBJECT (playbin), "current-audio", stream_index, NULL);
+        gst_object_unref(playbin);
     }
 
     GST_DEBUG_OBJECT (self, "set stream index '%d'", stream_index);
     return ret;
 }
 
-void player_set_audio_track_enabled(Player *self, gboolean enabled) {
-    g_return_if_fail (GST_IS_PLAYER(self));
+/* Called from the application, so the pipeline may be gone already */
+static void player_set_track_enabled(Player *self, gint pos, gboolean enabled) {
+    GstElement *playbin;
+    gint flags;
+
+    player_ensure_pipeline(self);
+    playbin = player_ref_playbin(self);
+    if (!playbin)
+        return;
 
+    g_object_get(playbin, "flags", &flags, NULL);
     if (enabled)
-        player_set_flag(self, GST_PLAY_FLAG_AUDIO);
+        flags |= pos;
     else
-        player_clear_flag(self, GST_PLAY_FLAG_AUDIO);
+        flags &= ~pos;
+    g_object_set(playbin, "flags", flags, NULL);
+    gst_object_unref(playbin);
 
     GST_DEBUG_OBJECT (self, "track is '%s'", enabled ? "Enabled" : "Disabled");
 }
 
-void player_set_video_track_enabled(Player *self, gboolean enabled) {
+void player_set_audio_track_enabled(Player *self, gboolean enabled) {
     g_return_if_fail (GST_IS_PLAYER(self));
 
-    if (enabled)
-        player_set_flag(self, GST_PLAY_FLAG_VIDEO);
-    else
-        player_clear_flag(self, GST_PLAY_FLAG_VIDEO);
+    player_set_track_enabled(self, GST_PLAY_FLAG_AUDIO, enabled);
+}
 
-    GST_DEBUG_OBJECT (self, "track is '%s'", enabled ? "Enabled" : "Disabled");
+void player_set_video_track_enabled(Player *self, gboolean enabled) {
+    g_return_if_fail (GST_IS_PLAYER(self));
+
+    player_set_track_enabled(self, GST_PLAY_FLAG_VIDEO, enabled);
 }
 
 void player_set_subtitle_track_enabled(Player *self, gboolean enabled) {
     g_return_if_fail (GST_IS_PLAYER(self));
 
-    if (enabled)
-        player_set_flag(self, GST_PLAY_FLAG_SUBTITLE);
-    else
-        player_clear_flag(self, GST_PLAY_FLAG_SUBTITLE);
-
-    GST_DEBUG_OBJECT (self, "track is '%s'", enabled ? "Enabled" : "Disabled");
+    player_set_track_enabled(self, GST_PLAY_FLAG_SUBTITLE, enabled);
 }
 
 #define C_ENUM(v) ((gint) v)
@@ -2947,24 +4986,108 @@ const gchar *player_error_get_name(PlayerError error) {
     return NULL;
 }
 
+/* Returns the first key that differs between @a and @b and can't change
+ * while playing, or NULL */
+static const gchar *config_find_restart_change(const GstStructure *a, const GstStructure *b) {
+    gint i;
+
+    for (i = 0; i < CONFIG_QUARK_MAX; i++) {
+        const GValue *va, *vb;
+
+        if (_config_quark_live[i])
+            continue;
+
+        va = gst_structure_id_get_value(a, _config_quark_table[i]);
+        vb = gst_structure_id_get_value(b, _config_quark_table[i]);
+        if (!va && !vb)
+            continue;
+        if (!va || !vb || gst_value_compare(va, vb) != GST_VALUE_EQUAL)
+            return _config_quark_strings[i];
+    }
+
+    return NULL;
+}
+
+/* Applies a config changed while playing. Runs on the player thread, so
+ * the changes take effect between two events. */
+static gboolean player_apply_live_config(gpointer user_data) {
+    Player *self = GST_PLAYER (user_data);
+    guint interval;
+
+    g_mutex_lock(&self->lock);
+    interval = self->compiled_config.position_update_interval;
+    player_config_compile(&self->compiled_config, self->config);
+    /* Keeps the fill level and whether playback is held */
+    self->buffering_policy.low_percent = self->compiled_config.buffering_low_percent;
+    self->buffering_policy.high_percent = self->compiled_config.buffering_high_percent;
+    g_mutex_unlock(&self->lock);
+
+    if (self->tick_source && interval != self->compiled_config.position_update_interval) {
+        remove_tick_source(self);
+        add_tick_source(self);
+    }
+
+    GST_DEBUG_OBJECT (self, "Applied config while playing");
+
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * player_set_config:
+ * @player: #Player instance
+ * @config: (transfer full): a configuration
+ *
+ * Sets the configuration, as returned by player_get_config() and changed
+ * with the player_config_set_*() functions.
+ *
+ * While the player is not stopped, only the position update interval,
+ * seek accuracy, buffering watermarks, user agent and idle timeout can
+ * change. They take effect together without interrupting playback; a new
+ * user agent is sent with the next request and a new idle timeout applies
+ * from the next stop. Any other change requires the player to be stopped
+ * first.
+ *
+ * Returns: %TRUE if the configuration was applied, %FALSE if it requires
+ * the player to be stopped. @config is consumed either way.
+ */
 gboolean player_set_config(Player *self, GstStructure *config) {
+    const gchar *key;
+
     g_return_val_if_fail (GST_IS_PLAYER(self), FALSE);
     g_return_val_if_fail (config != NULL, FALSE);
 
     g_mutex_lock(&self->lock);
 
-    if (self->app_state != PLAYER_STATE_STOPPED) {
-        GST_INFO_OBJECT (self, "can't change config while player is %s",
+    if (self->app_state == PLAYER_STATE_STOPPED) {
+        guint idle_timeout = self->compiled_config.idle_timeout;
+
+        if (self->config)
+            gst_structure_free(self->config);
+        self->config = config;
+        player_config_compile(&self->compiled_config, self->config);
+        g_mutex_unlock(&self->lock);
+
+        if (idle_timeout != self->compiled_config.idle_timeout)
+            player_invoke(self, player_rearm_idle_timeout);
+
+        return TRUE;
+    }
+
+    key = config_find_restart_change(self->config, config);
+    if (key) {
+        GST_INFO_OBJECT (self, "can't change %s while player is %s", key,
                          player_state_get_name(self->app_state));
         g_mutex_unlock(&self->lock);
+        gst_structure_free(config);
         return FALSE;
     }
 
-    if (self->config)
-        gst_structure_free(self->config);
+    gst_structure_free(self->config);
     self->config = config;
     g_mutex_unlock(&self->lock);
 
+    player_invoke(self, player_apply_live_config);
+
     return TRUE;
 }
 
@@ -3043,3 +5166,715 @@ gboolean player_config_get_seek_accurate(const GstStructure *config) {
     return accurate;
 }
 
+
+/**
+ * player_config_set_offline:
+ * @config: a #Player configuration
+ * @offline: %TRUE to decode as fast as possible
+ *
+ * In offline mode the pipeline renders into unsynchronized fake sinks,
+ * so whole files are decoded at maximum throughput instead of realtime.
+ * Progress is still reported through the position-updated signal. Takes
+ * effect the next time playback is started from the stopped state.
+ */
+void player_config_set_offline(GstStructure *config, gboolean offline) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (OFFLINE), G_TYPE_BOOLEAN, offline, NULL);
+}
+
+gboolean player_config_get_offline(const GstStructure *config) {
+    gboolean offline = FALSE;
+
+    g_return_val_if_fail (config != NULL, FALSE);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (OFFLINE),
+                         G_TYPE_BOOLEAN,
+                         &offline,
+                         NULL);
+
+    return offline;
+}
+
+/**
+ * player_config_set_fingerprint:
+ * @config: a #Player configuration
+ * @fingerprint: %TRUE to fingerprint the audio
+ *
+ * Computes an acoustic fingerprint of the first audio stream while
+ * decoding in offline mode. Once the end of the stream is reached the
+ * fingerprint is available through player_media_info_get_fingerprint().
+ * Has no effect unless offline mode is enabled as well.
+ */
+void player_config_set_fingerprint(GstStructure *config, gboolean fingerprint) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (FINGERPRINT), G_TYPE_BOOLEAN, fingerprint, NULL);
+}
+
+gboolean player_config_get_fingerprint(const GstStructure *config) {
+    gboolean fingerprint = FALSE;
+
+    g_return_val_if_fail (config != NULL, FALSE);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (FINGERPRINT),
+                         G_TYPE_BOOLEAN,
+                         &fingerprint,
+                         NULL);
+
+    return fingerprint;
+}
+
+/**
+ * player_config_set_meter_interval:
+ * @config: a #Player configuration
+ * @interval: interval in milliseconds, 0 to disable metering
+ *
+ * Meters the played audio in the playback pipeline itself and emits
+ * meter-updated with per-channel peak and RMS levels at most every
+ * @interval milliseconds. Readings are coalesced: if the previous one
+ * has not been dispatched yet, only the newest is delivered. Takes effect
+ * the next time playback is started from the stopped state.
+ */
+void player_config_set_meter_interval(GstStructure *config, guint interval) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (METER_INTERVAL), G_TYPE_UINT, interval, NULL);
+}
+
+guint player_config_get_meter_interval(const GstStructure *config) {
+    guint interval = 0;
+
+    g_return_val_if_fail (config != NULL, 0);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (METER_INTERVAL),
+                         G_TYPE_UINT,
+                         &interval,
+                         NULL);
+
+    return interval;
+}
+
+/**
+ * player_config_set_meter_bands:
+ * @config: a #Player configuration
+ * @bands: number of spectrum bands, 0 for levels only
+ *
+ * Adds a magnitude spectrum with @bands linearly spaced bands to each
+ * meter reading. Only used when metering is enabled with
+ * player_config_set_meter_interval().
+ */
+void player_config_set_meter_bands(GstStructure *config, guint bands) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (METER_BANDS), G_TYPE_UINT, bands, NULL);
+}
+
+guint player_config_get_meter_bands(const GstStructure *config) {
+    guint bands = 0;
+
+    g_return_val_if_fail (config != NULL, 0);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (METER_BANDS),
+                         G_TYPE_UINT,
+                         &bands,
+                         NULL);
+
+    return bands;
+}
+
+/**
+ * player_config_set_low_latency:
+ * @config: a #Player configuration
+ * @low_latency: %TRUE for the low-latency profile
+ *
+ * Low-latency mode renders audio through pulsesink or alsasink with small
+ * ring buffers (see player_config_set_sink_buffer_time()), disables
+ * buffering of network and demuxed data and lowers the jitterbuffer
+ * latency of RTP sources. Use player_get_latency() to check the
+ * resulting latency. Ignored in offline mode. Takes effect the next time
+ * playback is started from the stopped state.
+ */
+void player_config_set_low_latency(GstStructure *config, gboolean low_latency) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (LOW_LATENCY), G_TYPE_BOOLEAN, low_latency, NULL);
+}
+
+gboolean player_config_get_low_latency(const GstStructure *config) {
+    gboolean low_latency = FALSE;
+
+    g_return_val_if_fail (config != NULL, FALSE);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (LOW_LATENCY),
+                         G_TYPE_BOOLEAN,
+                         &low_latency,
+                         NULL);
+
+    return low_latency;
+}
+
+/**
+ * player_config_set_sink_buffer_time:
+ * @config: a #Player configuration
+ * @buffer_time: audio sink ring buffer size in microseconds
+ *
+ * Only used in low-latency mode. Default is 20000.
+ */
+void player_config_set_sink_buffer_time(GstStructure *config, guint buffer_time) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (SINK_BUFFER_TIME), G_TYPE_UINT, buffer_time, NULL);
+}
+
+guint player_config_get_sink_buffer_time(const GstStructure *config) {
+    guint buffer_time = DEFAULT_SINK_BUFFER_TIME_US;
+
+    g_return_val_if_fail (config != NULL, DEFAULT_SINK_BUFFER_TIME_US);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (SINK_BUFFER_TIME),
+                         G_TYPE_UINT,
+                         &buffer_time,
+                         NULL);
+
+    return buffer_time;
+}
+
+/**
+ * player_config_set_sink_latency_time:
+ * @config: a #Player configuration
+ * @latency_time: audio sink segment size in microseconds
+ *
+ * Only used in low-latency mode. Default is 5000.
+ */
+void player_config_set_sink_latency_time(GstStructure *config, guint latency_time) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (SINK_LATENCY_TIME), G_TYPE_UINT, latency_time, NULL);
+}
+
+guint player_config_get_sink_latency_time(const GstStructure *config) {
+    guint latency_time = DEFAULT_SINK_LATENCY_TIME_US;
+
+    g_return_val_if_fail (config != NULL, DEFAULT_SINK_LATENCY_TIME_US);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (SINK_LATENCY_TIME),
+                         G_TYPE_UINT,
+                         &latency_time,
+                         NULL);
+
+    return latency_time;
+}
+
+/**
+ * player_config_set_buffering_watermarks:
+ * @config: a #Player configuration
+ * @low_percent: fill level below which playback is paused to buffer
+ * @high_percent: fill level at which playback is resumed
+ *
+ * Playback is paused for buffering once the fill level drops below
+ * @low_percent and only resumed at @high_percent, so a level hovering
+ * around one threshold does not toggle between buffering and playing.
+ * Defaults are 10 and 100.
+ */
+void player_config_set_buffering_watermarks(GstStructure *config, gint low_percent,
+                                            gint high_percent) {
+    g_return_if_fail (config != NULL);
+    g_return_if_fail (low_percent >= 0 && low_percent <= high_percent);
+    g_return_if_fail (high_percent > 0 && high_percent <= 100);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (BUFFERING_LOW_PERCENT), G_TYPE_INT, low_percent,
+                         CONFIG_QUARK (BUFFERING_HIGH_PERCENT), G_TYPE_INT, high_percent, NULL);
+}
+
+gint player_config_get_buffering_low_percent(const GstStructure *config) {
+    gint percent = DEFAULT_BUFFERING_LOW_PERCENT;
+
+    g_return_val_if_fail (config != NULL, DEFAULT_BUFFERING_LOW_PERCENT);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (BUFFERING_LOW_PERCENT),
+                         G_TYPE_INT,
+                         &percent,
+                         NULL);
+
+    return percent;
+}
+
+gint player_config_get_buffering_high_percent(const GstStructure *config) {
+    gint percent = DEFAULT_BUFFERING_HIGH_PERCENT;
+
+    g_return_val_if_fail (config != NULL, DEFAULT_BUFFERING_HIGH_PERCENT);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (BUFFERING_HIGH_PERCENT),
+                         G_TYPE_INT,
+                         &percent,
+                         NULL);
+
+    return percent;
+}
+
+/**
+ * player_config_set_buffer_size:
+ * @config: a #Player configuration
+ * @size: network buffer size in bytes, -1 for the playbin default
+ */
+void player_config_set_buffer_size(GstStructure *config, gint size) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (BUFFER_SIZE), G_TYPE_INT, size, NULL);
+}
+
+gint player_config_get_buffer_size(const GstStructure *config) {
+    gint size = -1;
+
+    g_return_val_if_fail (config != NULL, -1);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (BUFFER_SIZE),
+                         G_TYPE_INT,
+                         &size,
+                         NULL);
+
+    return size;
+}
+
+/**
+ * player_config_set_buffer_duration:
+ * @config: a #Player configuration
+ * @duration: network buffer duration in nanoseconds, -1 for the playbin
+ * default
+ */
+void player_config_set_buffer_duration(GstStructure *config, gint64 duration) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (BUFFER_DURATION), G_TYPE_INT64, duration, NULL);
+}
+
+gint64 player_config_get_buffer_duration(const GstStructure *config) {
+    gint64 duration = -1;
+
+    g_return_val_if_fail (config != NULL, -1);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (BUFFER_DURATION),
+                         G_TYPE_INT64,
+                         &duration,
+                         NULL);
+
+    return duration;
+}
+
+/**
+ * player_config_set_progressive_download:
+ * @config: a #Player configuration
+ * @download: %TRUE to download HTTP media to a temporary file
+ *
+ * Enables playbin's progressive download mode for HTTP URIs: seekable
+ * files are downloaded to disk while playing, so seeking back and stalls
+ * on flaky connections are served from the downloaded part.
+ */
+void player_config_set_progressive_download(GstStructure *config, gboolean download) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (PROGRESSIVE_DOWNLOAD), G_TYPE_BOOLEAN, download, NULL);
+}
+
+gboolean player_config_get_progressive_download(const GstStructure *config) {
+    gboolean download = FALSE;
+
+    g_return_val_if_fail (config != NULL, FALSE);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (PROGRESSIVE_DOWNLOAD),
+                         G_TYPE_BOOLEAN,
+                         &download,
+                         NULL);
+
+    return download;
+}
+
+/**
+ * player_config_set_http_cache:
+ * @config: a #Player configuration
+ * @cache: %TRUE to read HTTP URIs through the HTTP block cache
+ *
+ * Reads http:// and https:// URIs with range requests through the
+ * process-wide block cache, see player_http_cache_configure(). Blocks
+ * already fetched, by this or another player, are served from disk.
+ * The server must report the resource size, so this is meant for files
+ * rather than live streams. Items the cache fails to read are played
+ * without it.
+ */
+void player_config_set_http_cache(GstStructure *config, gboolean cache) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (HTTP_CACHE), G_TYPE_BOOLEAN, cache, NULL);
+}
+
+gboolean player_config_get_http_cache(const GstStructure *config) {
+    gboolean cache = FALSE;
+
+    g_return_val_if_fail (config != NULL, FALSE);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (HTTP_CACHE),
+                         G_TYPE_BOOLEAN,
+                         &cache,
+                         NULL);
+
+    return cache;
+}
+
+/**
+ * player_config_set_http_prefetch:
+ * @config: a #Player configuration
+ * @blocks: cache blocks to fetch ahead, 0 to disable prefetching
+ *
+ * With the HTTP cache enabled, fetches this many blocks following the
+ * read position in parallel so playback does not wait for a round trip
+ * per block. Default is 4.
+ */
+void player_config_set_http_prefetch(GstStructure *config, guint blocks) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (HTTP_PREFETCH), G_TYPE_UINT, blocks, NULL);
+}
+
+guint player_config_get_http_prefetch(const GstStructure *config) {
+    guint blocks = DEFAULT_HTTP_PREFETCH_BLOCKS;
+
+    g_return_val_if_fail (config != NULL, DEFAULT_HTTP_PREFETCH_BLOCKS);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (HTTP_PREFETCH),
+                         G_TYPE_UINT,
+                         &blocks,
+                         NULL);
+
+    return blocks;
+}
+
+/**
+ * player_config_set_memory_budget:
+ * @config: a #Player configuration
+ * @bytes: memory budget in bytes, 0 for no limit
+ *
+ * Caps the data buffered by the player's pipeline. The network queues
+ * hold half of the budget together and the other half is split evenly
+ * between the other queues, counting every stream of a multiqueue. The
+ * shares shrink as queues and streams are added, applies to the next
+ * stream.
+ */
+void player_config_set_memory_budget(GstStructure *config, guint64 bytes) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (MEMORY_BUDGET), G_TYPE_UINT64, bytes, NULL);
+}
+
+guint64 player_config_get_memory_budget(const GstStructure *config) {
+    guint64 bytes = 0;
+
+    g_return_val_if_fail (config != NULL, 0);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (MEMORY_BUDGET),
+                         G_TYPE_UINT64,
+                         &bytes,
+                         NULL);
+
+    return bytes;
+}
+
+/**
+ * player_config_set_artwork_in_tags:
+ * @config: a #Player configuration
+ * @keep: %TRUE to keep embedded images in the tags
+ *
+ * By default embedded images are removed from the tags of the media info
+ * and only described by player_media_info_get_artwork(), so a large cover
+ * is not copied along with every media info. Default is %FALSE.
+ */
+void player_config_set_artwork_in_tags(GstStructure *config, gboolean keep) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (ARTWORK_IN_TAGS), G_TYPE_BOOLEAN, keep, NULL);
+}
+
+gboolean player_config_get_artwork_in_tags(const GstStructure *config) {
+    gboolean keep = FALSE;
+
+    g_return_val_if_fail (config != NULL, FALSE);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (ARTWORK_IN_TAGS),
+                         G_TYPE_BOOLEAN,
+                         &keep,
+                         NULL);
+
+    return keep;
+}
+
+/**
+ * player_config_set_idle_timeout:
+ * @config: a #Player configuration
+ * @timeout: time in milliseconds
+ *
+ * After a stop the pipeline stays in READY, keeping devices and decoders
+ * around for a quick restart, and is released after @timeout, 0 releasing
+ * it right away. Also see player_set_idle_hint() and
+ * player_warm_pool_configure(). Default is 60 seconds.
+ */
+void player_config_set_idle_timeout(GstStructure *config, guint timeout) {
+    g_return_if_fail (config != NULL);
+
+    gst_structure_id_set(config,
+                         CONFIG_QUARK (IDLE_TIMEOUT), G_TYPE_UINT, timeout, NULL);
+}
+
+guint player_config_get_idle_timeout(const GstStructure *config) {
+    guint timeout = DEFAULT_IDLE_TIMEOUT_MS;
+
+    g_return_val_if_fail (config != NULL, DEFAULT_IDLE_TIMEOUT_MS);
+
+    gst_structure_id_get(config,
+                         CONFIG_QUARK (IDLE_TIMEOUT),
+                         G_TYPE_UINT,
+                         &timeout,
+                         NULL);
+
+    return timeout;
+}
+
+/**
+ * player_shutdown_async:
+ * @player: #Player instance
+ * @callback: (scope async): called once the player is shut down
+ * @user_data: data for @callback
+ *
+ * Stops playback, brings the pipeline to NULL and ends the player thread
+ * without blocking the caller. The teardown runs on the player's own
+ * thread, so several players shut down concurrently. @callback is called
+ * from the thread-default main context of the caller.
+ *
+ * Afterwards the player does not accept any further commands and can only
+ * be unreffed, which then no longer blocks.
+ */
+void player_shutdown_async(Player *player, GAsyncReadyCallback callback, gpointer user_data) {
+    GTask *task;
+    GSource *source;
+
+    g_return_if_fail (GST_IS_PLAYER(player));
+
+    task = g_task_new(player, NULL, callback, user_data);
+    g_task_set_source_tag(task, player_shutdown_async);
+
+    g_mutex_lock(&player->lock);
+    player->inhibit_sigs = TRUE;
+    player->shutting_down = TRUE;
+    if (!player->thread || player->shut_down) {
+        /* Nothing was ever started, or it already ended */
+        player->shut_down = TRUE;
+        g_mutex_unlock(&player->lock);
+        g_task_return_boolean(task, TRUE);
+        g_object_unref(task);
+        return;
+    }
+    player->shutdown_tasks = g_list_prepend(player->shutdown_tasks, task);
+    g_mutex_unlock(&player->lock);
+
+    source = g_idle_source_new();
+    g_source_set_priority(source, G_PRIORITY_HIGH);
+    g_source_set_callback(source, main_loop_quit_cb, player->loop, NULL);
+    g_source_attach(source, player->context);
+    g_source_unref(source);
+}
+
+gboolean player_shutdown_finish(Player *player, GAsyncResult *result, GError **error) {
+    g_return_val_if_fail (g_task_is_valid(result, player), FALSE);
+
+    return g_task_propagate_boolean(G_TASK (result), error);
+}
+
+typedef struct {
+    GPtrArray *players;
+    guint pending;
+} DisposeManyData;
+
+static void dispose_many_data_free(DisposeManyData *data) {
+    g_ptr_array_unref(data->players);
+    g_free(data);
+}
+
+static void dispose_many_player_done(GObject *source, GAsyncResult *result, gpointer user_data) {
+    GTask *task = user_data;
+    DisposeManyData *data = g_task_get_task_data(task);
+
+    player_shutdown_finish(GST_PLAYER (source), result, NULL);
+
+    if (--data->pending == 0)
+        g_task_return_boolean(task, TRUE);
+    g_object_unref(task);
+}
+
+/**
+ * player_dispose_many_async:
+ * @players: (array length=n_players) (transfer full): players to dispose of
+ * @n_players: number of players
+ * @callback: (scope async): called once all players are shut down
+ * @user_data: data for @callback
+ *
+ * Shuts down all @players concurrently, see player_shutdown_async(), and
+ * drops the references passed in once all of them are done. Tearing down
+ * many players this way takes about as long as the slowest one instead
+ * of the sum of all.
+ */
+void player_dispose_many_async(Player **players, guint n_players,
+                               GAsyncReadyCallback callback, gpointer user_data) {
+    DisposeManyData *data;
+    GTask *task;
+    guint i;
+
+    g_return_if_fail (players != NULL || n_players == 0);
+
+    data = g_new0 (DisposeManyData, 1);
+    data->players = g_ptr_array_new_full(n_players, gst_object_unref);
+    data->pending = n_players;
+
+    task = g_task_new(NULL, NULL, callback, user_data);
+    g_task_set_source_tag(task, player_dispose_many_async);
+    g_task_set_task_data(task, data, (GDestroyNotify) dispose_many_data_free);
+
+    if (n_players == 0) {
+        g_task_return_boolean(task, TRUE);
+        g_object_unref(task);
+        return;
+    }
+
+    for (i = 0; i < n_players; i++) {
+        g_ptr_array_add(data->players, players[i]);
+        player_shutdown_async(players[i], dispose_many_player_done, g_object_ref(task));
+    }
+    g_object_unref(task);
+}
+
+gboolean player_dispose_many_finish(GAsyncResult *result, GError **error) {
+    g_return_val_if_fail (g_task_is_valid(result, NULL), FALSE);
+
+    return g_task_propagate_boolean(G_TASK (result), error);
+}
+
+/**
+ * player_get_bus_stats:
+ * @player: #Player instance
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Fills @stats with the number of pipeline messages handled on the player
+ * thread, the time spent on them and the number of messages dropped
+ * before they were queued.
+ */
+void player_get_bus_stats(Player *player, PlayerBusStats *stats) {
+    g_return_if_fail (GST_IS_PLAYER(player));
+    g_return_if_fail (stats != NULL);
+
+    stats->n_messages = (gsize) g_atomic_pointer_get(&player->bus_n_messages);
+    stats->handling_time = (gsize) g_atomic_pointer_get(&player->bus_handling_time);
+    stats->n_dropped = (guint) g_atomic_int_get(&player->bus_n_dropped);
+}
+
+/**
+ * player_set_idle_hint:
+ * @player: #Player instance
+ * @hint: what to do with the pipeline while stopped
+ *
+ * Tells how soon playback is expected to resume after a stop, overriding
+ * the idle timeout of the configuration. Takes effect on a player already
+ * stopped too.
+ */
+void player_set_idle_hint(Player *self, PlayerIdleHint hint) {
+    g_return_if_fail (GST_IS_PLAYER(self));
+
+    if (g_atomic_int_get(&self->idle_hint) == (gint) hint)
+        return;
+
+    g_atomic_int_set(&self->idle_hint, hint);
+    player_invoke(self, player_rearm_idle_timeout);
+}
+
+PlayerIdleHint player_get_idle_hint(Player *self) {
+    g_return_val_if_fail (GST_IS_PLAYER(self), PLAYER_IDLE_HINT_DEFAULT);
+
+    return g_atomic_int_get(&self->idle_hint);
+}
+
+/**
+ * player_warm_pool_configure:
+ * @max_warm: stopped players keeping their pipeline at most, 0 for no
+ * limit
+ *
+ * Limits the pipelines kept in READY after a stop across all players. The
+ * least recently stopped player beyond the limit is released first,
+ * players hinted with %PLAYER_IDLE_HINT_KEEP_WARM only when no other is
+ * left. Default is no limit.
+ */
+void player_warm_pool_configure(guint max_warm) {
+    WarmPool *pool = warm_pool_get();
+    GPtrArray *victims = g_ptr_array_new();
+    Player *victim;
+    guint i;
+
+    g_mutex_lock(&pool->lock);
+    pool->max_warm = max_warm;
+    while ((victim = warm_pool_evict_locked(pool)) != NULL)
+        g_ptr_array_add(victims, victim);
+    g_mutex_unlock(&pool->lock);
+
+    for (i = 0; i < victims->len; i++) {
+        victim = g_ptr_array_index(victims, i);
+        player_invoke(victim, player_release_idle);
+        gst_object_unref(victim);
+    }
+    g_ptr_array_unref(victims);
+}
+
+/**
+ * player_warm_pool_get_stats:
+ * @stats: (out caller-allocates): return location for the statistics
+ */
+void player_warm_pool_get_stats(PlayerWarmPoolStats *stats) {
+    WarmPool *pool = warm_pool_get();
+
+    g_return_if_fail (stats != NULL);
+
+    memset(stats, 0, sizeof(*stats));
+
+    g_mutex_lock(&pool->lock);
+    stats->n_warm = pool->players.length;
+    stats->max_warm = pool->max_warm;
+    stats->n_evictions = pool->n_evictions;
+    stats->n_expired = pool->n_expired;
+    g_mutex_unlock(&pool->lock);
+}
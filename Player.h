@@ -5,5 +5,7 @@
 #include "PlayerDefine.h"
 #include "MediaInfo.h"
 #include "PlayerMainContextSignalDispatcher.h"
+#include "PlayerFdSignalDispatcher.h"
+#include "PlayerSyncSignalDispatcher.h"
 
 #endif /* __PLAYER_DEFINE_H__ */
@@ -2,9 +2,15 @@
 #define __PLAYER_H__
 
 #include <gst/gst.h>
+#include <gio/gio.h>
 #include "PlayerPrelude.h"
 #include "PlayerTypes.h"
 #include "MediaInfo.h"
+#include "MediaInfoDiff.h"
+#include "Meter.h"
+#include "HttpCache.h"
+#include "TagStore.h"
+#include "TaskPool.h"
 #include "PlayerSignalDispatcher.h"
 
 G_BEGIN_DECLS
@@ -47,6 +53,194 @@ typedef enum {
 
 const gchar *player_error_get_name(PlayerError error);
 
+/**
+ * PlayerBufferingStats:
+ * @mode: buffering mode of the last buffering message
+ * @percent: fill level in percent of the network buffer
+ * @avg_in_rate: average input rate in bytes per second, -1 if unknown
+ * @avg_out_rate: average consumption rate in bytes per second, -1 if unknown
+ * @buffering_left: time until the buffer is full as estimated by the
+ * queue, %GST_CLOCK_TIME_NONE if unknown
+ * @refill_time: estimated time until playback resumes or may resume, see
+ * player_get_buffering_time_left()
+ * @queue_bytes: bytes currently held in the network queues
+ * @queue_time: data currently held in the network queues
+ * @n_buffering_messages: buffering messages handled for this stream
+ * @n_stalls: times playback was interrupted to rebuffer, not counting
+ * the initial fill
+ * @stall_time: total time spent rebuffering, including an ongoing stall
+ *
+ * Buffering statistics of the current stream, reset on stop.
+ */
+typedef struct {
+    GstBufferingMode mode;
+    gint percent;
+    gint avg_in_rate;
+    gint avg_out_rate;
+    GstClockTime buffering_left;
+    GstClockTime refill_time;
+    guint64 queue_bytes;
+    GstClockTime queue_time;
+    guint n_buffering_messages;
+    guint n_stalls;
+    GstClockTime stall_time;
+} PlayerBufferingStats;
+
+/**
+ * PlayerMirrorStats:
+ * @uri: the mirror
+ * @ttfb: time to first byte of its last probe, %GST_CLOCK_TIME_NONE if
+ * never measured
+ * @n_wins: times playback started from this mirror
+ * @n_failures: failed probes and playback errors
+ * @current: whether playback uses this mirror
+ *
+ * Statistics of one mirror set with player_set_mirrors().
+ */
+typedef struct {
+    gchar *uri;
+    GstClockTime ttfb;
+    guint n_wins;
+    guint n_failures;
+    gboolean current;
+} PlayerMirrorStats;
+
+/**
+ * PlayerMemoryStats:
+ * @queue_bytes: data buffered in the queue, queue2 and multiqueue
+ * elements of the pipeline
+ * @n_queues: queues counted in @queue_bytes
+ * @media_info_bytes: estimated size of the tags, caps and samples of the
+ * current media info
+ * @tag_bytes: estimated size of the global tags, embedded artwork
+ * included
+ * @total_bytes: sum of the above
+ * @budget: memory budget as applied to the current stream, 0 if unlimited
+ *
+ * Memory held by one player, see player_get_memory_stats().
+ */
+typedef struct {
+    guint64 queue_bytes;
+    guint n_queues;
+    guint64 media_info_bytes;
+    guint64 tag_bytes;
+    guint64 total_bytes;
+    guint64 budget;
+} PlayerMemoryStats;
+
+/**
+ * PlayerBusStats:
+ * @n_messages: pipeline messages handled on the player thread
+ * @n_dropped: messages of no interest dropped before being queued, such
+ * as state changes of elements inside the pipeline
+ * @handling_time: time spent handling @n_messages
+ *
+ * Message handling of one player, see player_get_bus_stats().
+ */
+typedef struct {
+    guint64 n_messages;
+    guint n_dropped;
+    GstClockTime handling_time;
+} PlayerBusStats;
+
+/**
+ * PlayerIdleHint:
+ * @PLAYER_IDLE_HINT_DEFAULT: keep the pipeline for the configured idle
+ * timeout, within the warm budget
+ * @PLAYER_IDLE_HINT_KEEP_WARM: playback is expected to resume soon, keep
+ * the pipeline until the warm budget needs its place
+ * @PLAYER_IDLE_HINT_RELEASE: release the pipeline as soon as stopped
+ *
+ * What a stopped player does with its pipeline, see player_set_idle_hint().
+ */
+typedef enum {
+    PLAYER_IDLE_HINT_DEFAULT,
+    PLAYER_IDLE_HINT_KEEP_WARM,
+    PLAYER_IDLE_HINT_RELEASE
+} PlayerIdleHint;
+
+/**
+ * PlayerWarmPoolStats:
+ * @n_warm: stopped players currently keeping their pipeline
+ * @max_warm: budget of such players, 0 if unlimited
+ * @n_evictions: pipelines released to stay within the budget
+ * @n_expired: pipelines released after the idle timeout
+ *
+ * Stopped players across the process, see player_warm_pool_configure().
+ */
+typedef struct {
+    guint n_warm;
+    guint max_warm;
+    guint64 n_evictions;
+    guint64 n_expired;
+} PlayerWarmPoolStats;
+
+/**
+ * PlayerEventKind:
+ * @PLAYER_EVENT_URI_LOADED: #Player::uri-loaded, @payload.uri is set
+ * @PLAYER_EVENT_POSITION_UPDATED: #Player::position-updated, @payload.position is set
+ * @PLAYER_EVENT_DURATION_CHANGED: #Player::duration-changed, @payload.duration is set
+ * @PLAYER_EVENT_STATE_CHANGED: #Player::state-changed, @payload.state is set
+ * @PLAYER_EVENT_BUFFERING: #Player::buffering, @payload.percent is set
+ * @PLAYER_EVENT_END_OF_STREAM: #Player::end-of-stream
+ * @PLAYER_EVENT_ERROR: #Player::error, @payload.error is set
+ * @PLAYER_EVENT_WARNING: #Player::warning, @payload.error is set
+ * @PLAYER_EVENT_MEDIA_INFO_UPDATED: #Player::media-info-updated, @payload.media_info is set
+ * @PLAYER_EVENT_VOLUME_CHANGED: #Player::volume-changed, @payload.volume is set
+ * @PLAYER_EVENT_MUTE_CHANGED: #Player::mute-changed, @payload.mute is set
+ * @PLAYER_EVENT_SEEK_DONE: #Player::seek-done, @payload.position is set
+ * @PLAYER_EVENT_METER_UPDATED: #Player::meter-updated, @payload.meter is set
+ * @PLAYER_EVENT_MEDIA_INFO_CHANGED: #Player::media-info-changed, @payload.diff is set
+ */
+typedef enum {
+    PLAYER_EVENT_URI_LOADED,
+    PLAYER_EVENT_POSITION_UPDATED,
+    PLAYER_EVENT_DURATION_CHANGED,
+    PLAYER_EVENT_STATE_CHANGED,
+    PLAYER_EVENT_BUFFERING,
+    PLAYER_EVENT_END_OF_STREAM,
+    PLAYER_EVENT_ERROR,
+    PLAYER_EVENT_WARNING,
+    PLAYER_EVENT_MEDIA_INFO_UPDATED,
+    PLAYER_EVENT_VOLUME_CHANGED,
+    PLAYER_EVENT_MUTE_CHANGED,
+    PLAYER_EVENT_SEEK_DONE,
+    PLAYER_EVENT_METER_UPDATED,
+    PLAYER_EVENT_MEDIA_INFO_CHANGED
+} PlayerEventKind;
+
+/**
+ * PlayerEvent:
+ * @kind: the signal this record stands for
+ * @player: the player that emitted it
+ * @payload: the arguments of the signal, in the member named by @kind
+ *
+ * One player signal as a record. Players queue every signal as such a
+ * record, and player_fd_signal_dispatcher_drain() hands them out instead
+ * of emitting them. @payload.volume and @payload.mute carry the new value,
+ * which the signals leave to the properties. Released with
+ * player_event_clear().
+ */
+typedef struct {
+    PlayerEventKind kind;
+    Player *player;
+    union {
+        gchar *uri;
+        GstClockTime position;
+        GstClockTime duration;
+        PlayerState state;
+        gint percent;
+        GError *error;
+        PlayerMediaInfo *media_info;
+        gdouble volume;
+        gboolean mute;
+        PlayerMeter *meter;
+        PlayerMediaInfoDiff *diff;
+    } payload;
+} PlayerEvent;
+
+void player_event_clear(PlayerEvent *event);
+
 #define GST_TYPE_PLAYER             (player_get_type ())
 #define GST_IS_PLAYER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_PLAYER))
 #define GST_IS_PLAYER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_PLAYER))
@@ -59,6 +253,11 @@ GType player_get_type(void);
 
 Player *player_new(PlayerSignalDispatcher *signal_dispatcher);
 
+gulong player_signal_connect(Player *player, const gchar *detailed_signal,
+                             GCallback c_handler, gpointer data);
+
+void player_signal_disconnect(Player *player, gulong handler_id);
+
 void player_play(Player *player);
 
 void player_pause(Player *player);
@@ -75,10 +274,45 @@ gchar *player_get_uri(Player *player);
 
 void player_set_uri(Player *player, const gchar *uri);
 
+void player_set_mirrors(Player *player, const gchar *const *uris);
+
+GArray *player_get_mirror_stats(Player *player);
+
 GstClockTime player_get_position(Player *player);
 
 GstClockTime player_get_duration(Player *player);
 
+gdouble player_get_realtime_factor(Player *player);
+
+GstClockTime player_get_buffering_time_left(Player *player);
+
+void player_get_buffering_stats(Player *player, PlayerBufferingStats *stats);
+
+void player_get_memory_stats(Player *player, PlayerMemoryStats *stats);
+
+void player_get_bus_stats(Player *player, PlayerBusStats *stats);
+
+GstClockTime player_get_latency(Player *player, gboolean *live);
+
+PlayerMeter *player_get_meter(Player *player);
+
+void player_shutdown_async(Player *player, GAsyncReadyCallback callback, gpointer user_data);
+
+gboolean player_shutdown_finish(Player *player, GAsyncResult *result, GError **error);
+
+void player_dispose_many_async(Player **players, guint n_players,
+                               GAsyncReadyCallback callback, gpointer user_data);
+
+gboolean player_dispose_many_finish(GAsyncResult *result, GError **error);
+
+void player_set_idle_hint(Player *player, PlayerIdleHint hint);
+
+PlayerIdleHint player_get_idle_hint(Player *player);
+
+void player_warm_pool_configure(guint max_warm);
+
+void player_warm_pool_get_stats(PlayerWarmPoolStats *stats);
+
 gdouble player_get_volume(Player *player);
 
 void player_set_volume(Player *player, gdouble val);
@@ -117,6 +351,72 @@ void player_config_set_seek_accurate(GstStructure *config, gboolean accurate);
 
 gboolean player_config_get_seek_accurate(const GstStructure *config);
 
+void player_config_set_offline(GstStructure *config, gboolean offline);
+
+gboolean player_config_get_offline(const GstStructure *config);
+
+void player_config_set_fingerprint(GstStructure *config, gboolean fingerprint);
+
+gboolean player_config_get_fingerprint(const GstStructure *config);
+
+void player_config_set_meter_interval(GstStructure *config, guint interval);
+
+guint player_config_get_meter_interval(const GstStructure *config);
+
+void player_config_set_meter_bands(GstStructure *config, guint bands);
+
+guint player_config_get_meter_bands(const GstStructure *config);
+
+void player_config_set_low_latency(GstStructure *config, gboolean low_latency);
+
+gboolean player_config_get_low_latency(const GstStructure *config);
+
+void player_config_set_sink_buffer_time(GstStructure *config, guint buffer_time);
+
+guint player_config_get_sink_buffer_time(const GstStructure *config);
+
+void player_config_set_sink_latency_time(GstStructure *config, guint latency_time);
+
+guint player_config_get_sink_latency_time(const GstStructure *config);
+
+void player_config_set_buffering_watermarks(GstStructure *config, gint low_percent, gint high_percent);
+
+gint player_config_get_buffering_low_percent(const GstStructure *config);
+
+gint player_config_get_buffering_high_percent(const GstStructure *config);
+
+void player_config_set_buffer_size(GstStructure *config, gint size);
+
+gint player_config_get_buffer_size(const GstStructure *config);
+
+void player_config_set_buffer_duration(GstStructure *config, gint64 duration);
+
+gint64 player_config_get_buffer_duration(const GstStructure *config);
+
+void player_config_set_progressive_download(GstStructure *config, gboolean download);
+
+gboolean player_config_get_progressive_download(const GstStructure *config);
+
+void player_config_set_http_cache(GstStructure *config, gboolean cache);
+
+gboolean player_config_get_http_cache(const GstStructure *config);
+
+void player_config_set_http_prefetch(GstStructure *config, guint blocks);
+
+guint player_config_get_http_prefetch(const GstStructure *config);
+
+void player_config_set_memory_budget(GstStructure *config, guint64 bytes);
+
+guint64 player_config_get_memory_budget(const GstStructure *config);
+
+void player_config_set_artwork_in_tags(GstStructure *config, gboolean keep);
+
+gboolean player_config_get_artwork_in_tags(const GstStructure *config);
+
+void player_config_set_idle_timeout(GstStructure *config, guint timeout);
+
+guint player_config_get_idle_timeout(const GstStructure *config);
+
 G_END_DECLS
 
 #endif /* __PLAYER_H__ */
@@ -0,0 +1,404 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "PlayerFdSignalDispatcher.h"
+#include "PlayerPrivate.h"
+
+#include <glib-unix.h>
+#include <errno.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#define DEFAULT_CAPACITY 256
+
+typedef struct {
+    PlayerSignalDispatcherFunc emitter;
+    gpointer data;
+    GDestroyNotify destroy;
+    guint sequence;         /* Position in the ring + 1 once filled, atomic */
+} FdSignalDispatcherEvent;
+
+/*
+ * Events are queued in a ring without locking. Several players may share
+ * the dispatcher, so there may be several producers: each claims a slot
+ * by advancing the tail and publishes it by setting its sequence, and the
+ * single consumer stops at the first slot that is claimed but not yet
+ * published. Only when the ring is full events go to an overflow queue
+ * under a mutex, and keep going there until the consumer emptied it, so
+ * the events of one thread are emitted in order. The fd is written only
+ * when the consumer may be waiting, i.e. once per batch rather than once
+ * per event.
+ */
+struct _PlayerFdSignalDispatcher {
+    GObject parent;
+
+    FdSignalDispatcherEvent *ring;
+    guint capacity;         /* Power of two */
+    guint head;             /* Next to read, written by the consumer, atomic */
+    guint tail;             /* Next to claim, written by producers, atomic */
+
+    GMutex lock;            /* Guards overflow */
+    GQueue overflow;        /* FdSignalDispatcherEvent */
+    gint n_overflow;        /* atomic */
+
+    gint signalled;         /* atomic */
+    gint read_fd;
+    gint write_fd;          /* Same as read_fd for an eventfd */
+};
+
+struct _PlayerFdSignalDispatcherClass {
+    GObjectClass parent_class;
+};
+
+static void player_fd_signal_dispatcher_interface_init
+        (PlayerSignalDispatcherInterface *interface);
+
+enum {
+    FD_SIGNAL_DISPATCHER_PROP_0,
+    FD_SIGNAL_DISPATCHER_PROP_CAPACITY,
+    FD_SIGNAL_DISPATCHER_PROP_LAST
+};
+
+G_DEFINE_TYPE_WITH_CODE (PlayerFdSignalDispatcher,
+                         player_fd_signal_dispatcher, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE(GST_TYPE_PLAYER_SIGNAL_DISPATCHER,
+                                               player_fd_signal_dispatcher_interface_init));
+
+static GParamSpec *fd_signal_dispatcher_param_specs[FD_SIGNAL_DISPATCHER_PROP_LAST] = {NULL,};
+
+static void fd_signal_dispatcher_event_free(FdSignalDispatcherEvent *event) {
+    if (event->destroy)
+        event->destroy(event->data);
+    g_free(event);
+}
+
+static void fd_signal_dispatcher_wake(PlayerFdSignalDispatcher *self) {
+    if (!g_atomic_int_compare_and_exchange(&self->signalled, 0, 1))
+        return;
+
+#ifdef __linux__
+    if (self->read_fd == self->write_fd) {
+        guint64 one = 1;
+
+        while (write(self->write_fd, &one, sizeof(one)) < 0 && errno == EINTR);
+        return;
+    }
+#endif
+    {
+        guint8 one = 1;
+
+        /* A full pipe is readable already */
+        while (write(self->write_fd, &one, sizeof(one)) < 0 && errno == EINTR);
+    }
+}
+
+static void fd_signal_dispatcher_clear(PlayerFdSignalDispatcher *self) {
+    guint8 buf[64];
+    gssize len;
+
+    do {
+        len = read(self->read_fd, buf, sizeof(buf));
+    } while (len > 0 || (len < 0 && errno == EINTR));
+}
+
+static void player_fd_signal_dispatcher_constructed(GObject *object) {
+    PlayerFdSignalDispatcher *self = GST_PLAYER_FD_SIGNAL_DISPATCHER (object);
+    gint fds[2];
+    GError *err = NULL;
+
+    G_OBJECT_CLASS (player_fd_signal_dispatcher_parent_class)->constructed(object);
+
+    self->ring = g_new0 (FdSignalDispatcherEvent, self->capacity);
+
+#ifdef __linux__
+    self->read_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (self->read_fd >= 0) {
+        self->write_fd = self->read_fd;
+        return;
+    }
+#endif
+
+    if (!g_unix_open_pipe(fds, FD_CLOEXEC, &err)
+        || !g_unix_set_fd_nonblocking(fds[0], TRUE, &err)
+        || !g_unix_set_fd_nonblocking(fds[1], TRUE, &err)) {
+        g_error ("PlayerFdSignalDispatcher: no pipe: %s", err->message);
+        g_assert_not_reached ();
+    }
+    self->read_fd = fds[0];
+    self->write_fd = fds[1];
+}
+
+static void player_fd_signal_dispatcher_finalize(GObject *object) {
+    PlayerFdSignalDispatcher *self = GST_PLAYER_FD_SIGNAL_DISPATCHER (object);
+    FdSignalDispatcherEvent *event;
+
+    /* Players hold a reference, so nothing is produced anymore */
+    while (self->head != self->tail) {
+        event = &self->ring[self->head & (self->capacity - 1)];
+        if (event->destroy)
+            event->destroy(event->data);
+        self->head++;
+    }
+    while ((event = g_queue_pop_head(&self->overflow)))
+        fd_signal_dispatcher_event_free(event);
+    g_free(self->ring);
+    g_mutex_clear(&self->lock);
+
+    if (self->write_fd != self->read_fd)
+        close(self->write_fd);
+    close(self->read_fd);
+
+    G_OBJECT_CLASS (player_fd_signal_dispatcher_parent_class)->finalize(object);
+}
+
+static void player_fd_signal_dispatcher_set_property(GObject *object, guint prop_id,
+                                                     const GValue *value, GParamSpec *pspec) {
+    PlayerFdSignalDispatcher *self = GST_PLAYER_FD_SIGNAL_DISPATCHER (object);
+
+    switch (prop_id) {
+        case FD_SIGNAL_DISPATCHER_PROP_CAPACITY: {
+            guint capacity = g_value_get_uint(value);
+
+            self->capacity = 1;
+            while (self->capacity < capacity)
+                self->capacity <<= 1;
+            break;
+        }
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void player_fd_signal_dispatcher_get_property(GObject *object, guint prop_id,
+                                                     GValue *value, GParamSpec *pspec) {
+    PlayerFdSignalDispatcher *self = GST_PLAYER_FD_SIGNAL_DISPATCHER (object);
+
+    switch (prop_id) {
+        case FD_SIGNAL_DISPATCHER_PROP_CAPACITY:
+            g_value_set_uint(value, self->capacity);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void player_fd_signal_dispatcher_class_init(PlayerFdSignalDispatcherClass *klass) {
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->constructed = player_fd_signal_dispatcher_constructed;
+    object_class->finalize = player_fd_signal_dispatcher_finalize;
+    object_class->set_property = player_fd_signal_dispatcher_set_property;
+    object_class->get_property = player_fd_signal_dispatcher_get_property;
+
+    fd_signal_dispatcher_param_specs[FD_SIGNAL_DISPATCHER_PROP_CAPACITY] =
+            g_param_spec_uint("capacity", "Capacity",
+                              "Events queued without allocation, rounded up to a power of two",
+                              1, G_MAXINT / 2, DEFAULT_CAPACITY,
+                              G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+    g_object_class_install_properties(object_class, FD_SIGNAL_DISPATCHER_PROP_LAST,
+                                      fd_signal_dispatcher_param_specs);
+}
+
+static void player_fd_signal_dispatcher_init(PlayerFdSignalDispatcher *self) {
+    g_mutex_init(&self->lock);
+    g_queue_init(&self->overflow);
+    self->read_fd = -1;
+    self->write_fd = -1;
+}
+
+static void player_fd_signal_dispatcher_dispatch(PlayerSignalDispatcher *interface,
+                                                 G_GNUC_UNUSED Player *player,
+                                                 PlayerSignalDispatcherFunc emitter,
+                                                 gpointer data,
+                                                 GDestroyNotify destroy) {
+    PlayerFdSignalDispatcher *self = GST_PLAYER_FD_SIGNAL_DISPATCHER (interface);
+    FdSignalDispatcherEvent *event;
+    guint tail;
+
+    for (;;) {
+        tail = (guint) g_atomic_int_get(&self->tail);
+
+        if (g_atomic_int_get(&self->n_overflow) > 0
+            || tail - (guint) g_atomic_int_get(&self->head) >= self->capacity) {
+            event = g_new (FdSignalDispatcherEvent, 1);
+            event->emitter = emitter;
+            event->data = data;
+            event->destroy = destroy;
+
+            g_mutex_lock(&self->lock);
+            g_queue_push_tail(&self->overflow, event);
+            g_atomic_int_inc(&self->n_overflow);
+            g_mutex_unlock(&self->lock);
+            break;
+        }
+
+        if (!g_atomic_int_compare_and_exchange((gint *) &self->tail, (gint) tail, (gint) (tail + 1)))
+            continue;
+
+        event = &self->ring[tail & (self->capacity - 1)];
+        event->emitter = emitter;
+        event->data = data;
+        event->destroy = destroy;
+        /* Publishes the slot to the consumer */
+        g_atomic_int_set(&event->sequence, tail + 1);
+        break;
+    }
+
+    fd_signal_dispatcher_wake(self);
+}
+
+static void player_fd_signal_dispatcher_interface_init
+        (PlayerSignalDispatcherInterface *interface) {
+    interface->dispatch = player_fd_signal_dispatcher_dispatch;
+}
+
+/**
+ * player_fd_signal_dispatcher_new:
+ * @capacity: events queued without allocation, 0 for the default
+ *
+ * Creates a new PlayerSignalDispatcher for event loops not based on
+ * GLib, such as epoll or io_uring loops. Signals of the players using it
+ * are queued until player_fd_signal_dispatcher_dispatch_pending() emits
+ * them, in the thread calling it, or player_fd_signal_dispatcher_drain()
+ * returns them as records. The fd returned by
+ * player_fd_signal_dispatcher_get_fd() becomes readable whenever signals
+ * are pending. See player_new().
+ *
+ * Returns: (transfer full): the new PlayerSignalDispatcher
+ */
+PlayerSignalDispatcher *player_fd_signal_dispatcher_new(guint capacity) {
+    return g_object_new(GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER,
+                        "capacity", capacity > 0 ? capacity : DEFAULT_CAPACITY, NULL);
+}
+
+/**
+ * player_fd_signal_dispatcher_get_fd:
+ * @dispatcher: a dispatcher created with player_fd_signal_dispatcher_new()
+ *
+ * Returns: an fd that is readable while signals are pending. It belongs
+ * to @dispatcher and must only be polled, never read or closed.
+ */
+gint player_fd_signal_dispatcher_get_fd(PlayerSignalDispatcher *dispatcher) {
+    g_return_val_if_fail (GST_IS_PLAYER_FD_SIGNAL_DISPATCHER(dispatcher), -1);
+
+    return GST_PLAYER_FD_SIGNAL_DISPATCHER (dispatcher)->read_fd;
+}
+
+/* Emits @event, or with @records appends it there if it is a player
+ * signal. Takes ownership of the data. */
+static void fd_signal_dispatcher_deliver(const FdSignalDispatcherEvent *event, GArray *records) {
+    if (records && event->emitter == player_event_deliver) {
+        PlayerEvent *record = event->data;
+
+        if (player_event_resolve(record)) {
+            g_array_append_val (records, *record);
+            g_free(record);
+            return;
+        }
+    } else {
+        event->emitter(event->data);
+    }
+
+    if (event->destroy)
+        event->destroy(event->data);
+}
+
+static guint fd_signal_dispatcher_run(PlayerFdSignalDispatcher *self, guint max_events,
+                                      GArray *records) {
+    FdSignalDispatcherEvent *event, current;
+    guint head, n = 0;
+
+    /* Producers write the fd again for anything queued from here on */
+    fd_signal_dispatcher_clear(self);
+    g_atomic_int_set(&self->signalled, 0);
+
+    head = self->head;
+    while (max_events == 0 || n < max_events) {
+        event = &self->ring[head & (self->capacity - 1)];
+
+        if ((guint) g_atomic_int_get(&event->sequence) != head + 1) {
+            /* Claimed but not filled yet, its producer wakes us once done */
+            if (head != (guint) g_atomic_int_get(&self->tail))
+                break;
+            if (g_atomic_int_get(&self->n_overflow) == 0)
+                break;
+
+            /* The ring is empty, so everything older was delivered */
+            g_mutex_lock(&self->lock);
+            event = g_queue_pop_head(&self->overflow);
+            g_atomic_int_dec_and_test(&self->n_overflow);
+            g_mutex_unlock(&self->lock);
+
+            fd_signal_dispatcher_deliver(event, records);
+            g_free(event);
+            n++;
+            continue;
+        }
+
+        /* Copied out so the slot can be reused while the handler runs */
+        current = *event;
+        head++;
+        g_atomic_int_set(&self->head, head);
+
+        fd_signal_dispatcher_deliver(&current, records);
+        n++;
+    }
+
+    if (head != (guint) g_atomic_int_get(&self->tail) || g_atomic_int_get(&self->n_overflow) > 0)
+        fd_signal_dispatcher_wake(self);
+
+    return n;
+}
+
+/**
+ * player_fd_signal_dispatcher_dispatch_pending:
+ * @dispatcher: a dispatcher created with player_fd_signal_dispatcher_new()
+ * @max_events: signals to emit at most, 0 for all pending ones
+ *
+ * Emits pending signals of the players using @dispatcher, in order, from
+ * the calling thread. Must only be called from one thread at a time,
+ * usually the event loop thread once the fd is readable. If signals are
+ * left over after @max_events, the fd stays readable.
+ *
+ * Returns: the number of signals emitted
+ */
+guint player_fd_signal_dispatcher_dispatch_pending(PlayerSignalDispatcher *dispatcher,
+                                                   guint max_events) {
+    g_return_val_if_fail (GST_IS_PLAYER_FD_SIGNAL_DISPATCHER(dispatcher), 0);
+
+    return fd_signal_dispatcher_run(GST_PLAYER_FD_SIGNAL_DISPATCHER (dispatcher), max_events, NULL);
+}
+
+/**
+ * player_fd_signal_dispatcher_drain:
+ * @dispatcher: a dispatcher created with player_fd_signal_dispatcher_new()
+ * @max_events: events to take at most, 0 for all pending ones
+ *
+ * Takes pending signals of the players using @dispatcher as #PlayerEvent
+ * records, in order, instead of emitting them. No handlers need to be
+ * connected, players using an fd dispatcher queue all their signals.
+ * Events the player dropped in the meantime, such as position updates
+ * after player_stop(), are left out. Anything else queued on @dispatcher
+ * is emitted as by player_fd_signal_dispatcher_dispatch_pending(). The
+ * same threading rules apply.
+ *
+ * Returns: (transfer full) (element-type PlayerEvent): the records, which
+ * are cleared with player_event_clear() when the array is freed
+ */
+GArray *player_fd_signal_dispatcher_drain(PlayerSignalDispatcher *dispatcher, guint max_events) {
+    GArray *records;
+
+    g_return_val_if_fail (GST_IS_PLAYER_FD_SIGNAL_DISPATCHER(dispatcher), NULL);
+
+    records = g_array_new(FALSE, FALSE, sizeof(PlayerEvent));
+    g_array_set_clear_func(records, (GDestroyNotify) player_event_clear);
+    fd_signal_dispatcher_run(GST_PLAYER_FD_SIGNAL_DISPATCHER (dispatcher), max_events, records);
+
+    return records;
+}
@@ -0,0 +1,32 @@
+#ifndef __PLAYER_FD_SIGNAL_DISPATCHER_H__
+#define __PLAYER_FD_SIGNAL_DISPATCHER_H__
+
+#include "PlayerTypes.h"
+#include "PlayerSignalDispatcher.h"
+
+G_BEGIN_DECLS
+
+typedef struct _PlayerFdSignalDispatcher PlayerFdSignalDispatcher;
+typedef struct _PlayerFdSignalDispatcherClass PlayerFdSignalDispatcherClass;
+
+#define GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER             (player_fd_signal_dispatcher_get_type ())
+#define GST_IS_PLAYER_FD_SIGNAL_DISPATCHER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER))
+#define GST_IS_PLAYER_FD_SIGNAL_DISPATCHER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER))
+#define GST_PLAYER_FD_SIGNAL_DISPATCHER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER, PlayerFdSignalDispatcherClass))
+#define GST_PLAYER_FD_SIGNAL_DISPATCHER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER, PlayerFdSignalDispatcher))
+#define GST_PLAYER_FD_SIGNAL_DISPATCHER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_PLAYER_FD_SIGNAL_DISPATCHER, PlayerFdSignalDispatcherClass))
+
+GType player_fd_signal_dispatcher_get_type(void);
+
+PlayerSignalDispatcher *player_fd_signal_dispatcher_new(guint capacity);
+
+gint player_fd_signal_dispatcher_get_fd(PlayerSignalDispatcher *dispatcher);
+
+guint player_fd_signal_dispatcher_dispatch_pending(PlayerSignalDispatcher *dispatcher,
+                                                   guint max_events);
+
+GArray *player_fd_signal_dispatcher_drain(PlayerSignalDispatcher *dispatcher, guint max_events);
+
+G_END_DECLS
+
+#endif /* __PLAYER_FD_SIGNAL_DISPATCHER_H__ */
@@ -0,0 +1,19 @@
+#include "PlayerDefine.h"
+
+#ifndef __PLAYER_PRIVATE_H__
+#define __PLAYER_PRIVATE_H__
+
+G_BEGIN_DECLS
+
+/* What a position tick does once the position is known, for the bench */
+G_GNUC_INTERNAL void player_announce_position(Player *self, GstClockTime position);
+
+/* The emitter players queue with every #PlayerEvent, which is its data */
+G_GNUC_INTERNAL void player_event_deliver(gpointer event);
+
+/* Fills in what is taken on delivery, FALSE if @event is to be dropped */
+G_GNUC_INTERNAL gboolean player_event_resolve(PlayerEvent *event);
+
+G_END_DECLS
+
+#endif /* __PLAYER_PRIVATE_H__ */
@@ -0,0 +1,73 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "PlayerSyncSignalDispatcher.h"
+
+struct _PlayerSyncSignalDispatcher {
+    GObject parent;
+};
+
+struct _PlayerSyncSignalDispatcherClass {
+    GObjectClass parent_class;
+};
+
+static void player_sync_signal_dispatcher_interface_init
+        (PlayerSignalDispatcherInterface *interface);
+
+G_DEFINE_TYPE_WITH_CODE (PlayerSyncSignalDispatcher,
+                         player_sync_signal_dispatcher, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE(GST_TYPE_PLAYER_SIGNAL_DISPATCHER,
+                                               player_sync_signal_dispatcher_interface_init));
+
+static void player_sync_signal_dispatcher_class_init
+        (G_GNUC_UNUSED PlayerSyncSignalDispatcherClass *klass) {
+
+}
+
+static void player_sync_signal_dispatcher_init
+        (G_GNUC_UNUSED PlayerSyncSignalDispatcher *self) {
+
+}
+
+static void player_sync_signal_dispatcher_dispatch(G_GNUC_UNUSED PlayerSignalDispatcher *interface,
+                                                   G_GNUC_UNUSED Player *player,
+                                                   PlayerSignalDispatcherFunc emitter,
+                                                   gpointer data,
+                                                   GDestroyNotify destroy) {
+    emitter(data);
+    if (destroy)
+        destroy(data);
+}
+
+static void player_sync_signal_dispatcher_interface_init
+        (PlayerSignalDispatcherInterface *interface) {
+    interface->dispatch = player_sync_signal_dispatcher_dispatch;
+}
+
+/**
+ * player_sync_signal_dispatcher_new:
+ *
+ * Creates a new PlayerSignalDispatcher that emits signals right away on
+ * the thread of the player, without a hop to an application main
+ * context. See player_new().
+ *
+ * Handlers then run on the player thread, concurrently with the
+ * application threads, and have to follow these rules:
+ *
+ * - No player lock is held while they run. Getters such as
+ *   player_get_position() or player_get_media_info() may be called.
+ * - Commands such as player_play(), player_seek() or player_set_uri() do
+ *   not run from within the handler but are queued and run on the player
+ *   thread once the current event is handled completely.
+ * - Handlers must return quickly. While they run the player handles no
+ *   pipeline messages and delays position updates.
+ * - The player must not be unreffed to zero from a handler. Another
+ *   thread may drop the last reference meanwhile: the signals do not
+ *   keep the player alive, and dispose waits for the handler to return.
+ *
+ * Returns: (transfer full): the new PlayerSignalDispatcher
+ */
+PlayerSignalDispatcher *player_sync_signal_dispatcher_new(void) {
+    return g_object_new(GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER, NULL);
+}
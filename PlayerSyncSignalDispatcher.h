@@ -0,0 +1,25 @@
+#ifndef __PLAYER_SYNC_SIGNAL_DISPATCHER_H__
+#define __PLAYER_SYNC_SIGNAL_DISPATCHER_H__
+
+#include "PlayerTypes.h"
+#include "PlayerSignalDispatcher.h"
+
+G_BEGIN_DECLS
+
+typedef struct _PlayerSyncSignalDispatcher PlayerSyncSignalDispatcher;
+typedef struct _PlayerSyncSignalDispatcherClass PlayerSyncSignalDispatcherClass;
+
+#define GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER             (player_sync_signal_dispatcher_get_type ())
+#define GST_IS_PLAYER_SYNC_SIGNAL_DISPATCHER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER))
+#define GST_IS_PLAYER_SYNC_SIGNAL_DISPATCHER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER))
+#define GST_PLAYER_SYNC_SIGNAL_DISPATCHER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER, PlayerSyncSignalDispatcherClass))
+#define GST_PLAYER_SYNC_SIGNAL_DISPATCHER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER, PlayerSyncSignalDispatcher))
+#define GST_PLAYER_SYNC_SIGNAL_DISPATCHER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_PLAYER_SYNC_SIGNAL_DISPATCHER, PlayerSyncSignalDispatcherClass))
+
+GType player_sync_signal_dispatcher_get_type(void);
+
+PlayerSignalDispatcher *player_sync_signal_dispatcher_new(void);
+
+G_END_DECLS
+
+#endif /* __PLAYER_SYNC_SIGNAL_DISPATCHER_H__ */
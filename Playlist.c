@@ -0,0 +1,76 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Playlist.h"
+
+/**
+ * playlist_add:
+ * @playlist: (element-type utf8): array of URIs to append to
+ * @filename: an URI, a file or a directory
+ *
+ * Appends @filename to @playlist. Valid URIs are added as-is, directories
+ * are walked recursively and plain files are converted to file:// URIs.
+ */
+void playlist_add(GPtrArray *playlist, const gchar *filename) {
+    GDir *dir;
+    gchar *uri;
+
+    if (gst_uri_is_valid(filename)) {
+        g_ptr_array_add(playlist, g_strdup(filename));
+        return;
+    }
+
+    if ((dir = g_dir_open(filename, 0, NULL))) {
+        const gchar *entry;
+
+        /* FIXME: sort entries for each directory? */
+        while ((entry = g_dir_read_name(dir))) {
+            gchar *path;
+
+            path = g_strconcat(filename, G_DIR_SEPARATOR_S, entry, NULL);
+            playlist_add(playlist, path);
+            g_free(path);
+        }
+
+        g_dir_close(dir);
+        return;
+    }
+
+    uri = gst_filename_to_uri(filename, NULL);
+    if (uri != NULL)
+        g_ptr_array_add(playlist, uri);
+    else
+        g_warning ("Could not make URI out of filename '%s'", filename);
+}
+
+/**
+ * playlist_add_from_file:
+ * @playlist: (element-type utf8): array of URIs to append to
+ * @playlist_file: file with one URI, file or directory per line
+ * @error: return location for a #GError
+ *
+ * Returns: %TRUE if @playlist_file could be read.
+ */
+gboolean playlist_add_from_file(GPtrArray *playlist, const gchar *playlist_file, GError **error) {
+    gchar *playlist_contents = NULL;
+    gchar **lines;
+    guint num, i;
+
+    if (!g_file_get_contents(playlist_file, &playlist_contents, NULL, error))
+        return FALSE;
+
+    lines = g_strsplit(playlist_contents, "\n", 0);
+    num = g_strv_length(lines);
+
+    for (i = 0; i < num; i++) {
+        if (lines[i][0] != '\0') {
+            GST_LOG ("Playlist[%d]: %s", i + 1, lines[i]);
+            playlist_add(playlist, lines[i]);
+        }
+    }
+    g_strfreev(lines);
+    g_free(playlist_contents);
+
+    return TRUE;
+}
@@ -0,0 +1,14 @@
+#ifndef __PLAYLIST_H__
+#define __PLAYLIST_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+void playlist_add(GPtrArray *playlist, const gchar *filename);
+
+gboolean playlist_add_from_file(GPtrArray *playlist, const gchar *playlist_file, GError **error);
+
+G_END_DECLS
+
+#endif /* __PLAYLIST_H__ */
@@ -0,0 +1,176 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "RedirectCache.h"
+
+GST_DEBUG_CATEGORY_STATIC (redirect_cache_debug);
+#define GST_CAT_DEFAULT redirect_cache_debug
+
+#define MAX_URIS_PER_HOST 32
+#define MAX_CHAIN 5
+#define ENTRY_TTL (G_USEC_PER_SEC * 3600)
+
+typedef struct {
+    gchar *uri;
+    gchar *location;
+    gint64 expires;
+} Redirect;
+
+typedef struct {
+    GHashTable *redirects;  /* uri -> Redirect */
+    GQueue order;           /* Redirect, oldest first */
+} HostRedirects;
+
+static GMutex lock;
+static GHashTable *hosts = NULL;   /* host -> HostRedirects */
+
+static void redirect_free(Redirect *redirect) {
+    g_free(redirect->uri);
+    g_free(redirect->location);
+    g_free(redirect);
+}
+
+static void host_redirects_free(HostRedirects *host) {
+    g_hash_table_unref(host->redirects);
+    g_queue_clear(&host->order);
+    g_free(host);
+}
+
+/* Hosts are compared case-insensitively, everything else verbatim */
+static gchar *uri_host(const gchar *uri) {
+    gchar *host = NULL;
+
+    if (!g_uri_split(uri, G_URI_FLAGS_ENCODED, NULL, NULL, &host, NULL, NULL, NULL, NULL, NULL))
+        return NULL;
+    if (!host)
+        return NULL;
+
+    return g_ascii_strdown(host, -1);
+}
+
+static void host_remove(HostRedirects *host, Redirect *redirect) {
+    g_queue_remove(&host->order, redirect);
+    g_hash_table_remove(host->redirects, redirect->uri);
+}
+
+/* Must be called with lock. Returns the location @uri redirects to. */
+static const gchar *lookup_one(const gchar *uri, gint64 now) {
+    HostRedirects *host;
+    Redirect *redirect;
+    gchar *name;
+
+    name = uri_host(uri);
+    if (!name)
+        return NULL;
+    host = g_hash_table_lookup(hosts, name);
+    g_free(name);
+    if (!host)
+        return NULL;
+
+    redirect = g_hash_table_lookup(host->redirects, uri);
+    if (redirect && redirect->expires <= now) {
+        host_remove(host, redirect);
+        redirect = NULL;
+    }
+
+    return redirect ? redirect->location : NULL;
+}
+
+/* Returns the final location of @uri if a redirect for it was seen
+ * before, following chains of redirects, or %NULL */
+gchar *redirect_cache_lookup(const gchar *uri) {
+    const gchar *location = NULL, *next;
+    gint64 now = g_get_monotonic_time();
+    guint hops = 0;
+    gchar *ret;
+
+    g_mutex_lock(&lock);
+    if (!hosts) {
+        g_mutex_unlock(&lock);
+        return NULL;
+    }
+
+    next = lookup_one(uri, now);
+    while (next && hops++ < MAX_CHAIN) {
+        location = next;
+        next = lookup_one(location, now);
+    }
+    ret = g_strdup(location);
+    g_mutex_unlock(&lock);
+
+    if (ret)
+        GST_DEBUG ("Cached redirect %s -> %s", uri, ret);
+
+    return ret;
+}
+
+void redirect_cache_insert(const gchar *uri, const gchar *location) {
+    HostRedirects *host;
+    Redirect *redirect;
+    gchar *name;
+
+    if (!gst_uri_is_valid(location) || g_str_equal(uri, location))
+        return;
+
+    name = uri_host(uri);
+    if (!name)
+        return;
+
+    g_mutex_lock(&lock);
+    if (!hosts) {
+        GST_DEBUG_CATEGORY_INIT (redirect_cache_debug, "player-redirect-cache", 0,
+                                 "Player redirect cache");
+        hosts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                      (GDestroyNotify) host_redirects_free);
+    }
+
+    host = g_hash_table_lookup(hosts, name);
+    if (!host) {
+        host = g_new0 (HostRedirects, 1);
+        host->redirects = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+                                                (GDestroyNotify) redirect_free);
+        g_queue_init(&host->order);
+        g_hash_table_insert(hosts, name, host);
+        name = NULL;
+    }
+
+    redirect = g_hash_table_lookup(host->redirects, uri);
+    if (redirect)
+        host_remove(host, redirect);
+    while (g_queue_get_length(&host->order) >= MAX_URIS_PER_HOST)
+        host_remove(host, g_queue_peek_head(&host->order));
+
+    redirect = g_new (Redirect, 1);
+    redirect->uri = g_strdup(uri);
+    redirect->location = g_strdup(location);
+    redirect->expires = g_get_monotonic_time() + ENTRY_TTL;
+    g_hash_table_insert(host->redirects, redirect->uri, redirect);
+    g_queue_push_tail(&host->order, redirect);
+    g_mutex_unlock(&lock);
+
+    GST_DEBUG ("Remembering redirect %s -> %s", uri, location);
+    g_free(name);
+}
+
+/* Forgets the redirect of @uri, e.g. after its location failed */
+void redirect_cache_remove(const gchar *uri) {
+    HostRedirects *host;
+    Redirect *redirect;
+    gchar *name;
+
+    name = uri_host(uri);
+    if (!name)
+        return;
+
+    g_mutex_lock(&lock);
+    host = hosts ? g_hash_table_lookup(hosts, name) : NULL;
+    redirect = host ? g_hash_table_lookup(host->redirects, uri) : NULL;
+    if (redirect) {
+        GST_DEBUG ("Forgetting redirect %s -> %s", uri, redirect->location);
+        host_remove(host, redirect);
+    }
+    g_mutex_unlock(&lock);
+
+    g_free(name);
+}
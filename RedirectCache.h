@@ -0,0 +1,21 @@
+#ifndef __PLAYER_REDIRECT_CACHE_H__
+#define __PLAYER_REDIRECT_CACHE_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Process-wide memory of redirects already followed, so playing a URI
+ * again goes straight to its final location instead of prerolling the
+ * redirecting resource first. Entries expire after an hour, or are
+ * removed when their location fails, and the number of URIs remembered
+ * per host is bounded.
+ */
+G_GNUC_INTERNAL gchar* redirect_cache_lookup(const gchar *uri);
+G_GNUC_INTERNAL void   redirect_cache_insert(const gchar *uri, const gchar *location);
+G_GNUC_INTERNAL void   redirect_cache_remove(const gchar *uri);
+
+G_END_DECLS
+
+#endif /* __PLAYER_REDIRECT_CACHE_H__ */
@@ -0,0 +1,208 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TagStore.h"
+#include "TagStorePrivate.h"
+#include "MediaInfoPrivate.h"
+
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (tag_store_debug);
+#define GST_CAT_DEFAULT tag_store_debug
+
+/*
+ * Objects are keyed by a hash of their serialization and held through weak
+ * references only, so an entry goes away with the last player using it.
+ * The weak notify runs from the final unref and takes the lock, so nothing
+ * may be unreffed with the lock held. An entry found with a zero refcount
+ * belongs to an object being finalized: it is replaced in the table and
+ * freed by its pending notify.
+ */
+typedef gboolean (*TagStoreEqualFunc)(GstMiniObject *a, GstMiniObject *b);
+
+typedef struct {
+    gchar *key;
+    GstMiniObject *object;
+    GHashTable *table;
+} TagStoreEntry;
+
+typedef struct {
+    GMutex lock;
+    GHashTable *tag_lists;  /* key -> TagStoreEntry, not owned */
+    GHashTable *caps;       /* key -> TagStoreEntry, not owned */
+
+    guint64 n_lookups;
+    guint64 n_shared;
+} TagStore;
+
+static TagStore *tag_store_get(void) {
+    static gsize initialized = 0;
+    static TagStore store;
+
+    if (g_once_init_enter (&initialized)) {
+        GST_DEBUG_CATEGORY_INIT (tag_store_debug, "player-tag-store", 0, "Player tag store");
+        g_mutex_init(&store.lock);
+        store.tag_lists = g_hash_table_new(g_str_hash, g_str_equal);
+        store.caps = g_hash_table_new(g_str_hash, g_str_equal);
+        g_once_init_leave (&initialized, 1);
+    }
+
+    return &store;
+}
+
+static void entry_gone(gpointer data, G_GNUC_UNUSED GstMiniObject *object) {
+    TagStoreEntry *entry = data;
+    TagStore *store = tag_store_get();
+
+    g_mutex_lock(&store->lock);
+    if (g_hash_table_lookup(entry->table, entry->key) == entry)
+        g_hash_table_remove(entry->table, entry->key);
+    g_mutex_unlock(&store->lock);
+
+    g_free(entry->key);
+    g_free(entry);
+}
+
+/* Refs @object unless its refcount already dropped to zero */
+static gboolean mini_object_try_ref(GstMiniObject *object) {
+    gint refcount;
+
+    do {
+        refcount = g_atomic_int_get(&object->refcount);
+        if (refcount <= 0)
+            return FALSE;
+    } while (!g_atomic_int_compare_and_exchange(&object->refcount, refcount, refcount + 1));
+
+    return TRUE;
+}
+
+/* Takes ownership of @object and @key */
+static GstMiniObject *tag_store_intern(GHashTable *table, GstMiniObject *object, gchar *key,
+                                       TagStoreEqualFunc equal) {
+    TagStore *store = tag_store_get();
+    TagStoreEntry *entry;
+    GstMiniObject *shared = NULL, *stale = NULL;
+
+    g_mutex_lock(&store->lock);
+    store->n_lookups++;
+    entry = g_hash_table_lookup(table, key);
+    if (entry && mini_object_try_ref(entry->object)) {
+        /* The key is only a hash, and a stored object with a single
+         * reference may have been made writable and changed since */
+        if (entry->object == object || equal(entry->object, object))
+            shared = entry->object;
+        else
+            stale = entry->object;
+    }
+
+    if (shared) {
+        if (shared != object)
+            store->n_shared++;
+    } else {
+        entry = g_new (TagStoreEntry, 1);
+        entry->key = key;
+        entry->object = object;
+        entry->table = table;
+        g_hash_table_replace(table, entry->key, entry);
+        gst_mini_object_weak_ref(object, entry_gone, entry);
+        key = NULL;
+    }
+    g_mutex_unlock(&store->lock);
+
+    g_free(key);
+    if (stale)
+        gst_mini_object_unref(stale);
+    if (shared) {
+        gst_mini_object_unref(object);
+        return shared;
+    }
+
+    return object;
+}
+
+static gboolean tag_list_equal(GstMiniObject *a, GstMiniObject *b) {
+    return gst_tag_list_get_scope(GST_TAG_LIST (a)) == gst_tag_list_get_scope(GST_TAG_LIST (b))
+           && gst_tag_list_is_equal(GST_TAG_LIST (a), GST_TAG_LIST (b));
+}
+
+static gboolean caps_equal(GstMiniObject *a, GstMiniObject *b) {
+    return gst_caps_is_strictly_equal(GST_CAPS (a), GST_CAPS (b));
+}
+
+GstTagList *tag_store_intern_tag_list(GstTagList *tags) {
+    gchar *serialized, *key;
+
+    if (!tags)
+        return NULL;
+
+    serialized = gst_tag_list_to_string(tags);
+    key = g_compute_checksum_for_string(G_CHECKSUM_SHA1, serialized, -1);
+    g_free(serialized);
+    /* Scope is not part of the serialization */
+    key[0] = gst_tag_list_get_scope(tags) == GST_TAG_SCOPE_GLOBAL ? 'g' : 's';
+
+    return GST_TAG_LIST (tag_store_intern(tag_store_get()->tag_lists, GST_MINI_OBJECT_CAST (tags),
+                                          key, tag_list_equal));
+}
+
+GstCaps *tag_store_intern_caps(GstCaps *caps) {
+    gchar *serialized, *key;
+
+    if (!caps)
+        return NULL;
+
+    serialized = gst_caps_to_string(caps);
+    key = g_compute_checksum_for_string(G_CHECKSUM_SHA1, serialized, -1);
+    g_free(serialized);
+
+    return GST_CAPS (tag_store_intern(tag_store_get()->caps, GST_MINI_OBJECT_CAST (caps),
+                                      key, caps_equal));
+}
+
+/**
+ * player_tag_store_get_stats:
+ * @stats: (out caller-allocates): return location for the statistics
+ */
+void player_tag_store_get_stats(PlayerTagStoreStats *stats) {
+    TagStore *store = tag_store_get();
+    GHashTableIter iter;
+    TagStoreEntry *entry;
+    guint n_objects;
+
+    g_return_if_fail (stats != NULL);
+
+    memset(stats, 0, sizeof(*stats));
+
+    g_mutex_lock(&store->lock);
+    stats->n_lookups = store->n_lookups;
+    stats->n_shared = store->n_shared;
+
+    g_hash_table_iter_init(&iter, store->tag_lists);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &entry)) {
+        gint refcount = GST_MINI_OBJECT_REFCOUNT_VALUE (entry->object);
+
+        if (refcount <= 0)
+            continue;
+        stats->n_tag_lists++;
+        stats->n_references += refcount;
+        stats->bytes_saved += (guint64) (refcount - 1) *
+                              player_tag_list_estimate_size(GST_TAG_LIST (entry->object));
+    }
+
+    g_hash_table_iter_init(&iter, store->caps);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *) &entry)) {
+        gint refcount = GST_MINI_OBJECT_REFCOUNT_VALUE (entry->object);
+
+        if (refcount <= 0)
+            continue;
+        stats->n_caps++;
+        stats->n_references += refcount;
+        stats->bytes_saved += (guint64) (refcount - 1) *
+                              player_caps_estimate_size(GST_CAPS (entry->object));
+    }
+    g_mutex_unlock(&store->lock);
+
+    n_objects = stats->n_tag_lists + stats->n_caps;
+    stats->dedup_ratio = n_objects > 0 ? (gdouble) stats->n_references / n_objects : 0.0;
+}
@@ -0,0 +1,38 @@
+#ifndef __PLAYER_TAG_STORE_H__
+#define __PLAYER_TAG_STORE_H__
+
+#include <gst/gst.h>
+#include "PlayerPrelude.h"
+
+G_BEGIN_DECLS
+
+/**
+ * PlayerTagStoreStats:
+ * @n_lookups: tag lists and caps passed through the store
+ * @n_shared: lookups answered with an identical object already stored
+ * @n_tag_lists: distinct tag lists currently stored
+ * @n_caps: distinct caps currently stored
+ * @n_references: references currently held on the stored objects
+ * @dedup_ratio: @n_references per stored object, 1.0 when nothing is
+ * shared, 0.0 when the store is empty
+ * @bytes_saved: estimated bytes the shared references would take as copies
+ *
+ * Statistics of the process-wide store through which players share
+ * identical stream tags and caps.
+ */
+typedef struct {
+    guint64 n_lookups;
+    guint64 n_shared;
+    guint n_tag_lists;
+    guint n_caps;
+    guint64 n_references;
+    gdouble dedup_ratio;
+    guint64 bytes_saved;
+} PlayerTagStoreStats;
+
+GST_PLAYER_API
+void player_tag_store_get_stats (PlayerTagStoreStats *stats);
+
+G_END_DECLS
+
+#endif /* __PLAYER_TAG_STORE_H__ */
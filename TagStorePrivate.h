@@ -0,0 +1,16 @@
+#include "TagStore.h"
+
+#ifndef __PLAYER_TAG_STORE_PRIVATE_H__
+#define __PLAYER_TAG_STORE_PRIVATE_H__
+
+G_BEGIN_DECLS
+
+/* Both take ownership of their argument and return a reference to an
+ * identical stored object, which must not be modified. NULL passes
+ * through. */
+G_GNUC_INTERNAL GstTagList* tag_store_intern_tag_list(GstTagList *tags);
+G_GNUC_INTERNAL GstCaps*    tag_store_intern_caps(GstCaps *caps);
+
+G_END_DECLS
+
+#endif /* __PLAYER_TAG_STORE_PRIVATE_H__ */
@@ -0,0 +1,316 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "TaskPool.h"
+#include "TaskPoolPrivate.h"
+
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (task_pool_debug);
+#define GST_CAT_DEFAULT task_pool_debug
+
+#define DEFAULT_MAX_IDLE_THREADS 64
+#define DEFAULT_IDLE_TIMEOUT (30 * GST_SECOND)
+
+#define GST_TYPE_PLAYER_TASK_POOL (player_task_pool_get_type ())
+
+typedef struct _PlayerTaskPool PlayerTaskPool;
+typedef struct _PlayerTaskPoolClass PlayerTaskPoolClass;
+
+/*
+ * Runs the streaming tasks of all players on one set of worker threads.
+ * A streaming task occupies its thread until its element stops it, so
+ * there is one busy worker per running task and the number of workers is
+ * not capped: a task waiting for a worker that is busy with another task
+ * of the same pipeline would never run. What the pool saves is the thread
+ * churn, as workers of stopped pipelines are parked and picked up by the
+ * next task of any player, the most recently parked one first while its
+ * stack is still warm. Parked workers beyond the idle limit, or idle for
+ * longer than the timeout, exit.
+ */
+struct _PlayerTaskPool {
+    GstTaskPool parent;
+};
+
+struct _PlayerTaskPoolClass {
+    GstTaskPoolClass parent_class;
+};
+
+G_GNUC_INTERNAL GType player_task_pool_get_type(void);
+
+G_DEFINE_TYPE (PlayerTaskPool, player_task_pool, GST_TYPE_TASK_POOL);
+
+/* Handle returned from push, owned by the worker running it and by the
+ * caller until joined. Protected by the pool lock. */
+typedef struct {
+    gint ref_count;
+    GstTaskPoolFunction func;
+    gpointer user_data;
+    GstClockTime pushed;
+    gboolean done;
+} TaskPoolJob;
+
+typedef struct {
+    GCond cond;
+    TaskPoolJob *job;       /* Assigned job, protected by pool lock */
+} TaskPoolWorker;
+
+typedef struct {
+    GMutex lock;
+    GCond join_cond;
+    GQueue idle;            /* TaskPoolWorker, most recently parked first */
+    guint max_idle;
+    GstClockTime idle_timeout;
+
+    guint n_threads;
+    guint n_busy;
+    guint peak_threads;
+    guint64 n_threads_created;
+    guint64 n_tasks;
+    guint64 n_reused;
+    guint64 n_started;
+    GstClockTime total_wait;
+    GstClockTime max_wait;
+} TaskPoolState;
+
+static TaskPoolState *task_pool_state_get(void) {
+    static gsize initialized = 0;
+    static TaskPoolState state;
+
+    if (g_once_init_enter (&initialized)) {
+        GST_DEBUG_CATEGORY_INIT (task_pool_debug, "player-task-pool", 0, "Player task pool");
+        g_mutex_init(&state.lock);
+        g_cond_init(&state.join_cond);
+        g_queue_init(&state.idle);
+        state.max_idle = DEFAULT_MAX_IDLE_THREADS;
+        state.idle_timeout = DEFAULT_IDLE_TIMEOUT;
+        g_once_init_leave (&initialized, 1);
+    }
+
+    return &state;
+}
+
+/* Must be called with pool lock */
+static void task_pool_job_unref(TaskPoolJob *job) {
+    if (--job->ref_count == 0)
+        g_free(job);
+}
+
+static gpointer worker_main(gpointer data) {
+    TaskPoolWorker *worker = data;
+    TaskPoolState *state = task_pool_state_get();
+    TaskPoolJob *job;
+    GstClockTime wait;
+    gint64 deadline;
+
+    g_mutex_lock(&state->lock);
+    for (;;) {
+        job = worker->job;
+        if (!job) {
+            /* Parked, see task_pool_push() */
+            deadline = g_get_monotonic_time() + state->idle_timeout / GST_USECOND;
+            while (!worker->job && state->idle.length <= state->max_idle) {
+                if (!g_cond_wait_until(&worker->cond, &state->lock, deadline))
+                    break;
+            }
+            if (!worker->job) {
+                g_queue_remove(&state->idle, worker);
+                break;
+            }
+            continue;
+        }
+
+        worker->job = NULL;
+        wait = gst_util_get_timestamp() - job->pushed;
+        state->n_started++;
+        state->total_wait += wait;
+        state->max_wait = MAX (state->max_wait, wait);
+        state->n_busy++;
+        g_mutex_unlock(&state->lock);
+
+        job->func(job->user_data);
+
+        g_mutex_lock(&state->lock);
+        state->n_busy--;
+        job->done = TRUE;
+        g_cond_broadcast(&state->join_cond);
+        task_pool_job_unref(job);
+
+        if (state->idle.length >= state->max_idle)
+            break;
+        g_queue_push_head(&state->idle, worker);
+    }
+    state->n_threads--;
+    GST_LOG ("Worker exiting, %u threads left", state->n_threads);
+    g_mutex_unlock(&state->lock);
+
+    g_cond_clear(&worker->cond);
+    g_free(worker);
+
+    return NULL;
+}
+
+static void player_task_pool_prepare(G_GNUC_UNUSED GstTaskPool *pool, G_GNUC_UNUSED GError **error) {
+    /* Workers are process-wide and started on demand */
+}
+
+static void player_task_pool_cleanup(G_GNUC_UNUSED GstTaskPool *pool) {
+    /* Parked workers stay around for other players */
+}
+
+static gpointer player_task_pool_push(G_GNUC_UNUSED GstTaskPool *pool, GstTaskPoolFunction func,
+                                      gpointer user_data, GError **error) {
+    TaskPoolState *state = task_pool_state_get();
+    TaskPoolWorker *worker;
+    TaskPoolJob *job;
+    GThread *thread;
+
+    job = g_new0 (TaskPoolJob, 1);
+    job->ref_count = 2;
+    job->func = func;
+    job->user_data = user_data;
+    job->pushed = gst_util_get_timestamp();
+
+    g_mutex_lock(&state->lock);
+    state->n_tasks++;
+    worker = g_queue_pop_head(&state->idle);
+    if (worker) {
+        state->n_reused++;
+        worker->job = job;
+        g_cond_signal(&worker->cond);
+        g_mutex_unlock(&state->lock);
+        return job;
+    }
+    state->n_threads++;
+    state->n_threads_created++;
+    state->peak_threads = MAX (state->peak_threads, state->n_threads);
+    g_mutex_unlock(&state->lock);
+
+    worker = g_new0 (TaskPoolWorker, 1);
+    g_cond_init(&worker->cond);
+    worker->job = job;
+
+    thread = g_thread_try_new("player-stream", worker_main, worker, error);
+    if (!thread) {
+        g_mutex_lock(&state->lock);
+        state->n_threads--;
+        state->n_threads_created--;
+        g_mutex_unlock(&state->lock);
+
+        g_cond_clear(&worker->cond);
+        g_free(worker);
+        g_free(job);
+        return NULL;
+    }
+    g_thread_unref(thread);
+
+    return job;
+}
+
+static void player_task_pool_join(G_GNUC_UNUSED GstTaskPool *pool, gpointer id) {
+    TaskPoolState *state = task_pool_state_get();
+    TaskPoolJob *job = id;
+
+    if (!job)
+        return;
+
+    g_mutex_lock(&state->lock);
+    while (!job->done)
+        g_cond_wait(&state->join_cond, &state->lock);
+    task_pool_job_unref(job);
+    g_mutex_unlock(&state->lock);
+}
+
+#if GST_CHECK_VERSION(1, 20, 0)
+static void player_task_pool_dispose_handle(G_GNUC_UNUSED GstTaskPool *pool, gpointer id) {
+    TaskPoolState *state = task_pool_state_get();
+    TaskPoolJob *job = id;
+
+    if (!job)
+        return;
+
+    g_mutex_lock(&state->lock);
+    task_pool_job_unref(job);
+    g_mutex_unlock(&state->lock);
+}
+#endif
+
+static void player_task_pool_class_init(PlayerTaskPoolClass *klass) {
+    GstTaskPoolClass *pool_class = GST_TASK_POOL_CLASS (klass);
+
+    pool_class->prepare = player_task_pool_prepare;
+    pool_class->cleanup = player_task_pool_cleanup;
+    pool_class->push = player_task_pool_push;
+    pool_class->join = player_task_pool_join;
+#if GST_CHECK_VERSION(1, 20, 0)
+    pool_class->dispose_handle = player_task_pool_dispose_handle;
+#endif
+}
+
+static void player_task_pool_init(G_GNUC_UNUSED PlayerTaskPool *self) {
+}
+
+GstTaskPool *player_task_pool_get_default(void) {
+    static GstTaskPool *pool = NULL;
+
+    if (g_once_init_enter (&pool)) {
+        GstTaskPool *new_pool;
+
+        task_pool_state_get();
+        new_pool = g_object_new(GST_TYPE_PLAYER_TASK_POOL, "name", "player-task-pool", NULL);
+        gst_object_ref_sink(new_pool);
+        g_once_init_leave (&pool, new_pool);
+    }
+
+    return pool;
+}
+
+/**
+ * player_task_pool_configure:
+ * @max_idle_threads: worker threads kept parked for reuse at most
+ * @idle_timeout: time after which a parked worker thread exits
+ *
+ * Configures the process-wide pool running the streaming threads of all
+ * players. Busy worker threads are never limited, as every running
+ * streaming task needs a thread of its own.
+ */
+void player_task_pool_configure(guint max_idle_threads, GstClockTime idle_timeout) {
+    TaskPoolState *state = task_pool_state_get();
+    GList *l;
+
+    g_return_if_fail (GST_CLOCK_TIME_IS_VALID(idle_timeout));
+
+    g_mutex_lock(&state->lock);
+    state->max_idle = max_idle_threads;
+    state->idle_timeout = idle_timeout;
+    /* Let parked workers pick up the new limits */
+    for (l = state->idle.head; l != NULL; l = l->next)
+        g_cond_signal(&((TaskPoolWorker *) l->data)->cond);
+    g_mutex_unlock(&state->lock);
+}
+
+/**
+ * player_task_pool_get_stats:
+ * @stats: (out caller-allocates): return location for the statistics
+ */
+void player_task_pool_get_stats(PlayerTaskPoolStats *stats) {
+    TaskPoolState *state = task_pool_state_get();
+
+    g_return_if_fail (stats != NULL);
+
+    memset(stats, 0, sizeof(*stats));
+
+    g_mutex_lock(&state->lock);
+    stats->n_threads = state->n_threads;
+    stats->n_busy_threads = state->n_busy;
+    stats->n_idle_threads = state->idle.length;
+    stats->peak_threads = state->peak_threads;
+    stats->n_threads_created = state->n_threads_created;
+    stats->n_tasks = state->n_tasks;
+    stats->n_reused = state->n_reused;
+    if (state->n_started > 0)
+        stats->queue_wait_avg = state->total_wait / state->n_started;
+    stats->queue_wait_max = state->max_wait;
+    g_mutex_unlock(&state->lock);
+}
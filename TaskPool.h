@@ -0,0 +1,46 @@
+#ifndef __PLAYER_TASK_POOL_H__
+#define __PLAYER_TASK_POOL_H__
+
+#include <gst/gst.h>
+#include "PlayerPrelude.h"
+
+G_BEGIN_DECLS
+
+/**
+ * PlayerTaskPoolStats:
+ * @n_threads: worker threads currently alive
+ * @n_busy_threads: worker threads running a streaming task
+ * @n_idle_threads: worker threads parked for reuse
+ * @peak_threads: highest number of worker threads alive at once
+ * @n_threads_created: worker threads created so far
+ * @n_tasks: streaming tasks run so far
+ * @n_reused: streaming tasks that ran on a parked thread instead of a
+ * new one
+ * @queue_wait_avg: average time between a task being pushed and starting
+ * to run
+ * @queue_wait_max: longest such time
+ *
+ * Statistics of the process-wide pool running the streaming threads of
+ * all players.
+ */
+typedef struct {
+    guint n_threads;
+    guint n_busy_threads;
+    guint n_idle_threads;
+    guint peak_threads;
+    guint64 n_threads_created;
+    guint64 n_tasks;
+    guint64 n_reused;
+    GstClockTime queue_wait_avg;
+    GstClockTime queue_wait_max;
+} PlayerTaskPoolStats;
+
+GST_PLAYER_API
+void    player_task_pool_configure (guint max_idle_threads, GstClockTime idle_timeout);
+
+GST_PLAYER_API
+void    player_task_pool_get_stats (PlayerTaskPoolStats *stats);
+
+G_END_DECLS
+
+#endif /* __PLAYER_TASK_POOL_H__ */
@@ -0,0 +1,13 @@
+#include "TaskPool.h"
+
+#ifndef __PLAYER_TASK_POOL_PRIVATE_H__
+#define __PLAYER_TASK_POOL_PRIVATE_H__
+
+G_BEGIN_DECLS
+
+/* The pool shared by all players, transfer none */
+G_GNUC_INTERNAL GstTaskPool* player_task_pool_get_default(void);
+
+G_END_DECLS
+
+#endif /* __PLAYER_TASK_POOL_PRIVATE_H__ */
@@ -0,0 +1,699 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "Transcoder.h"
+#include "PlayerDefine.h"
+#include "PlayerSignalDispatcherPrivate.h"
+
+#include <glib/gstdio.h>
+#include <string.h>
+
+GST_DEBUG_CATEGORY_STATIC (transcoder_debug);
+#define GST_CAT_DEFAULT transcoder_debug
+
+#define PROGRESS_INTERVAL (500 * GST_MSECOND)
+
+enum {
+    SIGNAL_JOB_PROGRESS,
+    SIGNAL_JOB_DONE,
+    SIGNAL_DONE,
+    SIGNAL_LAST
+};
+
+typedef struct {
+    guint index;
+    gchar *src_uri;
+    gchar *dest_path;
+
+    /* Protected by the object lock once the transcoder is started */
+    GstClockTime duration;
+    GstClockTime wall_time;
+    guint64 output_bytes;
+    GError *error;
+} TranscodeJob;
+
+struct _Transcoder {
+    GstObject parent;
+
+    PlayerSignalDispatcher *signal_dispatcher;
+    GstEncodingProfile *profile;
+    GstCaps *raw_caps;
+    gchar *output_dir;
+    gchar *extension;
+    guint n_workers;
+
+    GPtrArray *jobs;
+    GHashTable *destinations;
+    GThreadPool *pool;
+    gint remaining;
+
+    /* Protected by the object lock */
+    GstClockTime start_time;
+    GstClockTime wall_time;
+};
+
+struct _TranscoderClass {
+    GstObjectClass parent_class;
+};
+
+#define parent_class transcoder_parent_class
+
+G_DEFINE_TYPE (Transcoder, transcoder, GST_TYPE_OBJECT);
+
+static guint signals[SIGNAL_LAST] = {0,};
+
+static void transcode_job_free(TranscodeJob *job) {
+    g_free(job->src_uri);
+    g_free(job->dest_path);
+    g_clear_error(&job->error);
+    g_free(job);
+}
+
+static void transcoder_init(Transcoder *self) {
+    self->jobs = g_ptr_array_new_with_free_func((GDestroyNotify) transcode_job_free);
+    self->destinations = g_hash_table_new(g_str_hash, g_str_equal);
+    self->start_time = GST_CLOCK_TIME_NONE;
+    self->wall_time = GST_CLOCK_TIME_NONE;
+}
+
+static void transcoder_dispose(GObject *object) {
+    Transcoder *self = GST_TRANSCODER (object);
+
+    /* Waits for the running jobs, queued ones are dropped */
+    if (self->pool) {
+        g_thread_pool_free(self->pool, TRUE, TRUE);
+        self->pool = NULL;
+    }
+
+    G_OBJECT_CLASS (parent_class)->dispose(object);
+}
+
+static void transcoder_finalize(GObject *object) {
+    Transcoder *self = GST_TRANSCODER (object);
+
+    g_hash_table_unref(self->destinations);
+    g_ptr_array_unref(self->jobs);
+    g_free(self->output_dir);
+    g_free(self->extension);
+    if (self->raw_caps)
+        gst_caps_unref(self->raw_caps);
+    if (self->profile)
+        gst_encoding_profile_unref(self->profile);
+    if (self->signal_dispatcher)
+        g_object_unref(self->signal_dispatcher);
+
+    G_OBJECT_CLASS (parent_class)->finalize(object);
+}
+
+static void transcoder_class_init(TranscoderClass *klass) {
+    GObjectClass *gobject_class = (GObjectClass *) klass;
+
+    gobject_class->dispose = transcoder_dispose;
+    gobject_class->finalize = transcoder_finalize;
+
+    signals[SIGNAL_JOB_PROGRESS] =
+            g_signal_new("job-progress", G_TYPE_FROM_CLASS (klass),
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS, 0, NULL,
+                         NULL, NULL, G_TYPE_NONE, 3, G_TYPE_UINT, GST_TYPE_CLOCK_TIME,
+                         GST_TYPE_CLOCK_TIME);
+
+    signals[SIGNAL_JOB_DONE] =
+            g_signal_new("job-done", G_TYPE_FROM_CLASS (klass),
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS, 0, NULL,
+                         NULL, NULL, G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_ERROR);
+
+    signals[SIGNAL_DONE] =
+            g_signal_new("done", G_TYPE_FROM_CLASS (klass),
+                         G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS, 0, NULL,
+                         NULL, NULL, G_TYPE_NONE, 0, G_TYPE_INVALID);
+}
+
+typedef struct {
+    Transcoder *transcoder;
+    guint job;
+    GstClockTime position;
+    GstClockTime duration;
+} JobProgressSignalData;
+
+static void job_progress_dispatch(gpointer user_data) {
+    JobProgressSignalData *data = user_data;
+
+    g_signal_emit(data->transcoder, signals[SIGNAL_JOB_PROGRESS], 0,
+                  data->job, data->position, data->duration);
+}
+
+static void job_progress_signal_data_free(JobProgressSignalData *data) {
+    g_object_unref(data->transcoder);
+    g_free(data);
+}
+
+static void emit_job_progress(Transcoder *self, TranscodeJob *job,
+                              GstClockTime position, GstClockTime duration) {
+    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
+                              signals[SIGNAL_JOB_PROGRESS], 0, NULL, NULL, NULL) != 0) {
+        JobProgressSignalData *data = g_new (JobProgressSignalData, 1);
+
+        data->transcoder = g_object_ref(self);
+        data->job = job->index;
+        data->position = position;
+        data->duration = duration;
+        player_signal_dispatcher_dispatch(self->signal_dispatcher, NULL,
+                                          job_progress_dispatch, data,
+                                          (GDestroyNotify) job_progress_signal_data_free);
+    }
+}
+
+typedef struct {
+    Transcoder *transcoder;
+    guint job;
+    GError *err;
+} JobDoneSignalData;
+
+static void job_done_dispatch(gpointer user_data) {
+    JobDoneSignalData *data = user_data;
+
+    g_signal_emit(data->transcoder, signals[SIGNAL_JOB_DONE], 0, data->job, data->err);
+}
+
+static void job_done_signal_data_free(JobDoneSignalData *data) {
+    g_object_unref(data->transcoder);
+    g_clear_error(&data->err);
+    g_free(data);
+}
+
+static void emit_job_done(Transcoder *self, TranscodeJob *job) {
+    if (g_signal_handler_find(self, G_SIGNAL_MATCH_ID,
+                              signals[SIGNAL_JOB_DONE], 0, NULL, NULL, NULL) != 0) {
+        JobDoneSignalData *data = g_new (JobDoneSignalData, 1);
+
+        data->transcoder = g_object_ref(self);
+        data->job = job->index;
+        GST_OBJECT_LOCK (self);
+        data->err = job->error ? g_error_copy(job->error) : NULL;
+        GST_OBJECT_UNLOCK (self);
+        player_signal_dispatcher_dispatch(self->signal_dispatcher, NULL,
+                                          job_done_dispatch, data,
+                                          (GDestroyNotify) job_done_signal_data_free);
+    }
+}
+
+static void done_dispatch(gpointer user_data) {
+    Transcoder *transcoder = user_data;
+
+    g_signal_emit(transcoder, signals[SIGNAL_DONE], 0);
+}
+
+static void emit_done(Transcoder *self) {
+    player_signal_dispatcher_dispatch(self->signal_dispatcher, NULL,
+                                      done_dispatch, g_object_ref(self),
+                                      (GDestroyNotify) g_object_unref);
+}
+
+static GstCaps *profile_get_raw_caps(GstEncodingProfile *profile) {
+    GstCaps *caps = gst_caps_new_empty();
+
+    if (GST_IS_ENCODING_CONTAINER_PROFILE (profile)) {
+        const GList *l;
+
+        for (l = gst_encoding_container_profile_get_profiles
+                (GST_ENCODING_CONTAINER_PROFILE (profile)); l != NULL; l = l->next)
+            caps = gst_caps_merge(caps, profile_get_raw_caps(l->data));
+    } else if (GST_IS_ENCODING_AUDIO_PROFILE (profile)) {
+        caps = gst_caps_merge(caps, gst_caps_new_empty_simple("audio/x-raw"));
+    } else if (GST_IS_ENCODING_VIDEO_PROFILE (profile)) {
+        caps = gst_caps_merge(caps, gst_caps_new_empty_simple("video/x-raw"));
+    }
+
+    return caps;
+}
+
+static void decoder_pad_added_cb(G_GNUC_UNUSED GstElement *decoder, GstPad *pad,
+                                 GstElement *encoder) {
+    GstCaps *caps;
+    GstPad *sinkpad = NULL;
+
+    caps = gst_pad_get_current_caps(pad);
+    if (!caps)
+        caps = gst_pad_query_caps(pad, NULL);
+
+    g_signal_emit_by_name(encoder, "request-pad", caps, &sinkpad);
+    if (!sinkpad) {
+        GST_WARNING_OBJECT (pad, "No encoding profile for caps %" GST_PTR_FORMAT, caps);
+        gst_caps_unref(caps);
+        return;
+    }
+    gst_caps_unref(caps);
+
+    if (gst_pad_link(pad, sinkpad) != GST_PAD_LINK_OK)
+        GST_WARNING_OBJECT (pad, "Failed to link to encoder");
+
+    gst_object_unref(sinkpad);
+}
+
+/* Runs on a pool thread, one pipeline per job */
+static void transcode_job_run(gpointer data, gpointer user_data) {
+    Transcoder *self = GST_TRANSCODER (user_data);
+    TranscodeJob *job = data;
+    GstElement *pipeline, *decoder, *encoder, *sink;
+    GstClockTime start, duration = GST_CLOCK_TIME_NONE;
+    GStatBuf st;
+    GError *err = NULL;
+    gboolean eos = FALSE;
+
+    GST_DEBUG_OBJECT (self, "Transcoding %s to %s", job->src_uri, job->dest_path);
+
+    start = gst_util_get_timestamp();
+
+    pipeline = gst_pipeline_new(NULL);
+    decoder = gst_element_factory_make("uridecodebin", NULL);
+    encoder = gst_element_factory_make("encodebin", NULL);
+    sink = gst_element_factory_make("filesink", NULL);
+
+    if (!decoder || !encoder || !sink) {
+        err = g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                          "uridecodebin, encodebin or filesink not available");
+        if (decoder)
+            gst_object_unref(decoder);
+        if (encoder)
+            gst_object_unref(encoder);
+        if (sink)
+            gst_object_unref(sink);
+    } else {
+        GstBus *bus;
+
+        /* Only expose the stream types the profile can encode */
+        g_object_set(decoder, "uri", job->src_uri, "caps", self->raw_caps,
+                     "expose-all-streams", FALSE, NULL);
+        g_object_set(encoder, "profile", self->profile, NULL);
+        g_object_set(sink, "location", job->dest_path, NULL);
+
+        gst_bin_add_many(GST_BIN (pipeline), decoder, encoder, sink, NULL);
+        gst_element_link(encoder, sink);
+        g_signal_connect (decoder, "pad-added",
+                          G_CALLBACK(decoder_pad_added_cb), encoder);
+
+        bus = gst_element_get_bus(pipeline);
+
+        if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+            err = g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                              "Failed to start transcoding %s", job->src_uri);
+
+        while (!eos && !err) {
+            GstMessage *msg;
+
+            msg = gst_bus_timed_pop_filtered(bus, PROGRESS_INTERVAL,
+                                             GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+            if (!msg) {
+                gint64 position, dur;
+
+                if (gst_element_query_duration(pipeline, GST_FORMAT_TIME, &dur))
+                    duration = dur;
+                if (gst_element_query_position(pipeline, GST_FORMAT_TIME, &position))
+                    emit_job_progress(self, job, position, duration);
+                continue;
+            }
+
+            if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS) {
+                eos = TRUE;
+            } else {
+                gchar *name = gst_object_get_path_string(msg->src);
+                GError *msg_err = NULL;
+
+                gst_message_parse_error(msg, &msg_err, NULL);
+                err = g_error_new(PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                                  "Error from element %s: %s", name, msg_err->message);
+                g_clear_error(&msg_err);
+                g_free(name);
+            }
+            gst_message_unref(msg);
+        }
+
+        if (eos) {
+            gint64 dur;
+
+            if (gst_element_query_duration(pipeline, GST_FORMAT_TIME, &dur))
+                duration = dur;
+            emit_job_progress(self, job, duration, duration);
+        }
+
+        gst_element_set_state(pipeline, GST_STATE_NULL);
+        gst_object_unref(bus);
+    }
+    gst_object_unref(pipeline);
+
+    GST_OBJECT_LOCK (self);
+    job->wall_time = gst_util_get_timestamp() - start;
+    job->duration = duration;
+    job->output_bytes = g_stat(job->dest_path, &st) == 0 ? (guint64) st.st_size : 0;
+    job->error = err;
+    GST_OBJECT_UNLOCK (self);
+
+    GST_DEBUG_OBJECT (self, "Finished %s: %s", job->src_uri, err ? err->message : "ok");
+
+    emit_job_done(self, job);
+
+    if (g_atomic_int_dec_and_test(&self->remaining)) {
+        GST_OBJECT_LOCK (self);
+        self->wall_time = gst_util_get_timestamp() - self->start_time;
+        GST_OBJECT_UNLOCK (self);
+
+        emit_done(self);
+    }
+}
+
+static gpointer transcoder_init_once(G_GNUC_UNUSED gpointer user_data) {
+    gst_init(NULL, NULL);
+    gst_pb_utils_init();
+
+    GST_DEBUG_CATEGORY_INIT (transcoder_debug, "transcoder", 0, "Transcoder");
+
+    return NULL;
+}
+
+/**
+ * transcoder_profile_new:
+ * @container_caps: (allow-none): caps of the container format, e.g.
+ * "audio/ogg", or %NULL/empty to write the encoded stream directly
+ * @audio_caps: caps of the audio encoding, e.g. "audio/x-vorbis"
+ * @error: return location for a #GError
+ *
+ * Returns: (transfer full): a new #GstEncodingProfile for encodebin,
+ * or %NULL if the caps could not be parsed.
+ */
+GstEncodingProfile *transcoder_profile_new(const gchar *container_caps,
+                                           const gchar *audio_caps,
+                                           GError **error) {
+    GstEncodingProfile *audio_profile;
+    GstEncodingContainerProfile *container_profile;
+    GstCaps *caps;
+
+    g_return_val_if_fail (audio_caps != NULL, NULL);
+
+    caps = gst_caps_from_string(audio_caps);
+    if (!caps) {
+        g_set_error(error, PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                    "Invalid audio caps '%s'", audio_caps);
+        return NULL;
+    }
+    audio_profile = (GstEncodingProfile *)
+            gst_encoding_audio_profile_new(caps, NULL, NULL, 0);
+    gst_caps_unref(caps);
+
+    if (!container_caps || !*container_caps)
+        return audio_profile;
+
+    caps = gst_caps_from_string(container_caps);
+    if (!caps) {
+        g_set_error(error, PLAYER_ERROR, PLAYER_ERROR_FAILED,
+                    "Invalid container caps '%s'", container_caps);
+        gst_encoding_profile_unref(audio_profile);
+        return NULL;
+    }
+    container_profile = gst_encoding_container_profile_new("transcode", NULL, caps, NULL);
+    gst_caps_unref(caps);
+
+    gst_encoding_container_profile_add_profile(container_profile, audio_profile);
+
+    return (GstEncodingProfile *) container_profile;
+}
+
+/**
+ * transcoder_new:
+ * @signal_dispatcher: (allow-none) (transfer full): dispatcher for the
+ * progress signals, see player_new()
+ * @profile: (transfer full): the encodebin profile for all jobs
+ * @output_dir: directory the encoded files are written to
+ * @extension: file extension of the encoded files
+ * @n_workers: number of concurrent pipelines, 0 for one per CPU core
+ *
+ * Returns: (transfer full): a new #Transcoder
+ */
+Transcoder *transcoder_new(PlayerSignalDispatcher *signal_dispatcher,
+                           GstEncodingProfile *profile,
+                           const gchar *output_dir,
+                           const gchar *extension,
+                           guint n_workers) {
+    static GOnce once = G_ONCE_INIT;
+    Transcoder *self;
+
+    g_return_val_if_fail (GST_IS_ENCODING_PROFILE(profile), NULL);
+    g_return_val_if_fail (output_dir != NULL, NULL);
+    g_return_val_if_fail (extension != NULL, NULL);
+
+    g_once (&once, transcoder_init_once, NULL);
+
+    self = g_object_new(GST_TYPE_TRANSCODER, NULL);
+    gst_object_ref_sink(self);
+
+    self->signal_dispatcher = signal_dispatcher;
+    self->profile = profile;
+    self->raw_caps = profile_get_raw_caps(profile);
+    self->output_dir = g_strdup(output_dir);
+    self->extension = g_strdup(extension);
+    self->n_workers = n_workers ? n_workers : g_get_num_processors();
+
+    return self;
+}
+
+static gchar *transcoder_make_destination(Transcoder *self, const gchar *uri) {
+    gchar *location, *basename, *dot, *name, *path;
+    guint n = 0;
+
+    location = gst_uri_get_location(uri);
+    basename = g_path_get_basename(location ? location : "");
+    g_free(location);
+
+    dot = strrchr(basename, '.');
+    if (dot && dot != basename)
+        *dot = '\0';
+    if (!*basename || g_str_equal(basename, G_DIR_SEPARATOR_S) || g_str_equal(basename, ".")) {
+        g_free(basename);
+        basename = g_strdup("track");
+    }
+
+    do {
+        if (n)
+            name = g_strdup_printf("%s-%u.%s", basename, n, self->extension);
+        else
+            name = g_strdup_printf("%s.%s", basename, self->extension);
+        path = g_build_filename(self->output_dir, name, NULL);
+        g_free(name);
+        n++;
+
+        if (!g_hash_table_contains(self->destinations, path))
+            break;
+        g_free(path);
+    } while (TRUE);
+
+    g_free(basename);
+
+    return path;
+}
+
+/**
+ * transcoder_add_uri:
+ * @transcoder: #Transcoder instance
+ * @uri: URI of the file to transcode
+ *
+ * Queues @uri for transcoding. Must be called before transcoder_start().
+ *
+ * Returns: the job index used in the signals.
+ */
+guint transcoder_add_uri(Transcoder *self, const gchar *uri) {
+    TranscodeJob *job;
+
+    g_return_val_if_fail (GST_IS_TRANSCODER(self), 0);
+    g_return_val_if_fail (uri != NULL, 0);
+    g_return_val_if_fail (self->pool == NULL, 0);
+
+    job = g_new0 (TranscodeJob, 1);
+    job->index = self->jobs->len;
+    job->src_uri = g_strdup(uri);
+    job->dest_path = transcoder_make_destination(self, uri);
+    job->duration = GST_CLOCK_TIME_NONE;
+    job->wall_time = GST_CLOCK_TIME_NONE;
+
+    g_hash_table_add(self->destinations, job->dest_path);
+    g_ptr_array_add(self->jobs, job);
+
+    return job->index;
+}
+
+guint transcoder_get_n_jobs(Transcoder *self) {
+    g_return_val_if_fail (GST_IS_TRANSCODER(self), 0);
+
+    return self->jobs->len;
+}
+
+guint transcoder_get_n_workers(Transcoder *self) {
+    g_return_val_if_fail (GST_IS_TRANSCODER(self), 0);
+
+    return self->n_workers;
+}
+
+const gchar *transcoder_get_source_uri(Transcoder *self, guint job) {
+    g_return_val_if_fail (GST_IS_TRANSCODER(self), NULL);
+    g_return_val_if_fail (job < self->jobs->len, NULL);
+
+    return ((TranscodeJob *) g_ptr_array_index (self->jobs, job))->src_uri;
+}
+
+const gchar *transcoder_get_destination(Transcoder *self, guint job) {
+    g_return_val_if_fail (GST_IS_TRANSCODER(self), NULL);
+    g_return_val_if_fail (job < self->jobs->len, NULL);
+
+    return ((TranscodeJob *) g_ptr_array_index (self->jobs, job))->dest_path;
+}
+
+/**
+ * transcoder_start:
+ * @transcoder: #Transcoder instance
+ *
+ * Runs all queued jobs on a pool of n-workers threads. The "done" signal
+ * is emitted once every job finished, successfully or not.
+ */
+void transcoder_start(Transcoder *self) {
+    guint i;
+
+    g_return_if_fail (GST_IS_TRANSCODER(self));
+    g_return_if_fail (self->pool == NULL);
+
+    GST_OBJECT_LOCK (self);
+    self->start_time = gst_util_get_timestamp();
+    GST_OBJECT_UNLOCK (self);
+
+    g_atomic_int_set(&self->remaining, self->jobs->len);
+    if (self->jobs->len == 0) {
+        GST_OBJECT_LOCK (self);
+        self->wall_time = 0;
+        GST_OBJECT_UNLOCK (self);
+        emit_done(self);
+        return;
+    }
+
+    self->pool = g_thread_pool_new(transcode_job_run, self, self->n_workers, FALSE, NULL);
+    for (i = 0; i < self->jobs->len; i++)
+        g_thread_pool_push(self->pool, g_ptr_array_index (self->jobs, i), NULL);
+}
+
+static void json_append_string(GString *json, const gchar *str) {
+    const gchar *p;
+
+    if (!str) {
+        g_string_append(json, "null");
+        return;
+    }
+
+    g_string_append_c(json, '"');
+    for (p = str; *p; p++) {
+        switch (*p) {
+            case '"':
+                g_string_append(json, "\\\"");
+                break;
+            case '\\':
+                g_string_append(json, "\\\\");
+                break;
+            case '\n':
+                g_string_append(json, "\\n");
+                break;
+            case '\t':
+                g_string_append(json, "\\t");
+                break;
+            default:
+                if ((guchar) *p < 0x20)
+                    g_string_append_printf(json, "\\u%04x", (guint) (guchar) *p);
+                else
+                    g_string_append_c(json, *p);
+                break;
+        }
+    }
+    g_string_append_c(json, '"');
+}
+
+static void json_append_double(GString *json, gdouble value) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    g_string_append(json, g_ascii_formatd(buf, sizeof(buf), "%.2f", value));
+}
+
+static gdouble realtime_factor(GstClockTime duration, GstClockTime wall_time) {
+    if (!GST_CLOCK_TIME_IS_VALID (duration) || !GST_CLOCK_TIME_IS_VALID (wall_time)
+        || wall_time == 0)
+        return 0.0;
+
+    return (gdouble) duration / (gdouble) wall_time;
+}
+
+/**
+ * transcoder_get_summary_json:
+ * @transcoder: #Transcoder instance
+ *
+ * Returns: (transfer full): a JSON object with per-job and overall
+ * throughput of the jobs finished so far.
+ */
+gchar *transcoder_get_summary_json(Transcoder *self) {
+    GString *json;
+    GstClockTime total_duration = 0, wall_time;
+    guint64 total_bytes = 0;
+    guint i, failed = 0;
+
+    g_return_val_if_fail (GST_IS_TRANSCODER(self), NULL);
+
+    json = g_string_new("{\n  \"items\": [");
+
+    GST_OBJECT_LOCK (self);
+    for (i = 0; i < self->jobs->len; i++) {
+        TranscodeJob *job = g_ptr_array_index (self->jobs, i);
+        const gchar *status;
+
+        if (job->error) {
+            status = "failed";
+            failed++;
+        } else if (GST_CLOCK_TIME_IS_VALID (job->wall_time)) {
+            status = "ok";
+            if (GST_CLOCK_TIME_IS_VALID (job->duration))
+                total_duration += job->duration;
+            total_bytes += job->output_bytes;
+        } else {
+            status = "pending";
+        }
+
+        g_string_append(json, i ? ",\n    {" : "\n    {");
+        g_string_append(json, "\"source\": ");
+        json_append_string(json, job->src_uri);
+        g_string_append(json, ", \"destination\": ");
+        json_append_string(json, job->dest_path);
+        g_string_append(json, ", \"status\": ");
+        json_append_string(json, status);
+        g_string_append(json, ", \"error\": ");
+        json_append_string(json, job->error ? job->error->message : NULL);
+        g_string_append_printf(json, ", \"duration_ms\": %" G_GUINT64_FORMAT,
+                               GST_CLOCK_TIME_IS_VALID (job->duration) ?
+                               job->duration / GST_MSECOND : 0);
+        g_string_append_printf(json, ", \"wall_time_ms\": %" G_GUINT64_FORMAT,
+                               GST_CLOCK_TIME_IS_VALID (job->wall_time) ?
+                               job->wall_time / GST_MSECOND : 0);
+        g_string_append(json, ", \"x_realtime\": ");
+        json_append_double(json, realtime_factor(job->duration, job->wall_time));
+        g_string_append_printf(json, ", \"output_bytes\": %" G_GUINT64_FORMAT "}",
+                               job->output_bytes);
+    }
+    wall_time = self->wall_time;
+    GST_OBJECT_UNLOCK (self);
+
+    g_string_append(json, self->jobs->len ? "\n  ],\n" : "],\n");
+    g_string_append_printf(json, "  \"workers\": %u,\n", self->n_workers);
+    g_string_append_printf(json, "  \"jobs\": %u,\n", self->jobs->len);
+    g_string_append_printf(json, "  \"failed\": %u,\n", failed);
+    g_string_append_printf(json, "  \"media_duration_ms\": %" G_GUINT64_FORMAT ",\n",
+                           total_duration / GST_MSECOND);
+    g_string_append_printf(json, "  \"wall_time_ms\": %" G_GUINT64_FORMAT ",\n",
+                           GST_CLOCK_TIME_IS_VALID (wall_time) ? wall_time / GST_MSECOND : 0);
+    g_string_append(json, "  \"x_realtime\": ");
+    json_append_double(json, realtime_factor(total_duration, wall_time));
+    g_string_append_printf(json, ",\n  \"output_bytes\": %" G_GUINT64_FORMAT "\n}\n",
+                           total_bytes);
+
+    return g_string_free(json, FALSE);
+}
@@ -0,0 +1,48 @@
+#ifndef __TRANSCODER_H__
+#define __TRANSCODER_H__
+
+#include <gst/gst.h>
+#include <gst/pbutils/encoding-profile.h>
+#include "PlayerSignalDispatcher.h"
+
+G_BEGIN_DECLS
+
+typedef struct _Transcoder Transcoder;
+typedef struct _TranscoderClass TranscoderClass;
+
+#define GST_TYPE_TRANSCODER             (transcoder_get_type ())
+#define GST_IS_TRANSCODER(obj)          (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_TRANSCODER))
+#define GST_IS_TRANSCODER_CLASS(klass)  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_TRANSCODER))
+#define GST_TRANSCODER_GET_CLASS(obj)   (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_TRANSCODER, TranscoderClass))
+#define GST_TRANSCODER(obj)             (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_TRANSCODER, Transcoder))
+#define GST_TRANSCODER_CLASS(klass)     (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_TRANSCODER, TranscoderClass))
+
+GType transcoder_get_type(void);
+
+GstEncodingProfile *transcoder_profile_new(const gchar *container_caps,
+                                           const gchar *audio_caps,
+                                           GError **error);
+
+Transcoder *transcoder_new(PlayerSignalDispatcher *signal_dispatcher,
+                           GstEncodingProfile *profile,
+                           const gchar *output_dir,
+                           const gchar *extension,
+                           guint n_workers);
+
+guint transcoder_add_uri(Transcoder *transcoder, const gchar *uri);
+
+guint transcoder_get_n_jobs(Transcoder *transcoder);
+
+guint transcoder_get_n_workers(Transcoder *transcoder);
+
+const gchar *transcoder_get_source_uri(Transcoder *transcoder, guint job);
+
+const gchar *transcoder_get_destination(Transcoder *transcoder, guint job);
+
+void transcoder_start(Transcoder *transcoder);
+
+gchar *transcoder_get_summary_json(Transcoder *transcoder);
+
+G_END_DECLS
+
+#endif /* __TRANSCODER_H__ */
@@ -0,0 +1,977 @@
+#include <gst/gst.h>
+#include <string.h>
+
+#include "Player.h"
+#include "PlayerPrivate.h"
+#include "Playlist.h"
+
+GST_DEBUG_CATEGORY (bench_debug);
+#define GST_CAT_DEFAULT bench_debug
+
+typedef struct {
+    GMainLoop *loop;
+    gboolean failed;
+    PlayerFingerprint *fingerprint;
+} OfflineRun;
+
+static void offline_end_of_stream_cb(Player *player, OfflineRun *run) {
+    g_main_loop_quit(run->loop);
+}
+
+static void offline_media_info_updated_cb(Player *player, PlayerMediaInfo *info,
+                                         OfflineRun *run) {
+    PlayerFingerprint *fingerprint = player_media_info_get_fingerprint(info);
+
+    if (fingerprint && !run->fingerprint)
+        run->fingerprint = player_fingerprint_ref(fingerprint);
+}
+
+static void offline_error_cb(Player *player, GError *err, OfflineRun *run) {
+    g_printerr("ERROR %s\n", err->message);
+
+    run->failed = TRUE;
+    g_main_loop_quit(run->loop);
+}
+
+/* Decodes every input as fast as possible and reports the throughput as a
+ * multiple of realtime, per input and for the whole run. With fingerprint
+ * the inputs are also matched against each other. With http_cache HTTP
+ * inputs are read through the block cache, e.g. from
+ *   python3 -m http.server
+ * passing the same URI twice shows the second pass served from disk. */
+static void bench_offline(GPtrArray *uris, gboolean fingerprint, gboolean http_cache) {
+    Player *player;
+    GstStructure *config;
+    PlayerFingerprintIndex *index;
+    OfflineRun run = {NULL, FALSE, NULL};
+    GstClockTime total_duration = 0, total_wall = 0;
+    guint i;
+
+    player = player_new(player_main_context_signal_dispatcher_new(NULL));
+
+    config = player_get_config(player);
+    player_config_set_offline(config, TRUE);
+    player_config_set_fingerprint(config, fingerprint);
+    player_config_set_http_cache(config, http_cache);
+    if (!player_set_config(player, config)) {
+        g_printerr("Could not enable offline mode\n");
+        gst_object_unref(player);
+        return;
+    }
+
+    run.loop = g_main_loop_new(NULL, FALSE);
+    player_signal_connect(player, "end-of-stream",
+                          G_CALLBACK(offline_end_of_stream_cb), &run);
+    player_signal_connect(player, "error", G_CALLBACK(offline_error_cb), &run);
+    player_signal_connect(player, "media-info-updated",
+                          G_CALLBACK(offline_media_info_updated_cb), &run);
+    index = player_fingerprint_index_new();
+
+    g_print("offline decode\n");
+    g_print("  %-48s %14s %14s %10s\n", "input", "duration", "wall", "x-realtime");
+
+    for (i = 0; i < uris->len; i++) {
+        GstClockTime start, wall, duration;
+        const gchar *uri = g_ptr_array_index (uris, i);
+
+        run.failed = FALSE;
+        start = gst_util_get_timestamp();
+        player_set_uri(player, uri);
+        player_play(player);
+        g_main_loop_run(run.loop);
+        wall = gst_util_get_timestamp() - start;
+
+        if (!run.failed) {
+            duration = player_get_duration(player);
+            if (GST_CLOCK_TIME_IS_VALID (duration)) {
+                total_duration += duration;
+                total_wall += wall;
+            }
+
+            g_print("  %-48s %" GST_TIME_FORMAT " %" GST_TIME_FORMAT " %9.1fx\n",
+                    uri, GST_TIME_ARGS (duration), GST_TIME_ARGS (wall),
+                    player_get_realtime_factor(player));
+        }
+
+        if (run.fingerprint) {
+            GArray *matches = player_fingerprint_index_lookup(index, run.fingerprint, 0.65, 1);
+
+            if (matches->len > 0) {
+                PlayerFingerprintMatch *match = &g_array_index (matches, PlayerFingerprintMatch, 0);
+
+                g_print("    duplicate of %s (score %.2f)\n",
+                        (const gchar *) g_ptr_array_index (uris, match->id), match->score);
+            }
+            g_array_unref(matches);
+
+            player_fingerprint_index_add(index, i, run.fingerprint);
+            player_fingerprint_unref(run.fingerprint);
+            run.fingerprint = NULL;
+        }
+
+        player_stop(player);
+    }
+
+    if (total_wall > 0)
+        g_print("  %-48s %" GST_TIME_FORMAT " %" GST_TIME_FORMAT " %9.1fx\n",
+                "total", GST_TIME_ARGS (total_duration), GST_TIME_ARGS (total_wall),
+                (gdouble) total_duration / (gdouble) total_wall);
+
+    if (http_cache) {
+        PlayerHttpCacheStats stats;
+
+        player_http_cache_get_stats(&stats);
+        g_print("http cache: %" G_GUINT64_FORMAT " hits, %" G_GUINT64_FORMAT " misses"
+                " (%.1f%% hit ratio), %" G_GUINT64_FORMAT " bytes cached, %"
+                G_GUINT64_FORMAT " evictions\n", stats.hits, stats.misses,
+                stats.hit_ratio * 100.0, stats.cached_bytes, stats.n_evictions);
+    }
+
+    player_fingerprint_index_free(index);
+    gst_object_unref(player);
+    g_main_loop_unref(run.loop);
+}
+
+typedef struct {
+    GMainLoop *loop;
+    Player *player;
+    gboolean failed;
+    guint settle_source;
+} LatencyRun;
+
+static gboolean latency_settled_cb(LatencyRun *run) {
+    run->settle_source = 0;
+    g_main_loop_quit(run->loop);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void latency_state_changed_cb(Player *player, PlayerState state, LatencyRun *run) {
+    /* Give the sinks a moment to report their final latency */
+    if (state == PLAYER_STATE_PLAYING && run->settle_source == 0)
+        run->settle_source = g_timeout_add(1000, (GSourceFunc) latency_settled_cb, run);
+}
+
+static void latency_error_cb(Player *player, GError *err, LatencyRun *run) {
+    g_printerr("ERROR %s\n", err->message);
+
+    run->failed = TRUE;
+    g_main_loop_quit(run->loop);
+}
+
+/* Plays every input in low-latency mode and reports the pipeline latency,
+ * e.g. for an RTP loopback started with
+ *   gst-launch-1.0 audiotestsrc is-live=true !
+ *       audio/x-raw,rate=48000,channels=2 ! audioconvert ! rtpL16pay pt=96 !
+ *       udpsink host=127.0.0.1 port=5004
+ * and played from file:///tmp/loopback.sdp containing
+ *   v=0
+ *   o=- 0 0 IN IP4 127.0.0.1
+ *   s=loopback
+ *   c=IN IP4 127.0.0.1
+ *   t=0 0
+ *   m=audio 5004 RTP/AVP 96
+ *   a=rtpmap:96 L16/48000/2
+ * A bare udp:// URI does not work, as udpsrc has no RTP caps to depayload
+ * with. */
+static void bench_latency(GPtrArray *uris) {
+    GstStructure *config;
+    LatencyRun run = {NULL, NULL, FALSE, 0};
+    guint i;
+
+    run.player = player_new(player_main_context_signal_dispatcher_new(NULL));
+
+    config = player_get_config(run.player);
+    player_config_set_low_latency(config, TRUE);
+    if (!player_set_config(run.player, config)) {
+        g_printerr("Could not enable low-latency mode\n");
+        gst_object_unref(run.player);
+        return;
+    }
+
+    run.loop = g_main_loop_new(NULL, FALSE);
+    player_signal_connect(run.player, "state-changed",
+                          G_CALLBACK(latency_state_changed_cb), &run);
+    player_signal_connect(run.player, "error", G_CALLBACK(latency_error_cb), &run);
+
+    g_print("low-latency playback\n");
+    g_print("  %-48s %14s %6s\n", "input", "latency", "live");
+
+    for (i = 0; i < uris->len; i++) {
+        const gchar *uri = g_ptr_array_index (uris, i);
+        GstClockTime latency;
+        gboolean live;
+
+        run.failed = FALSE;
+        player_set_uri(run.player, uri);
+        player_play(run.player);
+        g_main_loop_run(run.loop);
+
+        if (!run.failed) {
+            latency = player_get_latency(run.player, &live);
+            g_print("  %-48s %" GST_TIME_FORMAT " %6s\n",
+                    uri, GST_TIME_ARGS (latency), live ? "yes" : "no");
+        }
+
+        if (run.settle_source) {
+            g_source_remove(run.settle_source);
+            run.settle_source = 0;
+        }
+        player_stop(run.player);
+    }
+
+    gst_object_unref(run.player);
+    g_main_loop_unref(run.loop);
+}
+
+typedef struct {
+    GMainLoop *loop;
+    gboolean failed;
+} MirrorRun;
+
+static void mirrors_state_changed_cb(Player *player, PlayerState state, MirrorRun *run) {
+    if (state == PLAYER_STATE_PLAYING)
+        g_main_loop_quit(run->loop);
+}
+
+static void mirrors_error_cb(Player *player, GError *err, MirrorRun *run) {
+    g_printerr("ERROR %s\n", err->message);
+
+    run->failed = TRUE;
+    g_main_loop_quit(run->loop);
+}
+
+/* Treats the inputs as mirrors of one item and reports the startup time
+ * and the time to first byte per mirror, e.g. for two local servers
+ *   python3 -m http.server 8001 & python3 -m http.server 8002 &
+ * with one of them stopped to exercise the fallback. */
+static void bench_mirrors(GPtrArray *uris, guint rounds) {
+    Player *player;
+    MirrorRun run = {NULL, FALSE};
+    GArray *stats;
+    guint i;
+
+    player = player_new(player_main_context_signal_dispatcher_new(NULL));
+    run.loop = g_main_loop_new(NULL, FALSE);
+    player_signal_connect(player, "state-changed", G_CALLBACK(mirrors_state_changed_cb), &run);
+    player_signal_connect(player, "error", G_CALLBACK(mirrors_error_cb), &run);
+
+    g_ptr_array_add(uris, NULL);
+    player_set_mirrors(player, (const gchar *const *) uris->pdata);
+    g_ptr_array_remove_index(uris, uris->len - 1);
+
+    g_print("mirror startup\n");
+    for (i = 0; i < rounds && !run.failed; i++) {
+        GstClockTime start = gst_util_get_timestamp();
+
+        player_play(player);
+        g_main_loop_run(run.loop);
+        if (!run.failed)
+            g_print("  round %-3u %" GST_TIME_FORMAT "\n", i,
+                    GST_TIME_ARGS (gst_util_get_timestamp() - start));
+        player_stop(player);
+    }
+
+    stats = player_get_mirror_stats(player);
+    g_print("  %-48s %14s %6s %8s\n", "mirror", "ttfb", "wins", "failures");
+    for (i = 0; i < stats->len; i++) {
+        PlayerMirrorStats *mirror = &g_array_index (stats, PlayerMirrorStats, i);
+
+        g_print("  %-48s %" GST_TIME_FORMAT " %6u %8u\n", mirror->uri,
+                GST_TIME_ARGS (mirror->ttfb), mirror->n_wins, mirror->n_failures);
+    }
+    g_array_unref(stats);
+
+    gst_object_unref(player);
+    g_main_loop_unref(run.loop);
+}
+
+typedef struct {
+    GMainLoop *loop;
+    guint pending;
+    guint failed;
+} PrerollRun;
+
+static void preroll_state_changed_cb(Player *player, PlayerState state, PrerollRun *run) {
+    if (state == PLAYER_STATE_PAUSED && g_object_get_data(G_OBJECT (player), "bench-done") == NULL) {
+        g_object_set_data(G_OBJECT (player), "bench-done", GINT_TO_POINTER (1));
+        if (--run->pending == 0)
+            g_main_loop_quit(run->loop);
+    }
+}
+
+static void preroll_error_cb(Player *player, GError *err, PrerollRun *run) {
+    g_printerr("ERROR %s\n", err->message);
+
+    run->failed++;
+    preroll_state_changed_cb(player, PLAYER_STATE_PAUSED, run);
+}
+
+/* Creates n_players players spread over the inputs and waits until all of
+ * them are paused. Returns the number of players that failed. */
+static guint preroll_players(GPtrArray *uris, Player **players, guint n_players) {
+    PrerollRun run = {NULL, n_players, 0};
+    guint i;
+
+    run.loop = g_main_loop_new(NULL, FALSE);
+    for (i = 0; i < n_players; i++) {
+        players[i] = player_new(player_main_context_signal_dispatcher_new(NULL));
+        player_signal_connect(players[i], "state-changed", G_CALLBACK(preroll_state_changed_cb), &run);
+        player_signal_connect(players[i], "error", G_CALLBACK(preroll_error_cb), &run);
+        player_set_uri(players[i], g_ptr_array_index (uris, i % uris->len));
+        player_pause(players[i]);
+    }
+    if (n_players > 0)
+        g_main_loop_run(run.loop);
+
+    for (i = 0; i < n_players; i++) {
+        g_signal_handlers_disconnect_by_data(players[i], &run);
+        g_object_set_data(G_OBJECT (players[i]), "bench-done", NULL);
+    }
+    g_main_loop_unref(run.loop);
+
+    return run.failed;
+}
+
+static void print_task_pool_stats(void) {
+    PlayerTaskPoolStats stats;
+
+    player_task_pool_get_stats(&stats);
+    g_print("  task pool: %u threads (%u busy, %u idle, peak %u), %" G_GUINT64_FORMAT
+            " created for %" G_GUINT64_FORMAT " tasks, %" G_GUINT64_FORMAT " reused\n",
+            stats.n_threads, stats.n_busy_threads, stats.n_idle_threads, stats.peak_threads,
+            stats.n_threads_created, stats.n_tasks, stats.n_reused);
+    g_print("  task pool wait: avg %" GST_TIME_FORMAT ", max %" GST_TIME_FORMAT "\n",
+            GST_TIME_ARGS (stats.queue_wait_avg), GST_TIME_ARGS (stats.queue_wait_max));
+}
+
+/* Prerolls n_players players spread over the inputs, as a service playing
+ * one catalog to many listeners would, and reports how much of their stream
+ * tags and caps is shared */
+static void bench_tag_store(GPtrArray *uris, guint n_players) {
+    PlayerTagStoreStats stats;
+    Player **players;
+    guint failed, i;
+
+    players = g_new (Player *, n_players);
+    failed = preroll_players(uris, players, n_players);
+
+    player_tag_store_get_stats(&stats);
+    g_print("tag store with %u players on %u inputs, %u failed\n", n_players, uris->len, failed);
+    g_print("  %" G_GUINT64_FORMAT " lookups, %" G_GUINT64_FORMAT " shared\n",
+            stats.n_lookups, stats.n_shared);
+    g_print("  %u tag lists, %u caps, %" G_GUINT64_FORMAT " references\n",
+            stats.n_tag_lists, stats.n_caps, stats.n_references);
+    g_print("  dedup ratio %.1f, ~%" G_GUINT64_FORMAT " bytes saved\n",
+            stats.dedup_ratio, stats.bytes_saved);
+    print_task_pool_stats();
+
+    for (i = 0; i < n_players; i++) {
+        player_stop(players[i]);
+        gst_object_unref(players[i]);
+    }
+    g_free(players);
+}
+
+static void print_phase(const gchar *phase, guint n_players, GstClockTime elapsed) {
+    g_print("  %-24s %" GST_TIME_FORMAT " %10.1f us/player\n", phase, GST_TIME_ARGS (elapsed),
+            (gdouble) elapsed / GST_USECOND / n_players);
+}
+
+/* Creates n_players players as a service would at startup, then gives
+ * each one a URI, which is when its pipeline is built, and disposes of
+ * them again */
+static void bench_startup(GPtrArray *uris, guint n_players) {
+    Player **players;
+    GstClockTime start;
+    guint i;
+
+    players = g_new (Player *, n_players);
+
+    g_print("startup of %u players\n", n_players);
+
+    start = gst_util_get_timestamp();
+    for (i = 0; i < n_players; i++)
+        players[i] = player_new(NULL);
+    print_phase("player_new", n_players, gst_util_get_timestamp() - start);
+
+    if (uris->len > 0) {
+        start = gst_util_get_timestamp();
+        for (i = 0; i < n_players; i++)
+            player_set_uri(players[i], g_ptr_array_index (uris, i % uris->len));
+        print_phase("player_set_uri", n_players, gst_util_get_timestamp() - start);
+    }
+
+    start = gst_util_get_timestamp();
+    for (i = 0; i < n_players; i++)
+        gst_object_unref(players[i]);
+    print_phase("dispose", n_players, gst_util_get_timestamp() - start);
+
+    g_free(players);
+}
+
+static void tick_position_updated_cb(G_GNUC_UNUSED Player *player, G_GNUC_UNUSED GstClockTime position,
+                                     G_GNUC_UNUSED gpointer user_data) {
+}
+
+static GstClockTime tick_run(guint n_handlers, gboolean counted, guint n_iterations) {
+    Player *player = player_new(NULL);
+    GstClockTime start, elapsed;
+    guint i;
+
+    for (i = 0; i < n_handlers; i++) {
+        if (counted)
+            player_signal_connect(player, "position-updated", G_CALLBACK(tick_position_updated_cb), NULL);
+        else
+            g_signal_connect (player, "position-updated", G_CALLBACK(tick_position_updated_cb), NULL);
+    }
+
+    start = gst_util_get_timestamp();
+    for (i = 0; i < n_iterations; i++)
+        player_announce_position(player, i * GST_MSECOND);
+    elapsed = gst_util_get_timestamp() - start;
+
+    gst_object_unref(player);
+
+    return elapsed;
+}
+
+/* Times the player's work per position tick, handlers called inline, with
+ * handlers connected through player_signal_connect() and plainly */
+static void bench_tick(guint n_iterations) {
+    static const guint n_handlers[] = {0, 1, 8};
+    GstClockTime counted, plain;
+    guint i;
+
+    g_print("position tick, %u iterations\n", n_iterations);
+    g_print("  %-10s %14s %14s\n", "handlers", "counted", "plain");
+
+    for (i = 0; i < G_N_ELEMENTS (n_handlers); i++) {
+        counted = tick_run(n_handlers[i], TRUE, n_iterations);
+        plain = tick_run(n_handlers[i], FALSE, n_iterations);
+
+        g_print("  %-10u %11.1f ns %11.1f ns\n", n_handlers[i],
+                (gdouble) counted / n_iterations, (gdouble) plain / n_iterations);
+    }
+}
+
+typedef struct {
+    PlayerSignalDispatcher *dispatcher;
+    guint n_events;
+    GArray *latencies;      /* GstClockTime, touched by the emitting thread only */
+    gint n_delivered;       /* atomic */
+    GMainLoop *loop;
+} DispatchRun;
+
+typedef struct {
+    DispatchRun *run;
+    GstClockTime sent;
+} DispatchEvent;
+
+static void dispatch_event_emit(gpointer data) {
+    DispatchEvent *event = data;
+    GstClockTime latency = gst_util_get_timestamp() - event->sent;
+
+    g_array_append_val (event->run->latencies, latency);
+    if (g_atomic_int_add(&event->run->n_delivered, 1) + 1 == (gint) event->run->n_events
+        && event->run->loop)
+        g_main_loop_quit(event->run->loop);
+}
+
+/* Stands in for a player thread, dispatching events 1 ms apart */
+static gpointer dispatch_producer(gpointer data) {
+    DispatchRun *run = data;
+    PlayerSignalDispatcherInterface *iface = GST_PLAYER_SIGNAL_DISPATCHER_GET_INTERFACE (run->dispatcher);
+    guint i;
+
+    for (i = 0; i < run->n_events; i++) {
+        DispatchEvent *event = g_new (DispatchEvent, 1);
+
+        event->run = run;
+        event->sent = gst_util_get_timestamp();
+        iface->dispatch(run->dispatcher, NULL, dispatch_event_emit, event, g_free);
+        g_usleep(1000);
+    }
+
+    return NULL;
+}
+
+static gint compare_clock_time(gconstpointer a, gconstpointer b) {
+    GstClockTime ta = *(const GstClockTime *) a, tb = *(const GstClockTime *) b;
+
+    return ta < tb ? -1 : ta > tb;
+}
+
+static void print_dispatch_latency(const gchar *name, GArray *latencies) {
+    GstClockTime sum = 0;
+    guint i;
+
+    g_array_sort(latencies, compare_clock_time);
+    for (i = 0; i < latencies->len; i++)
+        sum += g_array_index (latencies, GstClockTime, i);
+
+    g_print("  %-14s %10.1f us %10.1f us %10.1f us %10.1f us\n", name,
+            (gdouble) sum / latencies->len / GST_USECOND,
+            (gdouble) g_array_index (latencies, GstClockTime, latencies->len / 2) / GST_USECOND,
+            (gdouble) g_array_index (latencies, GstClockTime, latencies->len * 99 / 100) / GST_USECOND,
+            (gdouble) g_array_index (latencies, GstClockTime, latencies->len - 1) / GST_USECOND);
+}
+
+/* Measures the time from dispatching a player event to its emission for
+ * the main context, fd and synchronous dispatchers */
+static void bench_dispatch(guint n_events) {
+    DispatchRun run;
+    GThread *producer;
+    GPollFD pfd;
+
+    g_print("event delivery latency over %u events\n", n_events);
+    g_print("  %-14s %13s %13s %13s %13s\n", "dispatcher", "avg", "median", "p99", "max");
+
+    /* Main context of this thread */
+    memset(&run, 0, sizeof(run));
+    run.n_events = n_events;
+    run.latencies = g_array_sized_new(FALSE, FALSE, sizeof(GstClockTime), n_events);
+    run.dispatcher = player_main_context_signal_dispatcher_new(NULL);
+    run.loop = g_main_loop_new(NULL, FALSE);
+    producer = g_thread_new("producer", dispatch_producer, &run);
+    g_main_loop_run(run.loop);
+    g_thread_join(producer);
+    print_dispatch_latency("main-context", run.latencies);
+    g_main_loop_unref(run.loop);
+    g_object_unref(run.dispatcher);
+    g_array_unref(run.latencies);
+
+    /* Plain poll() loop on the fd */
+    memset(&run, 0, sizeof(run));
+    run.n_events = n_events;
+    run.latencies = g_array_sized_new(FALSE, FALSE, sizeof(GstClockTime), n_events);
+    run.dispatcher = player_fd_signal_dispatcher_new(0);
+    pfd.fd = player_fd_signal_dispatcher_get_fd(run.dispatcher);
+    pfd.events = G_IO_IN;
+    producer = g_thread_new("producer", dispatch_producer, &run);
+    while ((guint) g_atomic_int_get(&run.n_delivered) < n_events) {
+        if (g_poll(&pfd, 1, -1) > 0)
+            player_fd_signal_dispatcher_dispatch_pending(run.dispatcher, 0);
+    }
+    g_thread_join(producer);
+    print_dispatch_latency("fd", run.latencies);
+    g_object_unref(run.dispatcher);
+    g_array_unref(run.latencies);
+
+    /* Emitted on the producer thread */
+    memset(&run, 0, sizeof(run));
+    run.n_events = n_events;
+    run.latencies = g_array_sized_new(FALSE, FALSE, sizeof(GstClockTime), n_events);
+    run.dispatcher = player_sync_signal_dispatcher_new();
+    producer = g_thread_new("producer", dispatch_producer, &run);
+    g_thread_join(producer);
+    print_dispatch_latency("sync", run.latencies);
+    g_object_unref(run.dispatcher);
+    g_array_unref(run.latencies);
+}
+
+typedef struct {
+    GMainLoop *loop;
+    gboolean failed;
+} BusRun;
+
+static void bus_error_cb(Player *player, GError *err, BusRun *run) {
+    g_printerr("ERROR %s\n", err->message);
+
+    run->failed = TRUE;
+    g_main_loop_quit(run->loop);
+}
+
+static void bus_end_of_stream_cb(Player *player, BusRun *run) {
+    g_main_loop_quit(run->loop);
+}
+
+static gboolean bus_timeout_cb(BusRun *run) {
+    g_main_loop_quit(run->loop);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void bus_message_signal_cb(G_GNUC_UNUSED GstBus *bus, G_GNUC_UNUSED GstMessage *msg,
+                                  guint *count) {
+    (*count)++;
+}
+
+static gboolean bus_message_switch_cb(G_GNUC_UNUSED GstBus *bus, GstMessage *msg, gpointer user_data) {
+    guint *count = user_data;
+
+    switch (GST_MESSAGE_TYPE (msg)) {
+        case GST_MESSAGE_ERROR:
+        case GST_MESSAGE_WARNING:
+        case GST_MESSAGE_EOS:
+        case GST_MESSAGE_STATE_CHANGED:
+        case GST_MESSAGE_BUFFERING:
+        case GST_MESSAGE_CLOCK_LOST:
+        case GST_MESSAGE_DURATION_CHANGED:
+        case GST_MESSAGE_LATENCY:
+        case GST_MESSAGE_REQUEST_STATE:
+        case GST_MESSAGE_ELEMENT:
+        case GST_MESSAGE_TAG:
+        case GST_MESSAGE_HAVE_CONTEXT:
+        case GST_MESSAGE_STREAM_COLLECTION:
+        case GST_MESSAGE_STREAMS_SELECTED:
+            (*count)++;
+            break;
+        default:
+            break;
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+/* Posts n_messages messages of the mix a playing pipeline sends and times
+ * dispatching them on the player's former path, a signal watch with one
+ * detailed handler per message type, and on its current single switch */
+static GstClockTime bus_dispatch_run(guint n_messages, gboolean signals) {
+    static const gchar *details[] = {
+            "error", "warning", "eos", "state-changed", "buffering", "clock-lost",
+            "duration-changed", "latency", "request-state", "element", "tag",
+            "have-context", "stream-collection", "streams-selected"
+    };
+    GstBus *bus = gst_bus_new();
+    GstClockTime start;
+    guint i, count = 0;
+
+    if (signals) {
+        gst_bus_add_signal_watch(bus);
+        for (i = 0; i < G_N_ELEMENTS (details); i++) {
+            gchar *name = g_strconcat("message::", details[i], NULL);
+
+            g_signal_connect (bus, name, G_CALLBACK(bus_message_signal_cb), &count);
+            g_free(name);
+        }
+    } else {
+        gst_bus_add_watch(bus, bus_message_switch_cb, &count);
+    }
+
+    for (i = 0; i < n_messages; i++) {
+        GstMessage *msg;
+
+        switch (i % 4) {
+            case 0:
+                msg = gst_message_new_state_changed(NULL, GST_STATE_READY, GST_STATE_PAUSED,
+                                                    GST_STATE_VOID_PENDING);
+                break;
+            case 1:
+                msg = gst_message_new_element(NULL, gst_structure_new_empty("level"));
+                break;
+            case 2:
+                msg = gst_message_new_tag(NULL, gst_tag_list_new_empty());
+                break;
+            default:
+                msg = gst_message_new_latency(NULL);
+                break;
+        }
+        gst_bus_post(bus, msg);
+    }
+
+    start = gst_util_get_timestamp();
+    while (count < n_messages)
+        g_main_context_iteration(NULL, TRUE);
+    start = gst_util_get_timestamp() - start;
+
+    if (signals)
+        gst_bus_remove_signal_watch(bus);
+    else
+        gst_bus_remove_watch(bus);
+    gst_object_unref(bus);
+
+    return start;
+}
+
+static void bench_bus_dispatch(guint n_messages) {
+    g_print("bus dispatch of %u messages
+", n_messages);
+    print_phase("signal watch (before)", n_messages, bus_dispatch_run(n_messages, TRUE));
+    print_phase("switch (after)", n_messages, bus_dispatch_run(n_messages, FALSE));
+}
+
+/* Plays every input for the given time and reports the cost of handling
+ * pipeline messages per second of playback */
+static void bench_bus(GPtrArray *uris, guint seconds) {
+    BusRun run = {NULL, FALSE};
+    guint i;
+
+    run.loop = g_main_loop_new(NULL, FALSE);
+
+    g_print("bus messages over %u s of playback\n", seconds);
+    g_print("  %-48s %10s %10s %14s\n", "input", "handled/s", "dropped/s", "handling/s");
+
+    for (i = 0; i < uris->len; i++) {
+        const gchar *uri = g_ptr_array_index (uris, i);
+        Player *player;
+        PlayerBusStats stats;
+        GstClockTime position;
+        gdouble played;
+        guint timeout;
+
+        player = player_new(player_main_context_signal_dispatcher_new(NULL));
+        player_signal_connect(player, "error", G_CALLBACK(bus_error_cb), &run);
+        player_signal_connect(player, "end-of-stream", G_CALLBACK(bus_end_of_stream_cb), &run);
+
+        run.failed = FALSE;
+        timeout = g_timeout_add_seconds(seconds, (GSourceFunc) bus_timeout_cb, &run);
+        player_set_uri(player, uri);
+        player_play(player);
+        g_main_loop_run(run.loop);
+        g_source_remove(timeout);
+
+        position = player_get_position(player);
+        player_get_bus_stats(player, &stats);
+        if (!run.failed && GST_CLOCK_TIME_IS_VALID (position) && position > 0) {
+            played = (gdouble) position / GST_SECOND;
+            g_print("  %-48s %10.1f %10.1f %11.1f us\n", uri,
+                    stats.n_messages / played, stats.n_dropped / played,
+                    (gdouble) stats.handling_time / GST_USECOND / played);
+        }
+
+        gst_object_unref(player);
+    }
+
+    g_main_loop_unref(run.loop);
+}
+
+static void dispose_many_done_cb(G_GNUC_UNUSED GObject *source, GAsyncResult *result, gpointer user_data) {
+    player_dispose_many_finish(result, NULL);
+    g_main_loop_quit(user_data);
+}
+
+/* Prerolls two sets of n_players players and tears down the first one by
+ * one and the second one with player_dispose_many_async() */
+static void bench_shutdown(GPtrArray *uris, guint n_players) {
+    GMainLoop *loop;
+    Player **players;
+    GstClockTime start;
+    guint failed, i;
+
+    players = g_new (Player *, n_players);
+
+    failed = preroll_players(uris, players, n_players);
+    g_print("shutdown of %u paused players, %u failed\n", n_players, failed);
+    print_task_pool_stats();
+    start = gst_util_get_timestamp();
+    for (i = 0; i < n_players; i++)
+        gst_object_unref(players[i]);
+    print_phase("sequential dispose", n_players, gst_util_get_timestamp() - start);
+
+    preroll_players(uris, players, n_players);
+    loop = g_main_loop_new(NULL, FALSE);
+    start = gst_util_get_timestamp();
+    player_dispose_many_async(players, n_players, dispose_many_done_cb, loop);
+    g_main_loop_run(loop);
+    print_phase("player_dispose_many", n_players, gst_util_get_timestamp() - start);
+    print_task_pool_stats();
+
+    g_main_loop_unref(loop);
+    g_free(players);
+}
+
+static gboolean warm_settle_cb(GMainLoop *loop) {
+    g_main_loop_quit(loop);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Stops and prerolls one player again n_restarts times, once keeping its
+ * pipeline warm while stopped and once releasing it, and reports the time
+ * to paused */
+static void bench_warm(GPtrArray *uris, guint n_restarts) {
+    static const PlayerIdleHint hints[] = {PLAYER_IDLE_HINT_KEEP_WARM, PLAYER_IDLE_HINT_RELEASE};
+    static const gchar *names[] = {"warm restart", "cold restart"};
+    PlayerWarmPoolStats stats;
+    GMainLoop *loop;
+    guint i, j;
+
+    loop = g_main_loop_new(NULL, FALSE);
+
+    g_print("restart to paused, %u times
+", n_restarts);
+
+    for (i = 0; i < G_N_ELEMENTS (hints); i++) {
+        PrerollRun run = {loop, 0, 0};
+        GstClockTime start, elapsed = 0;
+        Player *player;
+
+        if (preroll_players(uris, &player, 1) > 0) {
+            gst_object_unref(player);
+            continue;
+        }
+        player_set_idle_hint(player, hints[i]);
+        player_signal_connect(player, "state-changed", G_CALLBACK(preroll_state_changed_cb), &run);
+        player_signal_connect(player, "error", G_CALLBACK(preroll_error_cb), &run);
+
+        for (j = 0; j < n_restarts; j++) {
+            player_stop(player);
+            /* Give a released pipeline time to reach NULL */
+            g_timeout_add(100, (GSourceFunc) warm_settle_cb, loop);
+            g_main_loop_run(loop);
+
+            run.pending = 1;
+            g_object_set_data(G_OBJECT (player), "bench-done", NULL);
+            start = gst_util_get_timestamp();
+            player_pause(player);
+            g_main_loop_run(loop);
+            elapsed += gst_util_get_timestamp() - start;
+        }
+        print_phase(names[i], n_restarts, elapsed);
+        if (run.failed > 0)
+            g_print("  %u failed\n", run.failed);
+
+        g_signal_handlers_disconnect_by_data(player, &run);
+        gst_object_unref(player);
+    }
+
+    player_warm_pool_get_stats(&stats);
+    g_print("  warm pool: %u warm, %" G_GUINT64_FORMAT " evicted, %" G_GUINT64_FORMAT " expired\n",
+            stats.n_warm, stats.n_evictions, stats.n_expired);
+
+    g_main_loop_unref(loop);
+}
+
+int
+main(int argc, char **argv) {
+    gboolean offline = FALSE;
+    gboolean fingerprint = FALSE;
+    gboolean http_cache = FALSE;
+    gboolean latency = FALSE;
+    gboolean mirrors = FALSE;
+    gint tag_store = 0;
+    gint startup = 0;
+    gint bulk_shutdown = 0;
+    gint bus = 0;
+    gint tick = 0;
+    gint dispatch = 0;
+    gint warm = 0;
+    gchar **inputs = NULL;
+    GPtrArray *uris;
+    guint i;
+    GError *err = NULL;
+    GOptionContext *ctx;
+    GOptionEntry options[] = {
+            {"offline",          0, 0, G_OPTION_ARG_NONE,           &offline,
+                                                                     "Measure offline decode throughput of the inputs", NULL},
+            {"fingerprint",      0, 0, G_OPTION_ARG_NONE,           &fingerprint,
+                                                                     "Fingerprint the inputs in offline mode and report duplicates", NULL},
+            {"http-cache",       0, 0, G_OPTION_ARG_NONE,           &http_cache,
+                                                                     "Read HTTP inputs through the block cache in offline mode", NULL},
+            {"latency",          0, 0, G_OPTION_ARG_NONE,           &latency,
+                                                                     "Report pipeline latency of the inputs in low-latency mode", NULL},
+            {"mirrors",          0, 0, G_OPTION_ARG_NONE,           &mirrors,
+                                                                     "Start the inputs as mirrors of one item and report per mirror time to first byte", NULL},
+            {"tag-store",        0, 0, G_OPTION_ARG_INT,            &tag_store,
+                                                                     "Preroll N players over the inputs and report tag sharing", "N"},
+            {"startup",          0, 0, G_OPTION_ARG_INT,            &startup,
+                                                                     "Create N players, give them the inputs and report the time per player", "N"},
+            {"shutdown",         0, 0, G_OPTION_ARG_INT,            &bulk_shutdown,
+                                                                     "Preroll N players over the inputs and compare sequential and bulk teardown", "N"},
+            {"bus",              0, 0, G_OPTION_ARG_INT,            &bus,
+                                                                     "Compare bus dispatch paths, then play the inputs for S seconds each and report the cost of bus message handling", "S"},
+            {"tick",             0, 0, G_OPTION_ARG_INT,            &tick,
+                                                                     "Time N position ticks with 0, 1 and 8 handlers", "N"},
+            {"dispatch",         0, 0, G_OPTION_ARG_INT,            &dispatch,
+                                                                     "Report delivery latency of N events for each signal dispatcher", "N"},
+            {"warm",             0, 0, G_OPTION_ARG_INT,            &warm,
+                                                                     "Restart the first input N times with a warm and a released pipeline", "N"},
+            {G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &inputs, NULL},
+            {NULL}
+    };
+
+    g_set_prgname("gstdemo-bench");
+
+    ctx = g_option_context_new("[FILE1|URI1] [FILE2|URI2] ...");
+    g_option_context_add_main_entries(ctx, options, NULL);
+    g_option_context_add_group(ctx, gst_init_get_option_group());
+    if (!g_option_context_parse(ctx, &argc, &argv, &err)) {
+        g_print("Error initializing: %s\n", GST_STR_NULL (err->message));
+        g_clear_error(&err);
+        g_option_context_free(ctx);
+        return 1;
+    }
+    g_option_context_free(ctx);
+
+    GST_DEBUG_CATEGORY_INIT (bench_debug, "bench", 0, "gstdemo-bench");
+
+    uris = g_ptr_array_new_with_free_func(g_free);
+    for (i = 0; inputs != NULL && inputs[i] != NULL; i++)
+        playlist_add(uris, inputs[i]);
+    g_strfreev(inputs);
+
+    if (offline) {
+        if (uris->len == 0) {
+            g_printerr("--offline needs at least one filename, directory or URI\n");
+            g_ptr_array_unref(uris);
+            return 1;
+        }
+        bench_offline(uris, fingerprint, http_cache);
+    }
+
+    if (latency) {
+        if (uris->len == 0) {
+            g_printerr("--latency needs at least one URI\n");
+            g_ptr_array_unref(uris);
+            return 1;
+        }
+        bench_latency(uris);
+    }
+
+    if (mirrors) {
+        if (uris->len == 0) {
+            g_printerr("--mirrors needs at least one URI\n");
+            g_ptr_array_unref(uris);
+            return 1;
+        }
+        bench_mirrors(uris, 5);
+    }
+
+    if (startup > 0)
+        bench_startup(uris, (guint) startup);
+
+    if (tick > 0)
+        bench_tick((guint) tick);
+
+    if (dispatch > 0)
+        bench_dispatch((guint) dispatch);
+
+    if (bus > 0) {
+        bench_bus_dispatch(100000);
+        if (uris->len > 0)
+            bench_bus(uris, (guint) bus);
+    }
+
+    if (warm > 0) {
+        if (uris->len == 0) {
+            g_printerr("--warm needs at least one filename, directory or URI\n");
+            g_ptr_array_unref(uris);
+            return 1;
+        }
+        bench_warm(uris, (guint) warm);
+    }
+
+    if (tag_store > 0) {
+        if (uris->len == 0) {
+            g_printerr("--tag-store needs at least one filename, directory or URI\n");
+            g_ptr_array_unref(uris);
+            return 1;
+        }
+        bench_tag_store(uris, (guint) tag_store);
+    }
+
+    if (bulk_shutdown > 0) {
+        if (uris->len == 0) {
+            g_printerr("--shutdown needs at least one filename, directory or URI\n");
+            g_ptr_array_unref(uris);
+            return 1;
+        }
+        bench_shutdown(uris, (guint) bulk_shutdown);
+    }
+
+    g_ptr_array_unref(uris);
+
+    gst_deinit();
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include "Player.h"
+#include "Playlist.h"
 
 #define VOLUME_STEPS 20
 
@@ -219,17 +220,17 @@ static MediaPlayback *playback_new(gchar **uris, gdouble initial_volume) {
     player_set_video_track_enabled(playback->player, FALSE);
     player_set_subtitle_track_enabled(playback->player, FALSE);
 
-    g_signal_connect (playback->player, "position-updated",
-                      G_CALLBACK(position_updated_cb), playback);
-    g_signal_connect (playback->player, "state-changed",
-                      G_CALLBACK(state_changed_cb), playback);
-    g_signal_connect (playback->player, "buffering", G_CALLBACK(buffering_cb), playback);
-    g_signal_connect (playback->player, "end-of-stream",
-                      G_CALLBACK(end_of_stream_cb), playback);
-    g_signal_connect (playback->player, "error", G_CALLBACK(error_cb), playback);
+    player_signal_connect(playback->player, "position-updated",
+                          G_CALLBACK(position_updated_cb), playback);
+    player_signal_connect(playback->player, "state-changed",
+                          G_CALLBACK(state_changed_cb), playback);
+    player_signal_connect(playback->player, "buffering", G_CALLBACK(buffering_cb), playback);
+    player_signal_connect(playback->player, "end-of-stream",
+                          G_CALLBACK(end_of_stream_cb), playback);
+    player_signal_connect(playback->player, "error", G_CALLBACK(error_cb), playback);
 
-    g_signal_connect (playback->player, "media-info-updated",
-                      G_CALLBACK(media_info_cb), playback);
+    player_signal_connect(playback->player, "media-info-updated",
+                          G_CALLBACK(media_info_cb), playback);
 
     playback->loop = g_main_loop_new(NULL, FALSE);
     playback->desired_state = GST_STATE_PLAYING;
@@ -335,38 +336,6 @@ do_play(MediaPlayback *playback) {
     g_main_loop_run(playback->loop);
 }
 
-static void add_to_playlist(GPtrArray *playlist, const gchar *filename) {
-    GDir *dir;
-    gchar *uri;
-
-    if (gst_uri_is_valid(filename)) {
-        g_ptr_array_add(playlist, g_strdup(filename));
-        return;
-    }
-
-    if ((dir = g_dir_open(filename, 0, NULL))) {
-        const gchar *entry;
-
-        /* FIXME: sort entries for each directory? */
-        while ((entry = g_dir_read_name(dir))) {
-            gchar *path;
-
-            path = g_strconcat(filename, G_DIR_SEPARATOR_S, entry, NULL);
-            add_to_playlist(playlist, path);
-            g_free(path);
-        }
-
-        g_dir_close(dir);
-        return;
-    }
-
-    uri = gst_filename_to_uri(filename, NULL);
-    if (uri != NULL)
-        g_ptr_array_add(playlist, uri);
-    else
-        g_warning ("Could not make URI out of filename '%s'", filename);
-}
-
 static void
 shuffle_uris(gchar **uris, guint num) {
     gchar *tmp;
@@ -530,22 +499,7 @@ main(int argc, char **argv) {
     playlist = g_ptr_array_new();
 
     if (playlist_file != NULL) {
-        gchar *playlist_contents = NULL;
-        gchar **lines = NULL;
-
-        if (g_file_get_contents(playlist_file, &playlist_contents, NULL, &err)) {
-            lines = g_strsplit(playlist_contents, "\n", 0);
-            num = g_strv_length(lines);
-
-            for (i = 0; i < num; i++) {
-                if (lines[i][0] != '\0') {
-                    GST_LOG ("Playlist[%d]: %s", i + 1, lines[i]);
-                    add_to_playlist(playlist, lines[i]);
-                }
-            }
-            g_strfreev(lines);
-            g_free(playlist_contents);
-        } else {
+        if (!playlist_add_from_file(playlist, playlist_file, &err)) {
             g_printerr("Could not read playlist: %s\n", err->message);
             g_clear_error(&err);
         }
@@ -570,7 +524,7 @@ main(int argc, char **argv) {
         num = g_strv_length(filenames);
         for (i = 0; i < num; ++i) {
             GST_LOG ("command line argument: %s", filenames[i]);
-            add_to_playlist(playlist, filenames[i]);
+            playlist_add(playlist, filenames[i]);
         }
         g_strfreev(filenames);
     }
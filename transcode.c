@@ -0,0 +1,194 @@
+#include <gst/gst.h>
+#include <string.h>
+
+#include "Player.h"
+#include "Playlist.h"
+#include "Transcoder.h"
+
+#define DEFAULT_CONTAINER "audio/ogg"
+#define DEFAULT_AUDIO "audio/x-vorbis"
+
+GST_DEBUG_CATEGORY (transcode_debug);
+#define GST_CAT_DEFAULT transcode_debug
+
+typedef struct {
+    Transcoder *transcoder;
+    GMainLoop *loop;
+    gint *last_percent;
+} TranscodeRun;
+
+static void job_progress_cb(Transcoder *transcoder, guint job, GstClockTime position,
+                            GstClockTime duration, TranscodeRun *run) {
+    gint percent;
+
+    if (!GST_CLOCK_TIME_IS_VALID (duration) || duration == 0)
+        return;
+
+    percent = (gint) (100 * MIN (position, duration) / duration);
+    if (percent == run->last_percent[job])
+        return;
+    run->last_percent[job] = percent;
+
+    g_print("[%u] %3d%% %s\n", job, percent, transcoder_get_destination(transcoder, job));
+}
+
+static void job_done_cb(Transcoder *transcoder, guint job, GError *err, TranscodeRun *run) {
+    if (err)
+        g_printerr("[%u] FAILED %s: %s\n", job,
+                   transcoder_get_source_uri(transcoder, job), err->message);
+    else
+        g_print("[%u] done %s\n", job, transcoder_get_destination(transcoder, job));
+}
+
+static void done_cb(Transcoder *transcoder, TranscodeRun *run) {
+    g_main_loop_quit(run->loop);
+}
+
+/* "audio/ogg" -> "ogg", "audio/x-flac" -> "flac" */
+static gchar *extension_from_caps(const gchar *caps) {
+    const gchar *name = strchr(caps, '/');
+    gchar *ext;
+
+    name = name ? name + 1 : caps;
+    if (g_str_has_prefix(name, "x-"))
+        name += 2;
+
+    ext = g_strdup(name);
+    ext[strcspn(ext, ",; ")] = '\0';
+
+    return ext;
+}
+
+int
+main(int argc, char **argv) {
+    TranscodeRun run = {NULL, NULL, NULL};
+    GstEncodingProfile *profile;
+    GPtrArray *playlist;
+    gchar **filenames = NULL;
+    gchar *playlist_file = NULL;
+    gchar *output_dir = NULL;
+    gchar *container = NULL;
+    gchar *audio = NULL;
+    gchar *extension = NULL;
+    gchar *summary_file = NULL;
+    gchar *summary;
+    gint jobs = 0;
+    guint i;
+    GError *err = NULL;
+    GOptionContext *ctx;
+    GOptionEntry options[] = {
+            {"jobs",             'j', 0, G_OPTION_ARG_INT,            &jobs,
+                                                                        "Number of concurrent pipelines (default: number of cores)", "N"},
+            {"output-dir",       'o', 0, G_OPTION_ARG_FILENAME,       &output_dir,
+                                                                        "Directory for the encoded files (default: current directory)", "DIR"},
+            {"container",        0,   0, G_OPTION_ARG_STRING,         &container,
+                                                                        "Container caps, empty for none (default: " DEFAULT_CONTAINER ")", "CAPS"},
+            {"audio",            0,   0, G_OPTION_ARG_STRING,         &audio,
+                                                                        "Audio encoding caps (default: " DEFAULT_AUDIO ")", "CAPS"},
+            {"extension",        0,   0, G_OPTION_ARG_STRING,         &extension,
+                                                                        "Extension of the encoded files", "EXT"},
+            {"playlist",         0,   0, G_OPTION_ARG_FILENAME,       &playlist_file,
+                                                                        "Playlist file containing input media files", NULL},
+            {"summary",          0,   0, G_OPTION_ARG_FILENAME,       &summary_file,
+                                                                        "Write the JSON throughput summary to FILE instead of stdout", "FILE"},
+            {G_OPTION_REMAINING, 0,   0, G_OPTION_ARG_FILENAME_ARRAY, &filenames, NULL},
+            {NULL}
+    };
+
+    g_set_prgname("gstdemo-transcode");
+
+    ctx = g_option_context_new("FILE1|URI1|DIR1 [FILE2|URI2|DIR2] ...");
+    g_option_context_add_main_entries(ctx, options, NULL);
+    g_option_context_add_group(ctx, gst_init_get_option_group());
+    if (!g_option_context_parse(ctx, &argc, &argv, &err)) {
+        g_print("Error initializing: %s\n", GST_STR_NULL (err->message));
+        g_clear_error(&err);
+        g_option_context_free(ctx);
+        return 1;
+    }
+    g_option_context_free(ctx);
+
+    GST_DEBUG_CATEGORY_INIT (transcode_debug, "transcode", 0, "gstdemo-transcode");
+
+    playlist = g_ptr_array_new_with_free_func(g_free);
+
+    if (playlist_file != NULL) {
+        if (!playlist_add_from_file(playlist, playlist_file, &err)) {
+            g_printerr("Could not read playlist: %s\n", err->message);
+            g_clear_error(&err);
+        }
+        g_free(playlist_file);
+    }
+
+    if (filenames != NULL) {
+        for (i = 0; filenames[i] != NULL; ++i)
+            playlist_add(playlist, filenames[i]);
+        g_strfreev(filenames);
+    }
+
+    if (playlist->len == 0) {
+        g_printerr("You must provide at least one filename, directory or URI to transcode.\n");
+        g_ptr_array_unref(playlist);
+        return 1;
+    }
+
+    if (!container)
+        container = g_strdup(DEFAULT_CONTAINER);
+    if (!audio)
+        audio = g_strdup(DEFAULT_AUDIO);
+    if (!extension)
+        extension = extension_from_caps(*container ? container : audio);
+
+    profile = transcoder_profile_new(container, audio, &err);
+    if (!profile) {
+        g_printerr("%s\n", err->message);
+        g_clear_error(&err);
+        g_ptr_array_unref(playlist);
+        return 1;
+    }
+
+    run.transcoder = transcoder_new(player_main_context_signal_dispatcher_new(NULL),
+                                    profile, output_dir ? output_dir : ".", extension,
+                                    jobs > 0 ? (guint) jobs : 0);
+    for (i = 0; i < playlist->len; i++)
+        transcoder_add_uri(run.transcoder, g_ptr_array_index (playlist, i));
+    g_ptr_array_unref(playlist);
+
+    run.loop = g_main_loop_new(NULL, FALSE);
+    run.last_percent = g_new (gint, transcoder_get_n_jobs(run.transcoder));
+    for (i = 0; i < transcoder_get_n_jobs(run.transcoder); i++)
+        run.last_percent[i] = -1;
+
+    g_signal_connect (run.transcoder, "job-progress", G_CALLBACK(job_progress_cb), &run);
+    g_signal_connect (run.transcoder, "job-done", G_CALLBACK(job_done_cb), &run);
+    g_signal_connect (run.transcoder, "done", G_CALLBACK(done_cb), &run);
+
+    g_print("Transcoding %u files with %u workers\n",
+            transcoder_get_n_jobs(run.transcoder), transcoder_get_n_workers(run.transcoder));
+
+    transcoder_start(run.transcoder);
+    g_main_loop_run(run.loop);
+
+    summary = transcoder_get_summary_json(run.transcoder);
+    if (summary_file) {
+        if (!g_file_set_contents(summary_file, summary, -1, &err)) {
+            g_printerr("Could not write summary: %s\n", err->message);
+            g_clear_error(&err);
+        }
+    } else {
+        g_print("%s", summary);
+    }
+    g_free(summary);
+
+    gst_object_unref(run.transcoder);
+    g_main_loop_unref(run.loop);
+    g_free(run.last_percent);
+    g_free(output_dir);
+    g_free(container);
+    g_free(audio);
+    g_free(extension);
+    g_free(summary_file);
+
+    gst_deinit();
+    return 0;
+}